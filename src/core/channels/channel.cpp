@@ -85,7 +85,7 @@ void renderMasterOut_(const Data& d, mcl::AudioBuffer& out)
 	d.buffer->audio.set(out, /*gain=*/1.0f);
 #ifdef WITH_VST
 	if (d.plugins.size() > 0)
-		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
+		pluginHost::processStack(d.buffer->audio, d.plugins, d.buffer->pluginAudio, nullptr);
 #endif
 	out.set(d.buffer->audio, d.volume);
 }
@@ -96,13 +96,14 @@ void renderMasterIn_(const Data& d, mcl::AudioBuffer& in)
 {
 #ifdef WITH_VST
 	if (d.plugins.size() > 0)
-		pluginHost::processStack(in, d.plugins, nullptr);
+		pluginHost::processStack(in, d.plugins, d.buffer->pluginAudio, nullptr);
 #endif
 }
 
 /* -------------------------------------------------------------------------- */
 
-void renderChannel_(const Data& d, mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool audible)
+void renderChannel_(const Data& d, mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool audible,
+    mcl::AudioBuffer* send)
 {
 	d.buffer->audio.clear();
 
@@ -119,11 +120,44 @@ void renderChannel_(const Data& d, mcl::AudioBuffer& out, mcl::AudioBuffer& in,
 	if (d.midiReceiver)
 		midiReceiver::render(d);
 	else if (d.plugins.size() > 0)
-		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
+		pluginHost::processStack(d.buffer->audio, d.plugins, d.buffer->pluginAudio, nullptr);
+
+	/* Delay compensation: line up with channels with a slower plug-in stack. 
+	Done even if not audible, to keep the delay line in sync. */
+
+	d.buffer->delay.process(d.buffer->audio, d.state->delay.load());
+#endif
+
+	if (!audible)
+		return;
+
+	const float volume = d.volume * d.volume_i;
+
+	out.sum(d.buffer->audio, volume, calcPanning_(d.pan));
+
+	if (send == nullptr)
+		return;
+	if (d.sendPre)
+		send->sum(d.buffer->audio, d.sendLevel);
+	else
+		send->sum(d.buffer->audio, volume * d.sendLevel, calcPanning_(d.pan));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* renderGroup_
+Group buses find their input already in the audio buffer, summed up by the
+channels routed to them. */
+
+void renderGroup_(const Data& d, mcl::AudioBuffer& out, bool audible)
+{
+#ifdef WITH_VST
+	if (d.plugins.size() > 0)
+		pluginHost::processStack(d.buffer->audio, d.plugins, d.buffer->pluginAudio, nullptr);
 #endif
 
 	if (audible)
-		out.sum(d.buffer->audio, d.volume * d.volume_i, calcPanning_(d.pan));
+		out.sum(d.buffer->audio, d.volume, calcPanning_(d.pan));
 }
 } // namespace
 
@@ -133,7 +167,15 @@ void renderChannel_(const Data& d, mcl::AudioBuffer& out, mcl::AudioBuffer& in,
 
 Buffer::Buffer(Frame bufferSize)
 : audio(bufferSize, G_MAX_IO_CHANS)
+#ifdef WITH_VST
+, pluginAudio(G_MAX_IO_CHANS, bufferSize)
+, delay(G_MAX_PLUGIN_LATENCY, G_MAX_IO_CHANS)
+, midiStream(G_DEFAULT_MIDI_STREAM_SIZE)
+#endif
 {
+#ifdef WITH_VST
+	midi.ensureSize(G_DEFAULT_VST_MIDIBUFFER_SIZE);
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
@@ -153,18 +195,24 @@ Data::Data(ChannelType type, ID id, ID columnId, State& state, Buffer& buffer)
 , key(0)
 , hasActions(false)
 , height(G_GUI_UNIT)
+, outputId(0)
+, sendId(0)
+, sendLevel(G_DEFAULT_VOL)
+, sendPre(false)
+, outputBus(nullptr)
+, sendBus(nullptr)
 {
 	switch (type)
 	{
 	case ChannelType::SAMPLE:
-		samplePlayer.emplace(&state.resampler.value());
+		samplePlayer.emplace(&state.resampler.value(), &state.waveCache);
 		sampleReactor.emplace(id);
 		audioReceiver.emplace();
 		sampleActionRecorder.emplace();
 		break;
 
 	case ChannelType::PREVIEW:
-		samplePlayer.emplace(&state.resampler.value());
+		samplePlayer.emplace(&state.resampler.value(), &state.waveCache);
 		sampleReactor.emplace(id);
 		break;
 
@@ -200,6 +248,12 @@ Data::Data(const patch::Channel& p, State& state, Buffer& buffer, float samplera
 , hasActions(p.hasActions)
 , name(p.name)
 , height(p.height)
+, outputId(p.outputId)
+, sendId(p.sendId)
+, sendLevel(p.sendLevel)
+, sendPre(p.sendPre)
+, outputBus(nullptr)
+, sendBus(nullptr)
 #ifdef WITH_VST
 , plugins(pluginManager::hydratePlugins(p.pluginIds))
 #endif
@@ -211,14 +265,14 @@ Data::Data(const patch::Channel& p, State& state, Buffer& buffer, float samplera
 	switch (type)
 	{
 	case ChannelType::SAMPLE:
-		samplePlayer.emplace(p, samplerateRatio, &state.resampler.value());
+		samplePlayer.emplace(p, samplerateRatio, &state.resampler.value(), &state.waveCache);
 		sampleReactor.emplace(id);
 		audioReceiver.emplace(p);
 		sampleActionRecorder.emplace();
 		break;
 
 	case ChannelType::PREVIEW:
-		samplePlayer.emplace(p, samplerateRatio, &state.resampler.value());
+		samplePlayer.emplace(p, samplerateRatio, &state.resampler.value(), &state.waveCache);
 		sampleReactor.emplace(id);
 		break;
 
@@ -342,13 +396,16 @@ void react(Data& d, const eventDispatcher::EventBuffer& events, bool audible)
 
 /* -------------------------------------------------------------------------- */
 
-void render(const Data& d, mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool audible)
+void render(const Data& d, mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool audible,
+    mcl::AudioBuffer* send)
 {
 	if (d.id == mixer::MASTER_OUT_CHANNEL_ID)
 		renderMasterOut_(d, *out);
 	else if (d.id == mixer::MASTER_IN_CHANNEL_ID)
 		renderMasterIn_(d, *in);
+	else if (d.type == ChannelType::GROUP)
+		renderGroup_(d, *out, audible);
 	else
-		renderChannel_(d, *out, *in, audible);
+		renderChannel_(d, *out, *in, audible, send);
 }
 } // namespace giada::m::channel
\ No newline at end of file
@@ -49,6 +49,8 @@
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #ifdef WITH_VST
 #include "core/channels/midiReceiver.h"
+#include "core/delayLine.h"
+#include "core/midiStream.h"
 #endif
 
 namespace giada::m
@@ -72,6 +74,19 @@ struct State
 	changes by the Swapper mechanism). Let's put it in the shared state here. */
 
 	std::optional<Resampler> resampler = {};
+
+	/* Playback state of the pre-rendered pitched Wave, if any. Same reason as
+	above. */
+
+	WaveReader::CacheState waveCache = {};
+
+#ifdef WITH_VST
+	/* delay
+	Plug-in delay compensation: how many frames this channel must be delayed by
+	to line up with the slowest plug-in stack. See pluginHost::updateLatency(). */
+
+	WeakAtomic<Frame> delay = 0;
+#endif
 };
 
 struct Buffer
@@ -80,8 +95,31 @@ struct Buffer
 
 	mcl::AudioBuffer audio;
 #ifdef WITH_VST
-	juce::MidiBuffer     midi;
-	Queue<MidiEvent, 32> midiQueue;
+	/* pluginAudio
+	Planar buffer handed to the plug-in stack, as JUCE doesn't deal with
+	interleaved audio. */
+
+	juce::AudioBuffer<float> pluginAudio;
+
+	/* midi
+	Events for the plug-in stack, rebuilt on each block. Preallocated to hold a
+	full midiStream: see G_DEFAULT_VST_MIDIBUFFER_SIZE. */
+
+	juce::MidiBuffer midi;
+
+	/* midiQueue, midiStream
+	Events for the plug-in stack coming from other threads, and all the events
+	for the current block. The latter coalesces CC messages when full. See 
+	G_DEFAULT_MIDI_QUEUE_SIZE and G_DEFAULT_MIDI_STREAM_SIZE. */
+
+	Queue<MidiEvent, G_DEFAULT_MIDI_QUEUE_SIZE> midiQueue;
+	MidiStream                                  midiStream;
+
+	/* delay
+	Delay line for plug-in delay compensation, preallocated for the max 
+	latency. */
+
+	DelayLine delay;
 #endif
 };
 
@@ -119,6 +157,19 @@ struct Data
 	bool        hasActions;
 	std::string name;
 	Pixel       height;
+	ID          outputId;  // Group bus to play into instead of master out, or 0
+	ID          sendId;    // Group bus for the aux send, or 0
+	float       sendLevel; // Aux send level
+	bool        sendPre;   // Aux send before (true) or after volume and pan
+
+	/* outputBus, sendBus
+	Input buffers of the group buses 'outputId' and 'sendId' refer to, or 
+	nullptr. Resolved by model::swap(), so that the audio thread doesn't have to
+	look buses up on each block. */
+
+	mcl::AudioBuffer* outputBus;
+	mcl::AudioBuffer* sendBus;
+
 #ifdef WITH_VST
 	std::vector<Plugin*> plugins;
 #endif
@@ -151,9 +202,13 @@ updates itself accordingly. */
 void react(Data& d, const eventDispatcher::EventBuffer& e, bool audible);
 
 /* render
-Renders audio data to I/O buffers. */
+Renders audio data to I/O buffers. 'out' is either the master out buffer or the
+input of the group bus the channel is routed to. The optional 'send' buffer is 
+the input of the group bus for the aux send. Group buses render their own input,
+filled by the channels above, to 'out'. */
 
-void render(const Data& d, mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool audible);
+void render(const Data& d, mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool audible,
+    mcl::AudioBuffer* send = nullptr);
 } // namespace giada::m::channel
 
 #endif
@@ -52,12 +52,19 @@ IdManager channelId_;
 
 /* -------------------------------------------------------------------------- */
 
-channel::State& makeState_(ChannelType type)
+/* makeState_
+Creates a new channel::State. Sample channels get a resampler with quality
+'rsmpQuality', or the default one from configuration if -1. */
+
+channel::State& makeState_(ChannelType type, int rsmpQuality = -1)
 {
 	std::unique_ptr<channel::State> state = std::make_unique<channel::State>();
 
+	if (rsmpQuality == -1)
+		rsmpQuality = conf::conf.rsmpQuality;
+
 	if (type == ChannelType::SAMPLE || type == ChannelType::PREVIEW)
-		state->resampler = Resampler(static_cast<Resampler::Quality>(conf::conf.rsmpQuality), G_MAX_IO_CHANS);
+		state->resampler = Resampler(static_cast<Resampler::Quality>(rsmpQuality), G_MAX_IO_CHANS);
 
 	model::add(std::move(state));
 	return model::back<channel::State>();
@@ -100,10 +107,21 @@ channel::Data create(const channel::Data& o)
 {
 	channel::Data out = channel::Data(o);
 
+	const int rsmpQuality = o.state->resampler ? static_cast<int>(o.state->resampler->getQuality()) : -1;
+
 	out.id     = channelId_.generate();
-	out.state  = &makeState_(o.type);
+	out.state  = &makeState_(o.type, rsmpQuality);
 	out.buffer = &makeBuffer_();
 
+	/* The WaveReader must point to the resampler and the cache state of the
+	new channel. The pre-rendered cache, if any, belongs to the original one. */
+
+	if (out.samplePlayer)
+	{
+		out.samplePlayer->waveReader      = WaveReader(&out.state->resampler.value(), &out.state->waveCache);
+		out.samplePlayer->waveReader.wave = o.samplePlayer->waveReader.wave;
+	}
+
 	return out;
 }
 
@@ -112,7 +130,7 @@ channel::Data create(const channel::Data& o)
 channel::Data deserializeChannel(const patch::Channel& pch, float samplerateRatio)
 {
 	channelId_.set(pch.id);
-	return channel::Data(pch, makeState_(pch.type), makeBuffer_(), samplerateRatio);
+	return channel::Data(pch, makeState_(pch.type, pch.resampleQuality), makeBuffer_(), samplerateRatio);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -154,6 +172,10 @@ const patch::Channel serializeChannel(const channel::Data& c)
 	pc.midiOutLplaying   = c.midiLighter.playing.getValue();
 	pc.midiOutLmute      = c.midiLighter.mute.getValue();
 	pc.midiOutLsolo      = c.midiLighter.solo.getValue();
+	pc.outputId          = c.outputId;
+	pc.sendId            = c.sendId;
+	pc.sendLevel         = c.sendLevel;
+	pc.sendPre           = c.sendPre;
 
 	if (c.type == ChannelType::SAMPLE)
 	{
@@ -162,6 +184,7 @@ const patch::Channel serializeChannel(const channel::Data& c)
 		pc.begin             = c.samplePlayer->begin;
 		pc.end               = c.samplePlayer->end;
 		pc.pitch             = c.samplePlayer->pitch;
+		pc.resampleQuality   = static_cast<int>(c.state->resampler->getQuality());
 		pc.shift             = c.samplePlayer->shift;
 		pc.midiInVeloAsVol   = c.samplePlayer->velocityAsVol;
 		pc.inputMonitor      = c.audioReceiver->inputMonitor;
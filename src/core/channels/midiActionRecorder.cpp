@@ -33,17 +33,27 @@
 #include "core/mixer.h"
 #include "core/recManager.h"
 #include "core/recorderHandler.h"
+#include <algorithm>
 #include <cassert>
 
 namespace giada::m::midiActionRecorder
 {
 namespace
 {
-void record_(channel::Data& ch, const MidiEvent& e)
+void record_(channel::Data& ch, const Action& a)
 {
+	/* Use the sequencer frame saved when the message arrived, if any: the 
+	current one depends on when the Event Dispatcher got to it. Messages from
+	other sources are recorded at the current frame. */
+
+	const MidiEvent& e            = a.event;
+	const Frame      framesInLoop = clock::getFramesInLoop();
+	const Frame      arrival      = a.frame >= 0 ? a.frame : clock::getCurrentFrame() + e.getDelta();
+	const Frame      frame        = arrival % std::max(framesInLoop, 1);
+
 	MidiEvent flat(e);
 	flat.setChannel(0);
-	recorderHandler::liveRec(ch.id, flat, clock::quantize(clock::getCurrentFrame()));
+	recorderHandler::liveRec(ch.id, flat, clock::quantize(frame));
 	ch.hasActions = true;
 }
 
@@ -64,6 +74,6 @@ bool canRecord_()
 void react(channel::Data& ch, const eventDispatcher::Event& e)
 {
 	if (e.type == eventDispatcher::EventType::MIDI && canRecord_())
-		record_(ch, std::get<Action>(e.data).event);
+		record_(ch, std::get<Action>(e.data));
 }
 } // namespace giada::m::midiActionRecorder
\ No newline at end of file
@@ -36,9 +36,13 @@ namespace giada::m::midiReceiver
 {
 namespace
 {
+/* sendToPlugins_
+Queues an event for the plug-in stack from a non-audio thread. */
+
 void sendToPlugins_(const channel::Data& ch, const MidiEvent& e, Frame localFrame)
 {
-	ch.buffer->midiQueue.push(MidiEvent(e.getRaw(), localFrame));
+	if (!ch.buffer->midiQueue.push(MidiEvent(e.getRaw(), localFrame)))
+		ch.buffer->midiStream.markDropped();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -51,7 +55,7 @@ void parseMidi_(const channel::Data& ch, const MidiEvent& e)
 
 	MidiEvent flat(e);
 	flat.setChannel(0);
-	sendToPlugins_(ch, flat, /*delta=*/0);
+	sendToPlugins_(ch, flat, e.getDelta());
 }
 } // namespace
 
@@ -85,26 +89,42 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 	if (e.type == sequencer::EventType::ACTIONS && ch.isPlaying())
 		for (const Action& action : *e.actions)
 			if (action.channelId == ch.id)
-				sendToPlugins_(ch, action.event, e.delta);
+				ch.buffer->midiStream.push(MidiEvent(action.event.getRaw(), e.delta));
 }
 
 /* -------------------------------------------------------------------------- */
 
 void render(const channel::Data& ch)
+{
+	fillBuffer(ch);
+	pluginHost::processStack(ch.buffer->audio, ch.plugins, ch.buffer->pluginAudio, &ch.buffer->midi);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void fillBuffer(const channel::Data& ch)
 {
 	ch.buffer->midi.clear();
 
-	MidiEvent e;
-	while (ch.buffer->midiQueue.pop(e))
+	/* Events from other threads join the ones already collected in this block
+	by advance(). */
+
+	MidiEvent queued;
+	while (ch.buffer->midiQueue.pop(queued))
+		ch.buffer->midiStream.push(queued);
+
+	/* Raw bytes go straight into the preallocated MIDI buffer: no temporary
+	juce::MidiMessage objects. */
+
+	for (const MidiEvent& e : ch.buffer->midiStream)
 	{
-		juce::MidiMessage message = juce::MidiMessage(
-		    e.getStatus(),
-		    e.getNote(),
-		    e.getVelocity());
-		ch.buffer->midi.addEvent(message, e.getDelta());
+		const juce::uint8 data[3] = {
+		    static_cast<juce::uint8>(e.getStatus()),
+		    static_cast<juce::uint8>(e.getNote()),
+		    static_cast<juce::uint8>(e.getVelocity())};
+		ch.buffer->midi.addEvent(data, 3, e.getDelta());
 	}
-
-	pluginHost::processStack(ch.buffer->audio, ch.plugins, &ch.buffer->midi);
+	ch.buffer->midiStream.clear();
 }
 } // namespace giada::m::midiReceiver
 
@@ -50,6 +50,12 @@ struct Data
 void react(const channel::Data& ch, const eventDispatcher::Event& e);
 void advance(const channel::Data& ch, const sequencer::Event& e);
 void render(const channel::Data& ch);
+
+/* fillBuffer
+Collects the events of the current block into the MIDI buffer of 'ch', ready 
+for the plug-in stack. First half of render(). */
+
+void fillBuffer(const channel::Data& ch);
 } // namespace giada::m::midiReceiver
 
 #endif // WITH_VST
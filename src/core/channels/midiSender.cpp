@@ -41,11 +41,19 @@ void send_(const channel::Data& ch, MidiEvent e)
 
 /* -------------------------------------------------------------------------- */
 
-void parseActions_(const channel::Data& ch, const std::vector<Action>& as)
+void send_RT_(const channel::Data& ch, MidiEvent e, Frame delta)
+{
+	e.setChannel(ch.midiSender->filter);
+	kernelMidi::send_RT(e.getRaw(), delta);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void parseActions_(const channel::Data& ch, const std::vector<Action>& as, Frame delta)
 {
 	for (const Action& a : as)
 		if (a.channelId == ch.id)
-			send_(ch, a.event);
+			send_RT_(ch, a.event, delta);
 }
 } // namespace
 
@@ -78,6 +86,6 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 	if (!ch.isPlaying() || !ch.midiSender->enabled || ch.isMuted())
 		return;
 	if (e.type == sequencer::EventType::ACTIONS)
-		parseActions_(ch, *e.actions);
+		parseActions_(ch, *e.actions, e.delta);
 }
 } // namespace giada::m::midiSender
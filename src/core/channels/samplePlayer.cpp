@@ -69,6 +69,8 @@ bool isPlaying_(const channel::Data& ch)
 
 void setWave_(samplePlayer::Data& sp, Wave* w, float samplerateRatio)
 {
+	sp.waveReader.cache = nullptr;
+
 	if (w == nullptr)
 	{
 		sp.waveReader.wave = nullptr;
@@ -90,24 +92,25 @@ void setWave_(samplePlayer::Data& sp, Wave* w, float samplerateRatio)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-Data::Data(Resampler* r)
+Data::Data(Resampler* r, WaveReader::CacheState* c)
 : pitch(G_DEFAULT_PITCH)
 , mode(SamplePlayerMode::SINGLE_BASIC)
 , velocityAsVol(false)
-, waveReader(r)
+, waveReader(r, c)
 {
 }
 
 /* -------------------------------------------------------------------------- */
 
-Data::Data(const patch::Channel& p, float samplerateRatio, Resampler* r)
+Data::Data(const patch::Channel& p, float samplerateRatio, Resampler* r,
+    WaveReader::CacheState* c)
 : pitch(p.pitch)
 , mode(p.mode)
 , shift(p.shift)
 , begin(p.begin)
 , end(p.end)
 , velocityAsVol(p.midiInVeloAsVol)
-, waveReader(r)
+, waveReader(r, c)
 {
 	setWave_(*this, waveManager::hydrateWave(p.waveId), samplerateRatio);
 }
@@ -218,7 +221,8 @@ void render(const channel::Data& ch)
 
 void loadWave(channel::Data& ch, Wave* w)
 {
-	ch.samplePlayer->waveReader.wave = w;
+	ch.samplePlayer->waveReader.wave  = w;
+	ch.samplePlayer->waveReader.cache = nullptr;
 
 	ch.state->tracker.store(0);
 	ch.samplePlayer->shift = 0;
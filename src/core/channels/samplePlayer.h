@@ -45,8 +45,9 @@ namespace giada::m::samplePlayer
 {
 struct Data
 {
-	Data(Resampler* r);
-	Data(const patch::Channel& p, float samplerateRatio, Resampler* r);
+	Data(Resampler* r, WaveReader::CacheState* c);
+	Data(const patch::Channel& p, float samplerateRatio, Resampler* r,
+	    WaveReader::CacheState* c);
 	Data(const Data& o) = default;
 	Data(Data&& o)      = default;
 	Data& operator=(const Data&) = default;
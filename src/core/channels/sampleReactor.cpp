@@ -39,7 +39,7 @@ namespace
 constexpr int Q_ACTION_PLAY   = 0;
 constexpr int Q_ACTION_REWIND = 1;
 
-void          press_(channel::Data& ch, int velocity);
+void          press_(channel::Data& ch, int velocity, Frame delta);
 void          release_(channel::Data& ch);
 void          kill_(channel::Data& ch);
 void          onStopBySeq_(channel::Data& ch);
@@ -50,7 +50,7 @@ void          rewind_(channel::Data& ch, Frame localFrame = 0);
 
 /* -------------------------------------------------------------------------- */
 
-void press_(channel::Data& ch, int velocity)
+void press_(channel::Data& ch, int velocity, Frame delta)
 {
 	ChannelStatus    playStatus = ch.state->playStatus.load();
 	SamplePlayerMode mode       = ch.samplePlayer->mode;
@@ -60,6 +60,8 @@ void press_(channel::Data& ch, int velocity)
 	{
 	case ChannelStatus::OFF:
 		playStatus = pressWhileOff_(ch, velocity, isLoop);
+		if (playStatus == ChannelStatus::PLAY)
+			ch.state->offset = delta;
 		break;
 
 	case ChannelStatus::PLAY:
@@ -234,7 +236,7 @@ void react(channel::Data& ch, const eventDispatcher::Event& e)
 	{
 
 	case eventDispatcher::EventType::KEY_PRESS:
-		press_(ch, std::get<int>(e.data));
+		press_(ch, std::get<int>(e.data), e.delta);
 		break;
 
 	case eventDispatcher::EventType::KEY_RELEASE:
@@ -32,13 +32,17 @@
 #include "utils/log.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <memory>
 
 namespace giada::m
 {
-WaveReader::WaveReader(Resampler* r)
+WaveReader::WaveReader(Resampler* r, CacheState* c)
 : wave(nullptr)
+, cache(nullptr)
+, cachePitch(G_DEFAULT_PITCH)
 , m_resampler(r)
+, m_cacheState(c)
 {
 }
 
@@ -54,8 +58,27 @@ WaveReader::Result WaveReader::fill(mcl::AudioBuffer& out, Frame start, Frame ma
 
 	if (pitch == 1.0f)
 		return fillCopy(out, start, max, offset);
-	else
-		return fillResampled(out, start, max, offset, pitch);
+
+	const bool cached = isCached(pitch);
+
+	if (m_cacheState != nullptr && m_cacheState->active != cached)
+	{
+		if (cache != nullptr)
+			return fillCrossfaded(out, start, max, offset, pitch, cached);
+
+		/* The cache has been taken away: nothing to fade from. */
+
+		m_cacheState->active = false;
+		last();
+	}
+	return cached ? fillCached(out, start, max, offset) : fillResampled(out, start, max, offset, pitch);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool WaveReader::isCached(float pitch) const
+{
+	return cache != nullptr && m_cacheState != nullptr && cachePitch == pitch;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -90,6 +113,83 @@ WaveReader::Result WaveReader::fillCopy(mcl::AudioBuffer& dest, Frame start,
 	return {used, used};
 }
 
+/* -------------------------------------------------------------------------- */
+
+WaveReader::Result WaveReader::fillCached(mcl::AudioBuffer& dest, Frame start,
+    Frame max, Frame offset) const
+{
+	CacheState&             state  = *m_cacheState;
+	const mcl::AudioBuffer& buffer = cache->getBuffer();
+
+	/* Frames of the cache don't map to integer frames of the original Wave.
+	Keep reading from where the previous call stopped as long as the tracker
+	moves on continuously, re-sync on jumps (rewind, begin point changes, ...)
+	or when a new cache comes in. */
+
+	if (start != state.tracker || cache != state.wave)
+	{
+		state.wave     = cache;
+		state.position = std::lround(start / static_cast<double>(cachePitch));
+	}
+
+	const Frame last      = std::min(static_cast<Frame>(max / static_cast<double>(cachePitch)), buffer.countFrames());
+	const Frame generated = std::clamp(last - state.position, 0, dest.countFrames() - offset);
+
+	if (generated > 0)
+		dest.set(buffer, generated, state.position, offset);
+
+	state.position += generated;
+	state.tracker = state.position >= last ? max : std::max(start, static_cast<Frame>(std::lround(state.position * static_cast<double>(cachePitch))));
+
+	return {state.tracker - start, generated};
+}
+
+/* -------------------------------------------------------------------------- */
+
+WaveReader::Result WaveReader::fillCrossfaded(mcl::AudioBuffer& dest, Frame start,
+    Frame max, Frame offset, float pitch, bool cached) const
+{
+	assert(dest.countChannels() <= G_MAX_IO_CHANS);
+
+	CacheState& state    = *m_cacheState;
+	const int   channels = dest.countChannels();
+
+	/* The resampler history is stale after a run of pre-rendered audio. Reset
+	it: the crossfade below hides the discontinuity. */
+
+	if (!cached)
+		last();
+
+	/* Render the outgoing path first and keep its head aside, then render the
+	incoming one on top of it. */
+
+	const Result prev = cached ? fillResampled(dest, start, max, offset, pitch) : fillCached(dest, start, max, offset);
+	const Frame  fade = std::min<Frame>(prev.generated, G_PITCH_CACHE_FADE);
+
+	std::copy(dest[offset], dest[offset] + fade * channels, state.fade.begin());
+
+	const Result res = cached ? fillCached(dest, start, max, offset) : fillResampled(dest, start, max, offset, pitch);
+	const Frame  len = std::min(fade, res.generated);
+
+	for (Frame i = 0; i < len; i++)
+	{
+		const float gain = (i + 1) / static_cast<float>(len + 1);
+		float*      out  = dest[offset + i];
+		for (int j = 0; j < channels; j++)
+			out[j] = state.fade[i * channels + j] * (1.0f - gain) + out[j] * gain;
+	}
+
+	/* Don't leave frames of the outgoing path past the end of the incoming
+	one, if it generated less. */
+
+	for (Frame i = res.generated; i < prev.generated; i++)
+		std::fill(dest[offset + i], dest[offset + i] + channels, 0.0f);
+
+	state.active = cached;
+
+	return res;
+}
+
 void WaveReader::last() const
 {
 	if (m_resampler != nullptr)
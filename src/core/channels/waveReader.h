@@ -27,7 +27,9 @@
 #ifndef G_CHANNEL_WAVE_READER_H
 #define G_CHANNEL_WAVE_READER_H
 
+#include "core/const.h"
 #include "core/types.h"
+#include <array>
 
 namespace mcl
 {
@@ -52,12 +54,31 @@ public:
 		Frame used, generated;
 	};
 
+	/* CacheState
+	Playback state of the pre-rendered Wave (see 'cache' below). Like the
+	Resampler, it is written by the audio thread and must survive model
+	changes, so it lives in the channel shared state. */
+
+	struct CacheState
+	{
+		bool        active   = false;   // True if the last fill() read from cache
+		const Wave* wave     = nullptr; // Cache the position below refers to
+		Frame       position = 0;       // Read position in cache
+		Frame       tracker  = -1;      // Input frame the position above refers to
+
+		/* fade
+		Scratch space for crossfading between live and pre-rendered audio. */
+
+		std::array<float, G_PITCH_CACHE_FADE * G_MAX_IO_CHANS> fade = {};
+	};
+
 	WaveReader() = delete;
-	WaveReader(Resampler* r);
+	WaveReader(Resampler* r, CacheState* c);
 
 	/* fill
 	Fills audio buffer 'out' with data coming from Wave, copying it from 'start'
-	frame up to 'max'. The buffer is filled starting at 'offset'. */
+	frame up to 'max'. The buffer is filled starting at 'offset'. Reads from
+	the pre-rendered cache instead of resampling, if one matches 'pitch'. */
 
 	Result fill(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
 	    float pitch) const;
@@ -73,12 +94,32 @@ public:
 
 	Wave* wave;
 
+	/* cache, cachePitch
+	Optional Wave pre-rendered at 'cachePitch', owned by the pitchCache module.
+	Played with a plain copy instead of live resampling when the pitch matches.
+	Frame 'n' of cache corresponds to frame 'n * cachePitch' of 'wave'. */
+
+	Wave* cache;
+	float cachePitch;
+
 private:
+	bool isCached(float pitch) const;
+
 	Result fillResampled(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
 	    float pitch) const;
 	Result fillCopy(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset) const;
+	Result fillCached(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset) const;
+
+	/* fillCrossfaded
+	Switches between live resampling and pre-rendered playback by fading from
+	the former to the latter (or vice versa) at the beginning of the block. The
+	cache, if outgoing, keeps playing at its own pitch while fading out. */
+
+	Result fillCrossfaded(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
+	    float pitch, bool cached) const;
 
-	Resampler* m_resampler;
+	Resampler*  m_resampler;
+	CacheState* m_cacheState;
 };
 } // namespace giada::m
 
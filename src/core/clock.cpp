@@ -79,6 +79,19 @@ void setBpm_(float current)
 
 	u::log::print("[clock::setBpm_] Bpm changed to %f\n", current);
 }
+
+/* -------------------------------------------------------------------------- */
+
+/* relocate_
+Moves the playhead to frame 'f'. Used when following an external MIDI master. */
+
+void relocate_(Frame f)
+{
+	const model::Clock& c = model::get().clock;
+
+	c.state->currentFrame.store(f);
+	c.state->currentBeat.store(f / c.framesInBeat);
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -95,6 +108,11 @@ void init()
 
 	model::swap(model::SwapType::NONE);
 
+	sync::onMidiStart     = []() { sequencer::rawStart(); };
+	sync::onMidiStop      = []() { sequencer::rawStop(); };
+	sync::onMidiChangeBpm = [](float bpm) { setBpm_(bpm); };
+	sync::onMidiRelocate  = [](Frame f) { relocate_(f); };
+
 #ifdef WITH_AUDIO_JACK
 
 	if (kernelAudio::getAPI() == G_SYS_API_JACK)
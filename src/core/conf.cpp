@@ -31,6 +31,7 @@
 #include "utils/fs.h"
 #include "utils/log.h"
 #include <FL/Fl.H>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <string>
@@ -53,6 +54,13 @@ void sanitize_()
 	conf.channelsOutStart = std::max(0, conf.channelsOutStart);
 	conf.channelsInCount  = std::max(1, conf.channelsInCount);
 	conf.channelsInStart  = std::max(0, conf.channelsInStart);
+
+	conf.rtPriorityAudio      = std::clamp(conf.rtPriorityAudio, 0, 99);
+	conf.rtPriorityMidi       = std::clamp(conf.rtPriorityMidi, 0, 99);
+	conf.rtPriorityDispatcher = std::clamp(conf.rtPriorityDispatcher, 0, 99);
+	conf.rtCpuAudio           = std::max(-1, conf.rtCpuAudio);
+	conf.rtCpuMidi            = std::max(-1, conf.rtCpuMidi);
+	conf.rtCpuDispatcher      = std::max(-1, conf.rtCpuDispatcher);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -130,6 +138,7 @@ bool read()
 	nl::json j = nl::json::parse(ifs);
 
 	conf.logMode                    = j.value(CONF_KEY_LOG_MODE, conf.logMode);
+	conf.logLevels                  = j.value(CONF_KEY_LOG_LEVELS, conf.logLevels);
 	conf.showTooltips               = j.value(CONF_KEY_SHOW_TOOLTIPS, conf.showTooltips);
 	conf.soundSystem                = j.value(CONF_KEY_SOUND_SYSTEM, conf.soundSystem);
 	conf.soundDeviceOut             = j.value(CONF_KEY_SOUND_DEVICE_OUT, conf.soundDeviceOut);
@@ -142,6 +151,14 @@ bool read()
 	conf.buffersize                 = j.value(CONF_KEY_BUFFER_SIZE, conf.buffersize);
 	conf.limitOutput                = j.value(CONF_KEY_LIMIT_OUTPUT, conf.limitOutput);
 	conf.rsmpQuality                = j.value(CONF_KEY_RESAMPLE_QUALITY, conf.rsmpQuality);
+	conf.pitchCache                 = j.value(CONF_KEY_PITCH_CACHE, conf.pitchCache);
+	conf.rtPriorityAudio            = j.value(CONF_KEY_RT_PRIORITY_AUDIO, conf.rtPriorityAudio);
+	conf.rtPriorityMidi             = j.value(CONF_KEY_RT_PRIORITY_MIDI, conf.rtPriorityMidi);
+	conf.rtPriorityDispatcher       = j.value(CONF_KEY_RT_PRIORITY_DISPATCHER, conf.rtPriorityDispatcher);
+	conf.rtCpuAudio                 = j.value(CONF_KEY_RT_CPU_AUDIO, conf.rtCpuAudio);
+	conf.rtCpuMidi                  = j.value(CONF_KEY_RT_CPU_MIDI, conf.rtCpuMidi);
+	conf.rtCpuDispatcher            = j.value(CONF_KEY_RT_CPU_DISPATCHER, conf.rtCpuDispatcher);
+	conf.rtMemoryLock               = j.value(CONF_KEY_RT_MEMORY_LOCK, conf.rtMemoryLock);
 	conf.midiSystem                 = j.value(CONF_KEY_MIDI_SYSTEM, conf.midiSystem);
 	conf.midiPortOut                = j.value(CONF_KEY_MIDI_PORT_OUT, conf.midiPortOut);
 	conf.midiPortIn                 = j.value(CONF_KEY_MIDI_PORT_IN, conf.midiPortIn);
@@ -203,11 +220,12 @@ bool read()
 	conf.midiInBeatDouble           = j.value(CONF_KEY_MIDI_IN_BEAT_DOUBLE, conf.midiInBeatDouble);
 	conf.midiInBeatHalf             = j.value(CONF_KEY_MIDI_IN_BEAT_HALF, conf.midiInBeatHalf);
 #ifdef WITH_VST
-	conf.pluginChooserX   = j.value(CONF_KEY_PLUGIN_CHOOSER_X, conf.pluginChooserX);
-	conf.pluginChooserY   = j.value(CONF_KEY_PLUGIN_CHOOSER_Y, conf.pluginChooserY);
-	conf.pluginChooserW   = j.value(CONF_KEY_PLUGIN_CHOOSER_W, conf.pluginChooserW);
-	conf.pluginChooserH   = j.value(CONF_KEY_PLUGIN_CHOOSER_H, conf.pluginChooserH);
-	conf.pluginSortMethod = j.value(CONF_KEY_PLUGIN_SORT_METHOD, conf.pluginSortMethod);
+	conf.pluginChooserX    = j.value(CONF_KEY_PLUGIN_CHOOSER_X, conf.pluginChooserX);
+	conf.pluginChooserY    = j.value(CONF_KEY_PLUGIN_CHOOSER_Y, conf.pluginChooserY);
+	conf.pluginChooserW    = j.value(CONF_KEY_PLUGIN_CHOOSER_W, conf.pluginChooserW);
+	conf.pluginChooserH    = j.value(CONF_KEY_PLUGIN_CHOOSER_H, conf.pluginChooserH);
+	conf.pluginSortMethod  = j.value(CONF_KEY_PLUGIN_SORT_METHOD, conf.pluginSortMethod);
+	conf.pluginAutoSuspend = j.value(CONF_KEY_PLUGIN_AUTO_SUSPEND, conf.pluginAutoSuspend);
 #endif
 
 	sanitize_();
@@ -226,6 +244,7 @@ bool write()
 
 	j[CONF_KEY_HEADER]                        = "GIADACFG";
 	j[CONF_KEY_LOG_MODE]                      = conf.logMode;
+	j[CONF_KEY_LOG_LEVELS]                    = conf.logLevels;
 	j[CONF_KEY_SHOW_TOOLTIPS]                 = conf.showTooltips;
 	j[CONF_KEY_SOUND_SYSTEM]                  = conf.soundSystem;
 	j[CONF_KEY_SOUND_DEVICE_OUT]              = conf.soundDeviceOut;
@@ -238,6 +257,14 @@ bool write()
 	j[CONF_KEY_BUFFER_SIZE]                   = conf.buffersize;
 	j[CONF_KEY_LIMIT_OUTPUT]                  = conf.limitOutput;
 	j[CONF_KEY_RESAMPLE_QUALITY]              = conf.rsmpQuality;
+	j[CONF_KEY_PITCH_CACHE]                   = conf.pitchCache;
+	j[CONF_KEY_RT_PRIORITY_AUDIO]             = conf.rtPriorityAudio;
+	j[CONF_KEY_RT_PRIORITY_MIDI]              = conf.rtPriorityMidi;
+	j[CONF_KEY_RT_PRIORITY_DISPATCHER]        = conf.rtPriorityDispatcher;
+	j[CONF_KEY_RT_CPU_AUDIO]                  = conf.rtCpuAudio;
+	j[CONF_KEY_RT_CPU_MIDI]                   = conf.rtCpuMidi;
+	j[CONF_KEY_RT_CPU_DISPATCHER]             = conf.rtCpuDispatcher;
+	j[CONF_KEY_RT_MEMORY_LOCK]                = conf.rtMemoryLock;
 	j[CONF_KEY_MIDI_SYSTEM]                   = conf.midiSystem;
 	j[CONF_KEY_MIDI_PORT_OUT]                 = conf.midiPortOut;
 	j[CONF_KEY_MIDI_PORT_IN]                  = conf.midiPortIn;
@@ -299,11 +326,12 @@ bool write()
 	j[CONF_KEY_REC_TRIGGER_LEVEL]             = conf.recTriggerLevel;
 	j[CONF_KEY_INPUT_REC_MODE]                = static_cast<int>(conf.inputRecMode);
 #ifdef WITH_VST
-	j[CONF_KEY_PLUGIN_CHOOSER_X]   = conf.pluginChooserX;
-	j[CONF_KEY_PLUGIN_CHOOSER_Y]   = conf.pluginChooserY;
-	j[CONF_KEY_PLUGIN_CHOOSER_W]   = conf.pluginChooserW;
-	j[CONF_KEY_PLUGIN_CHOOSER_H]   = conf.pluginChooserH;
-	j[CONF_KEY_PLUGIN_SORT_METHOD] = conf.pluginSortMethod;
+	j[CONF_KEY_PLUGIN_CHOOSER_X]    = conf.pluginChooserX;
+	j[CONF_KEY_PLUGIN_CHOOSER_Y]    = conf.pluginChooserY;
+	j[CONF_KEY_PLUGIN_CHOOSER_W]    = conf.pluginChooserW;
+	j[CONF_KEY_PLUGIN_CHOOSER_H]    = conf.pluginChooserH;
+	j[CONF_KEY_PLUGIN_SORT_METHOD]  = conf.pluginSortMethod;
+	j[CONF_KEY_PLUGIN_AUTO_SUSPEND] = conf.pluginAutoSuspend;
 #endif
 
 	std::ofstream ofs(confFilePath_);
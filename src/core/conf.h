@@ -30,6 +30,7 @@
 #include "core/const.h"
 #include "core/types.h"
 #include "utils/gui.h"
+#include <map>
 #include <string>
 
 namespace giada::m::conf
@@ -49,6 +50,21 @@ struct Conf
 	int  buffersize       = G_DEFAULT_BUFSIZE;
 	bool limitOutput      = false;
 	int  rsmpQuality      = 0;
+	bool pitchCache       = false;
+
+	int  rtPriorityAudio      = 0;  // SCHED_FIFO priority, 0 = leave as is
+	int  rtPriorityMidi       = 0;
+	int  rtPriorityDispatcher = 0;
+	int  rtCpuAudio           = -1; // CPU to pin the thread to, -1 = any
+	int  rtCpuMidi            = -1;
+	int  rtCpuDispatcher      = -1;
+	bool rtMemoryLock         = false;
+
+	/* logLevels
+	Max log level by subsystem (e.g. "KM": "debug"), see u::log::setLevel(). The
+	"default" entry applies to all other subsystems. */
+
+	std::map<std::string, std::string> logLevels;
 
 	int         midiSystem  = 0;
 	int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
@@ -123,11 +139,12 @@ struct Conf
 
 #ifdef WITH_VST
 
-	int pluginChooserX;
-	int pluginChooserY;
-	int pluginChooserW   = G_DEFAULT_SUBWINDOW_W;
-	int pluginChooserH   = G_DEFAULT_SUBWINDOW_H;
-	int pluginSortMethod = 0;
+	int  pluginChooserX;
+	int  pluginChooserY;
+	int  pluginChooserW    = G_DEFAULT_SUBWINDOW_W;
+	int  pluginChooserH    = G_DEFAULT_SUBWINDOW_H;
+	int  pluginSortMethod  = 0;
+	bool pluginAutoSuspend = false;
 
 #endif
 };
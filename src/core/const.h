@@ -81,6 +81,14 @@ than the audio thread sleep time. Note: this value will obviously increase the
 live input latency, keep it small! */
 constexpr int G_EVENT_DISPATCHER_RATE_MS = 5;
 
+/* G_PITCH_CACHE_SETTLE_MS, G_PITCH_CACHE_RATE_MS, G_PITCH_CACHE_FADE
+How long the pitch of a Sample Channel must stay still before its pre-rendered
+version is requested, the amount of sleep between each render cycle and the
+length in frames of the crossfade between live and pre-rendered playback. */
+constexpr int G_PITCH_CACHE_SETTLE_MS = 500;
+constexpr int G_PITCH_CACHE_RATE_MS   = 50;
+constexpr int G_PITCH_CACHE_FADE      = 256;
+
 /* -- GUI ------------------------------------------------------------------- */
 constexpr float G_GUI_REFRESH_RATE   = 1 / 30.0f; // 30 fps
 constexpr float G_GUI_PLUGIN_RATE    = 1 / 30.0f; // 30 fps
@@ -102,32 +110,35 @@ constexpr int   G_GUI_ZOOM_FACTOR    = 2;
 #define G_COLOR_BLACK fl_rgb_color(0, 0, 0)
 
 /* -- MIN/MAX values -------------------------------------------------------- */
-constexpr float G_MIN_BPM               = 20.0f;
-constexpr auto  G_MIN_BPM_STR           = "20.0";
-constexpr float G_MAX_BPM               = 999.0f;
-constexpr auto  G_MAX_BPM_STR           = "999.0";
-constexpr int   G_MAX_BEATS             = 32;
-constexpr int   G_MAX_BARS              = 32;
-constexpr int   G_MAX_QUANTIZE          = 8;
-constexpr float G_MIN_DB_SCALE          = 60.0f;
-constexpr int   G_MIN_COLUMN_WIDTH      = 140;
-constexpr float G_MAX_BOOST_DB          = 20.0f;
-constexpr float G_MIN_PITCH             = 0.1f;
-constexpr float G_MAX_PITCH             = 4.0f;
-constexpr float G_MAX_PAN               = 1.0f;
-constexpr float G_MAX_VOLUME            = 1.0f;
-constexpr int   G_MAX_GRID_VAL          = 64;
-constexpr int   G_MIN_BUF_SIZE          = 8;
-constexpr int   G_MAX_BUF_SIZE          = 4096;
-constexpr int   G_MIN_GUI_WIDTH         = 816;
-constexpr int   G_MIN_GUI_HEIGHT        = 510;
-constexpr int   G_MAX_IO_CHANS          = 2;
-constexpr int   G_MAX_VELOCITY          = 0x7F;
-constexpr int   G_MAX_MIDI_CHANS        = 16;
-constexpr int   G_MAX_POLYPHONY         = 32;
-constexpr int   G_MAX_DISPATCHER_EVENTS = 32;
-constexpr int   G_MAX_SEQUENCER_EVENTS  = 128; // Per block
-constexpr int   G_MAX_QUANTIZER_SIZE    = 32;
+constexpr float G_MIN_BPM                 = 20.0f;
+constexpr auto  G_MIN_BPM_STR             = "20.0";
+constexpr float G_MAX_BPM                 = 999.0f;
+constexpr auto  G_MAX_BPM_STR             = "999.0";
+constexpr int   G_MAX_BEATS               = 32;
+constexpr int   G_MAX_BARS                = 32;
+constexpr int   G_MAX_QUANTIZE            = 8;
+constexpr float G_MIN_DB_SCALE            = 60.0f;
+constexpr int   G_MIN_COLUMN_WIDTH        = 140;
+constexpr float G_MAX_BOOST_DB            = 20.0f;
+constexpr float G_MIN_PITCH               = 0.1f;
+constexpr float G_MAX_PITCH               = 4.0f;
+constexpr float G_MAX_PAN                 = 1.0f;
+constexpr float G_MAX_VOLUME              = 1.0f;
+constexpr int   G_MAX_GRID_VAL            = 64;
+constexpr int   G_MIN_BUF_SIZE            = 8;
+constexpr int   G_MAX_BUF_SIZE            = 4096;
+constexpr int   G_MIN_GUI_WIDTH           = 816;
+constexpr int   G_MIN_GUI_HEIGHT          = 510;
+constexpr int   G_MAX_IO_CHANS            = 2;
+constexpr int   G_MAX_VELOCITY            = 0x7F;
+constexpr int   G_MAX_MIDI_CHANS          = 16;
+constexpr int   G_MAX_POLYPHONY           = 32;
+constexpr int   G_MAX_DISPATCHER_EVENTS   = 256; // Power of two, see MpmcQueue
+constexpr int   G_MAX_SEQUENCER_EVENTS    = 128; // Per block
+constexpr int   G_MAX_QUANTIZER_SIZE      = 32;
+constexpr int   G_MAX_PLUGIN_PARAM_EVENTS = 128; // Per plug-in, per producer thread
+constexpr int   G_MAX_PLUGIN_LATENCY      = 16384; // Frames, max delay compensation
+constexpr int   G_CACHE_LINE_SIZE         = 64;    // Bytes, for padding shared atomics
 
 /* -- kernel audio ---------------------------------------------------------- */
 constexpr int G_SYS_API_NONE   = 0;
@@ -139,10 +150,41 @@ constexpr int G_SYS_API_CORE   = 5;
 constexpr int G_SYS_API_PULSE  = 6;
 constexpr int G_SYS_API_WASAPI = 7;
 
+/* -- plug-ins -------------------------------------------------------------- */
+constexpr auto  G_PLUGIN_SCAN_ARG        = "--scan-plugin"; // Runs Giada as scan helper
+constexpr int   G_PLUGIN_SCAN_TIMEOUT    = 30000;           // ms, per plug-in file
+constexpr int   G_PLUGIN_SUSPEND_HOLD_MS = 1000;            // Min silence before suspending
+constexpr float G_PLUGIN_SILENCE_LEVEL   = 0.00001f;        // -100 dB
+constexpr auto  G_PLUGIN_STATE_EXT       = ".gpst";         // Binary state files
+constexpr float G_PLUGIN_METER_SMOOTH    = 0.05f;           // Rolling average factor
+constexpr int   G_PLUGIN_METER_WINDOW_MS = 2000;            // Peak hold time
+constexpr int   G_PLUGIN_METER_LOG_MS    = 10000;           // Log stats every...
+
 /* -- kernel midi ----------------------------------------------------------- */
 constexpr int G_MIDI_API_JACK = 0x01; // 0000 0001
 constexpr int G_MIDI_API_ALSA = 0x02; // 0000 0010
 
+/* G_MIDI_OUT_RATE_MS, G_MAX_MIDI_OUT_EVENTS
+Polling rate of the MIDI output thread and size of the queue of outgoing
+messages filled by the audio thread. */
+
+constexpr int G_MIDI_OUT_RATE_MS    = 1;
+constexpr int G_MAX_MIDI_OUT_EVENTS = 256;
+
+/* G_MIDI_IN_MAX_DRIFT_US
+Max distance between the time of an incoming MIDI message computed from RtMidi
+deltas and the time it was actually received, before the former is discarded. */
+
+constexpr int G_MIDI_IN_MAX_DRIFT_US = 2000;
+
+/* G_MIDI_OUT_MAX_RATE, G_MIDI_OUT_MAX_BURST
+Bandwidth of the MIDI output port, in messages per second (a DIN cable carries
+about 1000 3-byte messages per second), and how many messages can be sent at
+once after some silence. Lighting messages only use what's left. */
+
+constexpr int G_MIDI_OUT_MAX_RATE  = 800;
+constexpr int G_MIDI_OUT_MAX_BURST = 32;
+
 /* -- default system -------------------------------------------------------- */
 #if defined(G_OS_LINUX)
 constexpr int G_DEFAULT_SOUNDSYS = G_SYS_API_NONE;
@@ -177,7 +219,9 @@ constexpr int   G_DEFAULT_ZOOM_RATIO          = 128;
 constexpr float G_DEFAULT_REC_TRIGGER_LEVEL   = -10.0f;
 constexpr int   G_DEFAULT_SUBWINDOW_W         = 640;
 constexpr int   G_DEFAULT_SUBWINDOW_H         = 480;
-constexpr int   G_DEFAULT_VST_MIDIBUFFER_SIZE = 1024; // TODO - not 100% sure about this size
+constexpr int   G_DEFAULT_MIDI_QUEUE_SIZE     = 256;  // Per channel, events from other threads
+constexpr int   G_DEFAULT_MIDI_STREAM_SIZE    = 512;  // Per channel, events in a single block
+constexpr int   G_DEFAULT_VST_MIDIBUFFER_SIZE = G_DEFAULT_MIDI_STREAM_SIZE * 9; // In bytes, 9 bytes per short message
 
 /* -- responses and return codes -------------------------------------------- */
 constexpr int G_RES_ERR_PROCESSING    = -6;
@@ -189,11 +233,26 @@ constexpr int G_RES_ERR_MEMORY        = -1;
 constexpr int G_RES_ERR               = 0;
 constexpr int G_RES_OK                = 1;
 
+/* -- real-time threads ---------------------------------------------------- */
+/* G_RT_STACK_PREFAULT
+Amount of stack (bytes) touched by real-time threads at startup, so that it's 
+already mapped (and locked, see conf::rtMemoryLock) when needed. */
+
+constexpr int G_RT_STACK_PREFAULT = 128 * 1024;
+
 /* -- log modes ------------------------------------------------------------- */
 constexpr int LOG_MODE_STDOUT = 0x01;
 constexpr int LOG_MODE_FILE   = 0x02;
 constexpr int LOG_MODE_MUTE   = 0x04;
 
+/* G_LOG_MESSAGE_SIZE, G_LOG_QUEUE_SIZE, G_LOG_RATE_MS
+Max length of a log message, number of messages waiting to be written (power 
+of two) and how often the writer thread wakes up. */
+
+constexpr int G_LOG_MESSAGE_SIZE = 256;
+constexpr int G_LOG_QUEUE_SIZE   = 1024;
+constexpr int G_LOG_RATE_MS      = 20;
+
 /* -- unique IDs of mainWin's subwindows ------------------------------------ */
 /* -- wid > 0 are reserved by gg_keyboard ----------------------------------- */
 constexpr int WID_BEATS         = -1;
@@ -210,6 +269,7 @@ constexpr int WID_SAMPLE_NAME   = -11;
 constexpr int WID_FX_CHOOSER    = -12;
 constexpr int WID_MIDI_INPUT    = -13;
 constexpr int WID_MIDI_OUTPUT   = -14;
+constexpr int WID_ROUTING       = -15;
 
 /* -- patch signals --------------------------------------------------------- */
 constexpr int G_PATCH_UNSUPPORTED = -2;
@@ -278,6 +338,23 @@ constexpr int MIDI_SYNC_CLOCK_S = 0x02; // slave
 constexpr int MIDI_SYNC_MTC_M   = 0x04; // master
 constexpr int MIDI_SYNC_MTC_S   = 0x08; // slave
 
+/* Slave mode. Tempo is tracked with a delay-locked loop of the given bandwidth
+(Hz), considered locked after a number of ticks within the max error (fraction 
+of the tick period). Tempo changes smaller than the tolerance are ignored, larger
+ones are applied once the new tempo has been stable for BPM_SETTLE. The playhead
+is moved when it drifts away from the master more than MAX_DRIFT. MTC stops when
+no quarter frames come in for MTC_TIMEOUT. */
+
+constexpr int    G_MIDI_CLOCK_PPQN          = 24;
+constexpr double G_MIDI_SYNC_BANDWIDTH      = 0.5;
+constexpr int    G_MIDI_SYNC_LOCK_TICKS     = 24;
+constexpr double G_MIDI_SYNC_LOCK_ERROR     = 0.25;
+constexpr double G_MIDI_SYNC_RESET_ERROR    = 0.5; // Start over if off by more
+constexpr float  G_MIDI_SYNC_BPM_TOLERANCE  = 0.1f;
+constexpr int    G_MIDI_SYNC_BPM_SETTLE_MS  = 250;
+constexpr int    G_MIDI_SYNC_MAX_DRIFT_MS   = 20;
+constexpr int    G_MIDI_SYNC_MTC_TIMEOUT_MS = 250;
+
 /* JSON patch keys */
 
 constexpr auto PATCH_KEY_HEADER                       = "header";
@@ -331,12 +408,17 @@ constexpr auto PATCH_KEY_CHANNEL_SHIFT                = "shift";
 constexpr auto PATCH_KEY_CHANNEL_HAS_ACTIONS          = "has_actions";
 constexpr auto PATCH_KEY_CHANNEL_READ_ACTIONS         = "read_actions";
 constexpr auto PATCH_KEY_CHANNEL_PITCH                = "pitch";
+constexpr auto PATCH_KEY_CHANNEL_RESAMPLE_QUALITY     = "resample_quality";
 constexpr auto PATCH_KEY_CHANNEL_INPUT_MONITOR        = "input_monitor";
 constexpr auto PATCH_KEY_CHANNEL_OVERDUB_PROTECTION   = "overdub_protection";
 constexpr auto PATCH_KEY_CHANNEL_MIDI_IN_READ_ACTIONS = "midi_in_read_actions";
 constexpr auto PATCH_KEY_CHANNEL_MIDI_IN_PITCH        = "midi_in_pitch";
 constexpr auto PATCH_KEY_CHANNEL_MIDI_OUT             = "midi_out";
 constexpr auto PATCH_KEY_CHANNEL_MIDI_OUT_CHAN        = "midi_out_chan";
+constexpr auto PATCH_KEY_CHANNEL_OUTPUT_ID            = "output_id";
+constexpr auto PATCH_KEY_CHANNEL_SEND_ID              = "send_id";
+constexpr auto PATCH_KEY_CHANNEL_SEND_LEVEL           = "send_level";
+constexpr auto PATCH_KEY_CHANNEL_SEND_PRE             = "send_pre";
 constexpr auto PATCH_KEY_CHANNEL_PLUGINS              = "plugins";
 constexpr auto PATCH_KEY_CHANNEL_PLUGIN_ID            = "plugin_id";
 constexpr auto PATCH_KEY_CHANNEL_ARMED                = "armed";
@@ -353,6 +435,7 @@ constexpr auto PATCH_KEY_PLUGIN_PATH                  = "path";
 constexpr auto PATCH_KEY_PLUGIN_BYPASS                = "bypass";
 constexpr auto PATCH_KEY_PLUGIN_PARAMS                = "params";
 constexpr auto PATCH_KEY_PLUGIN_STATE                 = "state";
+constexpr auto PATCH_KEY_PLUGIN_STATE_HASH            = "state_hash";
 constexpr auto PATCH_KEY_PLUGIN_MIDI_IN_PARAMS        = "midi_in_params";
 constexpr auto PATCH_KEY_COLUMN_ID                    = "id";
 constexpr auto PATCH_KEY_COLUMN_WIDTH                 = "width";
@@ -368,6 +451,7 @@ constexpr auto G_PATCH_KEY_ACTION_NEXT                = "next";
 
 constexpr auto CONF_KEY_HEADER                        = "header";
 constexpr auto CONF_KEY_LOG_MODE                      = "log_mode";
+constexpr auto CONF_KEY_LOG_LEVELS                    = "log_levels";
 constexpr auto CONF_KEY_SHOW_TOOLTIPS                 = "show_tooltips";
 constexpr auto CONF_KEY_SOUND_SYSTEM                  = "sound_system";
 constexpr auto CONF_KEY_SOUND_DEVICE_IN               = "sound_device_in";
@@ -381,6 +465,14 @@ constexpr auto CONF_KEY_BUFFER_SIZE                   = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION            = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT                  = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY              = "resample_quality";
+constexpr auto CONF_KEY_PITCH_CACHE                   = "pitch_cache";
+constexpr auto CONF_KEY_RT_PRIORITY_AUDIO             = "rt_priority_audio";
+constexpr auto CONF_KEY_RT_PRIORITY_MIDI              = "rt_priority_midi";
+constexpr auto CONF_KEY_RT_PRIORITY_DISPATCHER        = "rt_priority_dispatcher";
+constexpr auto CONF_KEY_RT_CPU_AUDIO                  = "rt_cpu_audio";
+constexpr auto CONF_KEY_RT_CPU_MIDI                   = "rt_cpu_midi";
+constexpr auto CONF_KEY_RT_CPU_DISPATCHER             = "rt_cpu_dispatcher";
+constexpr auto CONF_KEY_RT_MEMORY_LOCK                = "rt_memory_lock";
 constexpr auto CONF_KEY_MIDI_SYSTEM                   = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT                 = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN                  = "midi_port_in";
@@ -443,6 +535,7 @@ constexpr auto CONF_KEY_MIDI_INPUT_Y                  = "midi_input_y";
 constexpr auto CONF_KEY_MIDI_INPUT_W                  = "midi_input_w";
 constexpr auto CONF_KEY_MIDI_INPUT_H                  = "midi_input_h";
 constexpr auto CONF_KEY_PLUGIN_SORT_METHOD            = "plugin_sort_method";
+constexpr auto CONF_KEY_PLUGIN_AUTO_SUSPEND           = "plugin_auto_suspend";
 constexpr auto CONF_KEY_REC_TRIGGER_MODE              = "rec_trigger_mode";
 constexpr auto CONF_KEY_REC_TRIGGER_LEVEL             = "rec_trigger_level";
 constexpr auto CONF_KEY_INPUT_REC_MODE                = "input_rec_mode";
@@ -0,0 +1,107 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/delayLine.h"
+#include <algorithm>
+#include <cassert>
+
+namespace giada::m
+{
+DelayLine::DelayLine(Frame maxDelay, int channels)
+: m_buffer(maxDelay + 1, channels)
+, m_writePos(0)
+, m_delay(0)
+{
+	assert(maxDelay >= 0);
+	m_buffer.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void DelayLine::process(mcl::AudioBuffer& b, Frame delay)
+{
+	delay = std::clamp(delay, 0, getMaxDelay());
+
+	/* The write position stays where it is. A longer delay exposes frames
+	already played (or stale, if the line was bypassed): silence them. */
+
+	if (delay > m_delay)
+		silence(delay, delay - m_delay);
+	m_delay = delay;
+
+	if (m_delay == 0)
+		return;
+
+	const Frame size     = m_buffer.countFrames();
+	const int   channels = std::min(b.countChannels(), m_buffer.countChannels());
+
+	Frame readPos = (m_writePos - m_delay + size) % size;
+
+	for (Frame i = 0; i < b.countFrames(); i++)
+	{
+		float* frame = b[i];
+		float* write = m_buffer[m_writePos];
+		float* read  = m_buffer[readPos];
+
+		/* Read and write positions never overlap, as the delay is always 
+		greater than zero here. */
+
+		for (int j = 0; j < channels; j++)
+		{
+			write[j] = frame[j];
+			frame[j] = read[j];
+		}
+
+		m_writePos = (m_writePos + 1) % size;
+		readPos    = (readPos + 1) % size;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void DelayLine::clear()
+{
+	m_buffer.clear();
+	m_writePos = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void DelayLine::silence(Frame start, Frame length)
+{
+	const Frame size = m_buffer.countFrames();
+	for (Frame i = 0; i < length; i++)
+		std::fill_n(m_buffer[(m_writePos - start + i + size) % size], m_buffer.countChannels(), 0.0f);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame DelayLine::getMaxDelay() const
+{
+	return m_buffer.countFrames() - 1;
+}
+} // namespace giada::m
@@ -0,0 +1,74 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_DELAY_LINE_H
+#define G_DELAY_LINE_H
+
+#include "core/types.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+
+namespace giada::m
+{
+/* DelayLine
+Fixed-size ring buffer that delays interleaved audio by a variable amount of
+frames, up to the size given at construction time. Memory is allocated once, so
+process() is safe to call from the audio thread. */
+
+class DelayLine final
+{
+public:
+	DelayLine(Frame maxDelay, int channels);
+
+	/* process
+	Delays 'b' in place by 'delay' frames, clamped to the max delay. Changing the
+	delay only moves the read position: a shorter delay skips some frames, a 
+	longer one plays silence for the extra frames, so that old audio is not 
+	played back twice. A zero delay costs nothing. */
+
+	void process(mcl::AudioBuffer& b, Frame delay);
+
+	/* clear
+	Fills the line with silence. */
+
+	void clear();
+
+	Frame getMaxDelay() const;
+
+private:
+	/* silence
+	Zeroes 'length' frames of the line, starting 'start' frames before the write
+	position. */
+
+	void silence(Frame start, Frame length);
+
+	mcl::AudioBuffer m_buffer;
+	Frame            m_writePos;
+	Frame            m_delay;
+};
+} // namespace giada::m
+
+#endif
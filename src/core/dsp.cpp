@@ -0,0 +1,400 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/dsp.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace giada::m::dsp
+{
+namespace
+{
+#if defined(G_DSP_SSE2) || defined(G_DSP_NEON)
+constexpr std::size_t LANES = 4;
+#endif
+
+/* threadCount_
+Number of hardware threads, read once at static initialization time so that 
+parallelFor() never queries the system while processing. */
+
+const std::size_t threadCount_ = std::thread::hardware_concurrency();
+
+/* -------------------------------------------------------------------------- */
+
+float getPeak_(const float* data, std::size_t size)
+{
+	std::size_t i    = 0;
+	float       peak = 0.0f;
+#if defined(G_DSP_SSE2)
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128       vpeak    = _mm_setzero_ps();
+	for (; i + LANES <= size; i += LANES)
+		vpeak = _mm_max_ps(vpeak, _mm_and_ps(_mm_loadu_ps(data + i), signMask));
+	alignas(16) float lanes[LANES];
+	_mm_store_ps(lanes, vpeak);
+	peak = *std::max_element(lanes, lanes + LANES);
+#elif defined(G_DSP_NEON)
+	float32x4_t vpeak = vdupq_n_f32(0.0f);
+	for (; i + LANES <= size; i += LANES)
+		vpeak = vmaxq_f32(vpeak, vabsq_f32(vld1q_f32(data + i)));
+	float lanes[LANES];
+	vst1q_f32(lanes, vpeak);
+	peak = *std::max_element(lanes, lanes + LANES);
+#endif
+	for (; i < size; i++)
+		peak = std::max(peak, std::fabs(data[i]));
+	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyGain_(float* data, std::size_t size, float gain)
+{
+	std::size_t i = 0;
+#if defined(G_DSP_SSE2)
+	const __m128 vgain = _mm_set1_ps(gain);
+	for (; i + LANES <= size; i += LANES)
+		_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), vgain));
+#elif defined(G_DSP_NEON)
+	for (; i + LANES <= size; i += LANES)
+		vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), gain));
+#endif
+	for (; i < size; i++)
+		data[i] *= gain;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void clamp_(float* data, std::size_t size, float min, float max)
+{
+	std::size_t i = 0;
+#if defined(G_DSP_SSE2)
+	const __m128 vmin = _mm_set1_ps(min);
+	const __m128 vmax = _mm_set1_ps(max);
+	for (; i + LANES <= size; i += LANES)
+		_mm_storeu_ps(data + i, _mm_max_ps(vmin, _mm_min_ps(_mm_loadu_ps(data + i), vmax)));
+#elif defined(G_DSP_NEON)
+	const float32x4_t vmin = vdupq_n_f32(min);
+	const float32x4_t vmax = vdupq_n_f32(max);
+	for (; i + LANES <= size; i += LANES)
+		vst1q_f32(data + i, vmaxq_f32(vmin, vminq_f32(vld1q_f32(data + i), vmax)));
+#endif
+	for (; i < size; i++)
+		data[i] = std::max(min, std::min(data[i], max));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* applyRamp_
+Applies the ramp to frames in range [a, b). Gain is always computed from the
+absolute frame index rather than accumulated, so that SIMD, scalar and parallel
+paths yield the exact same values. */
+
+void applyRamp_(float* data, int channels, Frame a, Frame b, float start, float step)
+{
+	Frame i = a;
+#if defined(G_DSP_SSE2)
+	/* Mono and stereo buffers fit 4 and 2 frames per vector respectively. */
+
+	if (channels == 1)
+	{
+		const __m128 offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const __m128 vstart  = _mm_set1_ps(start);
+		const __m128 vstep   = _mm_set1_ps(step);
+		for (; i + 4 <= b; i += 4)
+		{
+			__m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), offsets);
+			__m128 gain  = _mm_add_ps(vstart, _mm_mul_ps(vstep, index));
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+		}
+	}
+	else if (channels == 2)
+	{
+		const __m128 offsets = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+		const __m128 vstart  = _mm_set1_ps(start);
+		const __m128 vstep   = _mm_set1_ps(step);
+		for (; i + 2 <= b; i += 2)
+		{
+			__m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), offsets);
+			__m128 gain  = _mm_add_ps(vstart, _mm_mul_ps(vstep, index));
+			_mm_storeu_ps(data + (i * 2), _mm_mul_ps(_mm_loadu_ps(data + (i * 2)), gain));
+		}
+	}
+#endif
+	for (; i < b; i++)
+	{
+		const float gain = start + (step * static_cast<float>(i));
+		for (int j = 0; j < channels; j++)
+			data[(i * channels) + j] *= gain;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* reverse_
+Swaps frames in range [a, b) with their mirrored counterparts in a buffer of
+'frames' frames. All frames in [a, b) must belong to the first half. */
+
+void reverse_(float* data, Frame frames, int channels, Frame a, Frame b)
+{
+	Frame i = a;
+#if defined(G_DSP_SSE2)
+	if (channels == 1)
+	{
+		for (; i + 4 <= b; i += 4)
+		{
+			float* front = data + i;
+			float* back  = data + frames - i - 4;
+			__m128 f     = _mm_loadu_ps(front);
+			__m128 k     = _mm_loadu_ps(back);
+			_mm_storeu_ps(front, _mm_shuffle_ps(k, k, _MM_SHUFFLE(0, 1, 2, 3)));
+			_mm_storeu_ps(back, _mm_shuffle_ps(f, f, _MM_SHUFFLE(0, 1, 2, 3)));
+		}
+	}
+	else if (channels == 2)
+	{
+		for (; i + 2 <= b; i += 2)
+		{
+			float* front = data + (i * 2);
+			float* back  = data + ((frames - i - 2) * 2);
+			__m128 f     = _mm_loadu_ps(front);
+			__m128 k     = _mm_loadu_ps(back);
+			_mm_storeu_ps(front, _mm_shuffle_ps(k, k, _MM_SHUFFLE(1, 0, 3, 2)));
+			_mm_storeu_ps(back, _mm_shuffle_ps(f, f, _MM_SHUFFLE(1, 0, 3, 2)));
+		}
+	}
+#endif
+	for (; i < b; i++)
+	{
+		float* front = data + (i * channels);
+		float* back  = data + ((frames - i - 1) * channels);
+		std::swap_ranges(front, front + channels, back);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void spread_(const float* src, float* dest, Frame frames, int channels)
+{
+	Frame i = 0;
+#if defined(G_DSP_SSE2)
+	if (channels == 2)
+	{
+		for (; i + 4 <= frames; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(src + i);
+			_mm_storeu_ps(dest + (i * 2), _mm_unpacklo_ps(v, v));
+			_mm_storeu_ps(dest + (i * 2) + 4, _mm_unpackhi_ps(v, v));
+		}
+	}
+#endif
+	for (; i < frames; i++)
+		for (int j = 0; j < channels; j++)
+			dest[(i * channels) + j] = src[i];
+}
+
+/* -------------------------------------------------------------------------- */
+
+void deinterleave_(const float* src, float* const* dest, Frame a, Frame b, int channels)
+{
+	Frame i = a;
+#if defined(G_DSP_SSE2)
+	if (channels == 2)
+	{
+		for (; i + 4 <= b; i += 4)
+		{
+			__m128 lo = _mm_loadu_ps(src + (i * 2));
+			__m128 hi = _mm_loadu_ps(src + (i * 2) + 4);
+			_mm_storeu_ps(dest[0] + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(dest[1] + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+	}
+#elif defined(G_DSP_NEON)
+	if (channels == 2)
+	{
+		for (; i + 4 <= b; i += 4)
+		{
+			float32x4x2_t v = vld2q_f32(src + (i * 2));
+			vst1q_f32(dest[0] + i, v.val[0]);
+			vst1q_f32(dest[1] + i, v.val[1]);
+		}
+	}
+#endif
+	for (; i < b; i++)
+		for (int j = 0; j < channels; j++)
+			dest[j][i] = src[(i * channels) + j];
+}
+
+/* -------------------------------------------------------------------------- */
+
+void interleave_(const float* const* src, float* dest, Frame a, Frame b, int channels)
+{
+	Frame i = a;
+#if defined(G_DSP_SSE2)
+	if (channels == 2)
+	{
+		for (; i + 4 <= b; i += 4)
+		{
+			__m128 l = _mm_loadu_ps(src[0] + i);
+			__m128 r = _mm_loadu_ps(src[1] + i);
+			_mm_storeu_ps(dest + (i * 2), _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(dest + (i * 2) + 4, _mm_unpackhi_ps(l, r));
+		}
+	}
+#elif defined(G_DSP_NEON)
+	if (channels == 2)
+	{
+		for (; i + 4 <= b; i += 4)
+		{
+			float32x4x2_t v = {{vld1q_f32(src[0] + i), vld1q_f32(src[1] + i)}};
+			vst2q_f32(dest + (i * 2), v);
+		}
+	}
+#endif
+	for (; i < b; i++)
+		for (int j = 0; j < channels; j++)
+			dest[(i * channels) + j] = src[j][i];
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+std::size_t getThreadCount()
+{
+	return threadCount_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+float getPeak(const float* data, std::size_t size)
+{
+	std::mutex mutex;
+	float      peak = 0.0f;
+
+	parallelFor(size, 1, [data, &mutex, &peak](std::size_t a, std::size_t b) {
+		const float p = getPeak_(data + a, b - a);
+		std::scoped_lock lock(mutex);
+		peak = std::max(peak, p);
+	});
+
+	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyGain(float* data, std::size_t size, float gain)
+{
+	parallelFor(size, 1, [data, gain](std::size_t a, std::size_t b) {
+		applyGain_(data + a, b - a, gain);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void clamp(float* data, std::size_t size, float min, float max)
+{
+	parallelFor(size, 1, [data, min, max](std::size_t a, std::size_t b) {
+		clamp_(data + a, b - a, min, max);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void fill(float* data, std::size_t size, float value)
+{
+	parallelFor(size, 1, [data, value](std::size_t a, std::size_t b) {
+		std::fill(data + a, data + b, value);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void copy(const float* src, float* dest, std::size_t size)
+{
+	parallelFor(size, 1, [src, dest](std::size_t a, std::size_t b) {
+		std::memcpy(dest + a, src + a, (b - a) * sizeof(float));
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyRamp(float* data, Frame frames, int channels, float start, float step)
+{
+	const std::size_t size = static_cast<std::size_t>(frames) * channels;
+
+	parallelFor(size, channels, [=](std::size_t a, std::size_t b) {
+		applyRamp_(data, channels, a / channels, b / channels, start, step);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void reverse(float* data, Frame frames, int channels)
+{
+	/* Only the first half of the buffer is split into chunks: each frame is
+	swapped with its mirrored one in the second half. */
+
+	const std::size_t size = static_cast<std::size_t>(frames / 2) * channels;
+
+	parallelFor(size, channels, [=](std::size_t a, std::size_t b) {
+		reverse_(data, frames, channels, a / channels, b / channels);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void spread(const float* src, float* dest, Frame frames, int channels)
+{
+	parallelFor(frames, 1, [=](std::size_t a, std::size_t b) {
+		spread_(src + a, dest + (a * channels), static_cast<Frame>(b - a), channels);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void deinterleave(const float* src, float* const* dest, Frame frames, int channels)
+{
+	parallelFor(frames, 1, [=](std::size_t a, std::size_t b) {
+		deinterleave_(src, dest, static_cast<Frame>(a), static_cast<Frame>(b), channels);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void interleave(const float* const* src, float* dest, Frame frames, int channels)
+{
+	parallelFor(frames, 1, [=](std::size_t a, std::size_t b) {
+		interleave_(src, dest, static_cast<Frame>(a), static_cast<Frame>(b), channels);
+	});
+}
+} // namespace giada::m::dsp
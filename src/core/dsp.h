@@ -0,0 +1,152 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_DSP_H
+#define G_DSP_H
+
+#include "core/types.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define G_DSP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define G_DSP_NEON
+#include <arm_neon.h>
+#endif
+
+/* dsp
+Low-level kernels that operate on raw interleaved float buffers. Each kernel
+has a SIMD path (SSE2 on x86, NEON on ARM) with a scalar fallback for the
+remaining samples. Kernels working on large ranges (i.e. sample editing) are
+also split across multiple threads: this never happens for audio-thread sized
+buffers, so the same kernels are safe to use in the mixer. G_DSP_SSE2 and
+G_DSP_NEON macros tell which instruction set is available, if any. */
+
+namespace giada::m::dsp
+{
+/* PARALLEL_THRESHOLD
+Minimum number of samples a range must contain before its processing is split
+across multiple threads. */
+
+constexpr std::size_t PARALLEL_THRESHOLD = 1 << 18;
+
+/* getThreadCount
+Returns the number of hardware threads, read once at startup. */
+
+std::size_t getThreadCount();
+
+/* parallelFor
+Splits the range [0, size) into contiguous chunks and calls 'f(begin, end)'
+for each of them, one chunk per hardware thread. Runs 'f' on the calling thread
+only if 'size' < PARALLEL_THRESHOLD: in that case no thread is spawned and 
+nothing is allocated, so it's safe on the audio thread. Returns when all chunks
+are done. 'align' makes chunk boundaries a multiple of it (e.g. the number of 
+channels). */
+
+template <typename F>
+void parallelFor(std::size_t size, std::size_t align, const F& f)
+{
+	assert(align > 0);
+
+	if (size < PARALLEL_THRESHOLD || getThreadCount() <= 1)
+	{
+		f(0, size);
+		return;
+	}
+
+	const std::size_t threads = getThreadCount();
+
+	std::size_t chunk = (size + threads - 1) / threads;
+	chunk             = ((chunk + align - 1) / align) * align;
+
+	/* The calling thread takes care of the first chunk, while the remaining
+	ones are spread across worker threads. */
+
+	std::vector<std::thread> workers;
+	for (std::size_t begin = chunk; begin < size; begin += chunk)
+		workers.emplace_back([&f, begin, end = std::min(begin + chunk, size)]() { f(begin, end); });
+
+	f(0, std::min(chunk, size));
+
+	for (std::thread& t : workers)
+		t.join();
+}
+
+/* getPeak
+Returns the highest absolute value in 'data'. */
+
+float getPeak(const float* data, std::size_t size);
+
+/* applyGain
+Multiplies each sample by 'gain'. */
+
+void applyGain(float* data, std::size_t size, float gain);
+
+/* clamp
+Hard-limits each sample in range [min, max]. */
+
+void clamp(float* data, std::size_t size, float min, float max);
+
+/* fill
+Sets each sample to 'value'. */
+
+void fill(float* data, std::size_t size, float value);
+
+/* copy
+Copies 'size' samples from 'src' to non-overlapping 'dest'. */
+
+void copy(const float* src, float* dest, std::size_t size);
+
+/* applyRamp
+Multiplies each frame 'i' by gain 'start + (step * i)', all channels
+included. */
+
+void applyRamp(float* data, Frame frames, int channels, float start, float step);
+
+/* reverse
+Flips the frame order in place. Channels within a frame keep their order. */
+
+void reverse(float* data, Frame frames, int channels);
+
+/* spread
+Copies a 1-channel buffer 'src' to each channel of the interleaved 'dest'
+buffer. */
+
+void spread(const float* src, float* dest, Frame frames, int channels);
+
+/* deinterleave, interleave
+Convert between the interleaved 'frames' x 'channels' buffer and an array of
+'channels' planar buffers, e.g. the one used by plug-ins. */
+
+void deinterleave(const float* src, float* const* dest, Frame frames, int channels);
+void interleave(const float* const* src, float* dest, Frame frames, int channels);
+} // namespace giada::m::dsp
+
+#endif
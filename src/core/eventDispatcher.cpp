@@ -29,7 +29,12 @@
 #include "core/const.h"
 #include "core/midiDispatcher.h"
 #include "core/model/model.h"
+#include "core/realtime.h"
+#ifdef WITH_VST
+#include "core/plugins/pluginHost.h"
+#endif
 #include "core/sequencer.h"
+#include "core/sync.h"
 #include "core/worker.h"
 #include "utils/log.h"
 #include <functional>
@@ -59,7 +64,7 @@ void processFuntions_()
 			break;
 
 		case EventType::MIDI_DISPATCHER_PROCESS:
-			midiDispatcher::process(std::get<Action>(e.data).event);
+			midiDispatcher::process(std::get<Action>(e.data).event, std::get<Action>(e.data).frame);
 			break;
 
 		case EventType::MIXER_SIGNAL_CALLBACK:
@@ -96,18 +101,23 @@ void processSequencer_()
 
 void process_()
 {
-	eventBuffer_.clear();
+	sync::update();
+#ifdef WITH_VST
+	pluginHost::updateLatency();
+	pluginHost::logStats();
+#endif
+
+	if (const std::size_t dropped = Events.takeDropped(); dropped > 0)
+		u::log::print("[eventDispatcher] queue full, %zu events dropped\n", dropped);
 
-	Event e;
-	while (UIevents.pop(e))
-		eventBuffer_.push_back(e);
-	while (MidiEvents.pop(e))
-		eventBuffer_.push_back(e);
+	eventBuffer_.clear();
+	Events.popAll([](const Event& e) { eventBuffer_.push_back(e); });
 
 	if (eventBuffer_.size() == 0)
 		return;
 
 	processFuntions_();
+	sync::react(eventBuffer_);
 	processChannels_();
 	processSequencer_();
 }
@@ -117,18 +127,17 @@ void process_()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-Queue<Event, G_MAX_DISPATCHER_EVENTS> UIevents;
-Queue<Event, G_MAX_DISPATCHER_EVENTS> MidiEvents;
+MpmcQueue<Event, G_MAX_DISPATCHER_EVENTS> Events;
 
 /* -------------------------------------------------------------------------- */
 
 void init()
 {
-	worker_.start(process_, /*sleep=*/G_EVENT_DISPATCHER_RATE_MS);
+	worker_.start(process_, /*sleep=*/G_EVENT_DISPATCHER_RATE_MS,
+	    []() { realtime::setupThread(realtime::ThreadRole::DISPATCHER); });
 }
 
 /* -------------------------------------------------------------------------- */
 
-void pumpUIevent(Event e) { UIevents.push(e); }
-void pumpMidiEvent(Event e) { MidiEvents.push(e); }
+bool pumpEvent(Event e) { return Events.push(e); }
 } // namespace giada::m::eventDispatcher
\ No newline at end of file
@@ -29,7 +29,7 @@
 
 #include "core/action.h"
 #include "core/const.h"
-#include "core/queue.h"
+#include "core/mpmcQueue.h"
 #include "core/ringBuffer.h"
 #include "core/types.h"
 #include <atomic>
@@ -38,8 +38,8 @@
 #include <variant>
 
 /* giada::m::eventDispatcher
-Takes events from the two queues (MIDI and UI) filled by c::events and turns 
-them into actual changes in the data model. The EventDispatcher runs in a
+Takes events from the queue filled by c::events and turns them into actual 
+changes in the data model. The EventDispatcher runs in a
 separate worker thread. */
 
 namespace giada::m::eventDispatcher
@@ -52,6 +52,10 @@ enum class EventType
 	SEQUENCER_START,
 	SEQUENCER_STOP,
 	SEQUENCER_REWIND,
+	MIDI_SYNC_START,
+	MIDI_SYNC_STOP,
+	MIDI_SYNC_BPM,
+	MIDI_SYNC_RELOCATE,
 	MIDI,
 	MIDI_DISPATCHER_LEARN,
 	MIDI_DISPATCHER_PROCESS,
@@ -78,24 +82,23 @@ struct Event
 };
 
 /* EventBuffer
-Alias for a RingBuffer containing events to be sent to engine. The double size
-is due to the presence of two distinct Queues for collecting events coming from
-other threads. See below. */
+Alias for a RingBuffer containing events to be sent to engine. As big as the
+event queue, so that a whole queue fits in it. See below. */
 
-using EventBuffer = RingBuffer<Event, G_MAX_DISPATCHER_EVENTS * 2>;
+using EventBuffer = RingBuffer<Event, G_MAX_DISPATCHER_EVENTS>;
 
-/* Event queues
-Collect events coming from the UI or MIDI devices. Our poor man's Queue is a 
-single-producer/single-consumer one, so we need two queues for two writers. 
-TODO - let's add a multi-producer queue sooner or later! */
+/* Events
+Collects events coming from any thread (UI, MIDI devices, ...). */
 
-extern Queue<Event, G_MAX_DISPATCHER_EVENTS> UIevents;
-extern Queue<Event, G_MAX_DISPATCHER_EVENTS> MidiEvents;
+extern MpmcQueue<Event, G_MAX_DISPATCHER_EVENTS> Events;
 
 void init();
 
-void pumpUIevent(Event e);
-void pumpMidiEvent(Event e);
+/* pumpEvent
+Pushes a new event to the queue. Returns false if the queue is full: the event
+is dropped and accounted for in the log. */
+
+bool pumpEvent(Event e);
 } // namespace giada::m::eventDispatcher
 
 #endif
@@ -46,7 +46,10 @@
 #include "core/model/model.h"
 #include "core/model/storage.h"
 #include "core/patch.h"
+#include "core/pitchCache.h"
+#include "core/realtime.h"
 #include "core/plugins/pluginHost.h"
+#include "core/plugins/pluginLoader.h"
 #include "core/plugins/pluginManager.h"
 #include "core/recManager.h"
 #include "core/recorder.h"
@@ -85,6 +88,10 @@ void initConf_()
 
 	model::load(conf::conf);
 
+	for (const auto& [subsystem, level] : conf::conf.logLevels)
+		if (!u::log::setLevel(subsystem == "default" ? "" : subsystem, level))
+			u::log::print(u::log::Level::WARN, "[init] unknown log level '%s' for '%s'\n", level, subsystem);
+
 	if (!u::log::init(conf::conf.logMode))
 		u::log::print("[init] log init failed! Using default stdout\n");
 
@@ -96,8 +103,10 @@ void initConf_()
 
 void initSystem_()
 {
+	realtime::init(conf::conf);
 	model::init();
 	eventDispatcher::init();
+	pitchCache::init();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -115,7 +124,7 @@ void initAudio_()
 #ifdef WITH_VST
 
 	pluginManager::init(conf::conf.samplerate, kernelAudio::getRealBufSize());
-	pluginHost::init(kernelAudio::getRealBufSize());
+	pluginHost::init();
 
 #endif
 
@@ -178,6 +187,7 @@ void shutdownAudio_()
 
 #ifdef WITH_VST
 
+	pluginLoader::close();
 	pluginHost::close();
 	u::log::print("[init] PluginHost cleaned up\n");
 
@@ -255,6 +265,7 @@ void reset()
 
 	mh::close();
 #ifdef WITH_VST
+	pluginLoader::reset();
 	pluginHost::close();
 #endif
 
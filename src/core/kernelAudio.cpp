@@ -30,9 +30,12 @@
 #include "conf.h"
 #include "const.h"
 #include "core/clock.h"
+#include "core/kernelMidi.h"
 #include "core/mixerHandler.h"
 #include "core/model/model.h"
+#include "core/realtime.h"
 #include "core/recManager.h"
+#include "core/rtCheck.h"
 #include "core/sync.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "deps/rtaudio/RtAudio.h"
@@ -55,6 +58,11 @@ unsigned                 realBufsize_    = 0; // Real buffer size from the sound
 int                      realSampleRate_ = 0; // Sample rate might differ if JACK in use
 int                      api_            = 0;
 
+/* threadReady_
+Whether the audio thread has been set up. See realtime::setupThread(). */
+
+thread_local bool threadReady_ = false;
+
 /* -------------------------------------------------------------------------- */
 
 Device fetchDevice_(size_t deviceIndex)
@@ -126,6 +134,17 @@ bool canRender_()
 int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double /*streamTime*/,
     RtAudioStreamStatus /*status*/, void* /*userData*/)
 {
+	if (!threadReady_)
+	{
+		realtime::setupThread(realtime::ThreadRole::AUDIO);
+		threadReady_ = true;
+	}
+
+	/* Everything from here on must be real-time safe. Checked only when built
+	with WITH_RT_CHECK. */
+
+	rtCheck::Scope rtScope;
+
 	mcl::AudioBuffer out(static_cast<float*>(outBuf), bufferSize, G_MAX_IO_CHANS);
 	mcl::AudioBuffer in;
 	if (isInputEnabled())
@@ -140,6 +159,8 @@ int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double /*streamTim
 	if (!canRender_())
 		return 0;
 
+	kernelMidi::startBlock_RT(bufferSize, realSampleRate_, clock::getCurrentFrame());
+
 #ifdef WITH_AUDIO_JACK
 	if (getAPI() == G_SYS_API_JACK)
 		sync::recvJackSync(jackTransportQuery());
@@ -255,6 +276,15 @@ int openDevice(const conf::Conf& conf)
 	options.streamName      = G_APP_NAME;
 	options.numberOfBuffers = 4; // TODO - wtf?
 
+	/* Let RtAudio create its thread with the right scheduling, where it can
+	(ALSA, PulseAudio). Affinity is set by the callback itself. */
+
+	if (conf.rtPriorityAudio > 0)
+	{
+		options.flags |= RTAUDIO_SCHEDULE_REALTIME;
+		options.priority = conf.rtPriorityAudio;
+	}
+
 	realBufsize_    = conf.buffersize;
 	realSampleRate_ = conf.samplerate;
 
@@ -26,10 +26,20 @@
 
 #include "kernelMidi.h"
 #include "const.h"
+#include "core/midiLights.h"
+#include "core/queue.h"
+#include "core/realtime.h"
+#include "core/sync.h"
+#include "core/worker.h"
 #include "midiDispatcher.h"
 #include "midiMapConf.h"
 #include "utils/log.h"
 #include <RtMidi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
 
 namespace giada
 {
@@ -46,23 +56,288 @@ RtMidiIn*  midiIn_      = nullptr;
 unsigned   numOutPorts_ = 0;
 unsigned   numInPorts_  = 0;
 
-static void callback_(double /*t*/, std::vector<unsigned char>* msg, void* /*data*/)
+/* -------------------------------------------------------------------------- */
+
+using Clock_ = std::chrono::steady_clock;
+
+/* OutMessage_
+A MIDI message waiting to be sent: 'size' bytes packed in 'data' (see 
+getIValue()), to be sent at 'time'. */
+
+struct OutMessage_
+{
+	uint32_t           data = 0x0;
+	int                size = 0;
+	Clock_::time_point time;
+};
+
+/* rtQueue_, queue_, queueMutex_
+Outgoing messages. The lock-free one is filled by the audio thread only, the
+other one by any other thread. */
+
+Queue<OutMessage_, G_MAX_MIDI_OUT_EVENTS> rtQueue_;
+std::vector<OutMessage_>                  queue_;
+std::mutex                                queueMutex_;
+
+/* blockTime_, blockDelay_, frameTime_
+Timing of the current audio block, audio thread only. Messages are delayed by
+one block, i.e. when the audio rendered along with them reaches the output. */
+
+Clock_::time_point            blockTime_;
+Frame                         blockDelay_ = 0;
+std::chrono::duration<double> frameTime_;
+
+/* blockStart_, blockSize_, blockFrame_, sampleRate_
+Timing and sequencer position of the last audio block, published for other 
+threads. Used to place incoming MIDI messages on the audio timeline. */
+
+std::atomic<Clock_::rep> blockStart_ = 0;
+std::atomic<Frame>       blockSize_  = 0;
+std::atomic<Frame>       blockFrame_ = 0;
+std::atomic<int>         sampleRate_ = 0;
+
+/* lastInput_
+Arrival time of the last incoming message. MIDI input thread only. */
+
+Clock_::time_point lastInput_;
+
+/* inputThreadReady_
+Whether the MIDI input thread (owned by RtMidi) has been set up. See 
+realtime::setupThread(). */
+
+thread_local bool inputThreadReady_ = false;
+
+/* lights_, lightsMutex_
+Lighting controllers. Repeated requests for the same controller between two 
+flushes collapse into the last one. */
+
+MidiLights lights_;
+std::mutex lightsMutex_;
+
+/* sender_, pending_, lightsOut_, raw_, budget_, lastFlush_
+MIDI output thread. 'pending_' holds the messages not yet due, 'lightsOut_' the
+lighting messages to send in the current flush, 'raw_' is the buffer passed to
+RtMidi. 'budget_' is the number of messages the port can take right now. All
+touched by the output thread only. */
+
+Worker                     sender_;
+std::vector<OutMessage_>   pending_;
+std::vector<uint32_t>      lightsOut_;
+std::vector<unsigned char> raw_;
+double                     budget_ = G_MIDI_OUT_MAX_BURST;
+Clock_::time_point         lastFlush_;
+
+/* outOpen_
+Whether an output port is open and the MIDI output thread is running, i.e. 
+whether outgoing messages will ever be consumed. Without it nobody drains the
+queues: messages are dropped instead. */
+
+std::atomic<bool> outOpen_ = false;
+
+/* -------------------------------------------------------------------------- */
+
+void sendRaw_(const OutMessage_& m)
+{
+	raw_.clear();
+	raw_.push_back(getB1(m.data));
+	if (m.size > 1)
+		raw_.push_back(getB2(m.data));
+	if (m.size > 2)
+		raw_.push_back(getB3(m.data));
+	midiOut_->sendMessage(&raw_);
+	budget_ -= 1.0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* flushLights_
+Sends lighting messages that changed since the last flush, as long as there is
+bandwidth left. The others wait for the next round. */
+
+void flushLights_()
+{
+	if (budget_ < 1.0)
+		return;
+
+	lightsOut_.clear();
+	{
+		std::scoped_lock lock(lightsMutex_);
+		lights_.collect(lightsOut_, static_cast<std::size_t>(budget_));
+	}
+
+	for (uint32_t value : lightsOut_)
+		sendRaw_({value, 3, lastFlush_});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* flush_
+Collects new messages from both queues and sends the ones which are due, in
+chronological order. Called periodically by the MIDI output thread. */
+
+void flush_()
+{
+	/* Refill the bandwidth budget. Regular messages are always sent, so the 
+	budget may go negative and hold back lighting ones for a while. */
+
+	const Clock_::time_point now     = Clock_::now();
+	const double             elapsed = std::chrono::duration<double>(now - lastFlush_).count();
+
+	budget_    = std::min(budget_ + elapsed * G_MIDI_OUT_MAX_RATE, static_cast<double>(G_MIDI_OUT_MAX_BURST));
+	lastFlush_ = now;
+
+	OutMessage_ m;
+	while (rtQueue_.pop(m))
+		pending_.push_back(m);
+	{
+		std::scoped_lock lock(queueMutex_);
+		pending_.insert(pending_.end(), queue_.begin(), queue_.end());
+		queue_.clear();
+	}
+
+	if (!pending_.empty())
+	{
+		std::stable_sort(pending_.begin(), pending_.end(), [](const OutMessage_& a, const OutMessage_& b) {
+			return a.time < b.time;
+		});
+
+		auto last = pending_.begin();
+		for (; last != pending_.end() && last->time <= now; ++last)
+			sendRaw_(*last);
+		pending_.erase(pending_.begin(), last);
+	}
+
+	flushLights_();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void push_(uint32_t data, int size)
+{
+	if (!outOpen_.load())
+		return;
+	std::scoped_lock lock(queueMutex_);
+	queue_.push_back({data, size, Clock_::now()});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* stampInput_
+Returns the arrival time of an incoming message. RtMidi provides the time 
+elapsed since the previous message ('delta', in seconds), which is more precise
+than the callback time when messages come in bursts. Falls back to the current
+time when the two drift apart (first message, driver hiccups). */
+
+Clock_::time_point stampInput_(double delta)
+{
+	const Clock_::time_point now  = Clock_::now();
+	const Clock_::time_point time = lastInput_ + std::chrono::duration_cast<Clock_::duration>(std::chrono::duration<double>(delta));
+
+	const bool valid = time <= now && now - time < std::chrono::microseconds(G_MIDI_IN_MAX_DRIFT_US);
+
+	lastInput_ = valid ? time : now;
+	return lastInput_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getElapsedFrames_
+Returns the frames elapsed from the start of the last block rendered to time 
+'t', or 0 if no block has been rendered yet. */
+
+Frame getElapsedFrames_(Clock_::time_point t)
+{
+	const int rate = sampleRate_.load();
+
+	if (blockSize_.load() == 0 || rate == 0)
+		return 0;
+
+	const Clock_::time_point start   = Clock_::time_point(Clock_::duration(blockStart_.load()));
+	const double             elapsed = std::chrono::duration<double>(t - start).count();
+
+	return static_cast<Frame>(elapsed * rate);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getFrameOffset_
+Maps time 't' to a frame offset within an audio block, according to the 
+timing of the last block rendered, instead of snapping the message to a block
+boundary. Known gap: the message reaches the audio thread through the Event 
+Dispatcher, which polls every G_EVENT_DISPATCHER_RATE_MS. The block it lands in
+may then vary, so playback latency jitters by whole blocks. */
+
+Frame getFrameOffset_(Clock_::time_point t)
 {
-	if (msg->size() < 3)
+	const Frame size = blockSize_.load();
+
+	if (size == 0)
+		return 0;
+
+	const Frame frame = getElapsedFrames_(t) % size;
+
+	return frame < 0 ? frame + size : frame;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getArrivalFrame_
+Maps time 't' to the sequencer frame being rendered at that time, not wrapped
+to the loop length. Unlike the frame read later on by the Event Dispatcher, it
+doesn't depend on when the message gets dispatched. */
+
+Frame getArrivalFrame_(Clock_::time_point t)
+{
+	return blockFrame_.load() + std::max(getElapsedFrames_(t), 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void callback_(double t, std::vector<unsigned char>* msg, void* /*data*/)
+{
+	if (!inputThreadReady_)
+	{
+		realtime::setupThread(realtime::ThreadRole::MIDI);
+		inputThreadReady_ = true;
+	}
+
+	if (msg->empty())
+		return;
+
+	const Clock_::time_point time = stampInput_(t);
+
+	/* MIDI clock and MTC messages go straight to the sync module, with their
+	timestamp: tempo estimation relies on it. */
+
+	if (sync::isMIDIsync(msg->at(0)))
 	{
-		//u::log::print("[KM] MIDI received - unknown signal - size=%d, value=0x", (int) msg->size());
-		//for (unsigned i=0; i<msg->size(); i++)
-		//	u::log::print("%X", (int) msg->at(i));
-		//u::log::print("\n");
+		sync::recvMIDIsync(msg->at(0), msg->size() > 1 ? msg->at(1) : 0, msg->size() > 2 ? msg->at(2) : 0,
+		    std::chrono::duration<double>(time.time_since_epoch()).count());
 		return;
 	}
-	midiDispatcher::dispatch(msg->at(0), msg->at(1), msg->at(2));
+
+	/* Other 1-byte messages (system real-time, tune request) are not handled, 
+	drop them. 2-byte ones (program change, channel pressure) go through with
+	a zero third byte. */
+
+	if (msg->size() < 2)
+		return;
+
+	const Frame delta = getFrameOffset_(time);
+	const Frame frame = getArrivalFrame_(time);
+	midiDispatcher::dispatch(msg->at(0), msg->at(1), msg->size() > 2 ? msg->at(2) : 0, delta, frame);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void sendMidiLightningInitMsgs_()
 {
+	/* The device state is unknown from now on: forget what was sent. */
+	{
+		std::scoped_lock lock(lightsMutex_);
+		lights_.clear();
+	}
+
 	for (const midimap::Message& m : midimap::midimap.initCommands)
 	{
 		if (m.value != 0x0 && m.channel != -1)
@@ -90,6 +365,9 @@ void setApi(int api)
 
 int openOutDevice(int port)
 {
+	outOpen_.store(false);
+	sender_.stop();
+
 	try
 	{
 		midiOut_ = new RtMidiOut((RtMidi::Api)api_, "Giada MIDI Output");
@@ -118,6 +396,10 @@ int openOutDevice(int port)
 			midiOut_->openPort(port, getOutPortName(port));
 			u::log::print("[KM] MIDI out port %d open\n", port);
 
+			sender_.start(flush_, /*sleep=*/G_MIDI_OUT_RATE_MS,
+			    []() { realtime::setupThread(realtime::ThreadRole::MIDI); });
+			outOpen_.store(true);
+
 			/* TODO - it should send midiLightning message only if there is a map loaded
 			and available in midimap:: */
 
@@ -165,7 +447,7 @@ int openInDevice(int port)
 		try
 		{
 			midiIn_->openPort(port, getInPortName(port));
-			midiIn_->ignoreTypes(true, false, true); // ignore all system/time msgs, for now
+			midiIn_->ignoreTypes(true, false, true); // Keep timing msgs for MIDI sync
 			u::log::print("[KM] MIDI in port %d open\n", port);
 			midiIn_->setCallback(&callback_);
 			return 1;
@@ -223,33 +505,39 @@ std::string getInPortName(unsigned p)
 
 void send(uint32_t data)
 {
-	if (!status_)
-		return;
+	push_(data, 3);
+}
 
-	std::vector<unsigned char> msg(1, getB1(data));
-	msg.push_back(getB2(data));
-	msg.push_back(getB3(data));
+/* -------------------------------------------------------------------------- */
 
-	midiOut_->sendMessage(&msg);
-	u::log::print("[KM::send] send msg=0x%X (%X %X %X)\n", data, msg[0], msg[1], msg[2]);
+void send(int b1, int b2, int b3)
+{
+	const int size = b2 == -1 ? 1 : b3 == -1 ? 2 : 3;
+	push_(getIValue(b1, std::max(b2, 0), std::max(b3, 0)), size);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void send(int b1, int b2, int b3)
+void send_RT(uint32_t data, Frame delta)
 {
-	if (!status_)
+	if (!outOpen_.load())
 		return;
+	const auto offset = std::chrono::duration_cast<Clock_::duration>(frameTime_ * (blockDelay_ + delta));
+	rtQueue_.push({data, 3, blockTime_ + offset});
+}
 
-	std::vector<unsigned char> msg(1, b1);
-
-	if (b2 != -1)
-		msg.push_back(b2);
-	if (b3 != -1)
-		msg.push_back(b3);
+/* -------------------------------------------------------------------------- */
 
-	midiOut_->sendMessage(&msg);
-	u::log::print("[KM::send] send msg=(%X %X %X)\n", b1, b2, b3);
+void startBlock_RT(Frame bufferSize, int sampleRate, Frame currentFrame)
+{
+	blockTime_  = Clock_::now();
+	blockDelay_ = bufferSize;
+	frameTime_  = std::chrono::duration<double>(1.0 / sampleRate);
+
+	blockStart_.store(blockTime_.time_since_epoch().count());
+	blockSize_.store(bufferSize);
+	blockFrame_.store(currentFrame);
+	sampleRate_.store(sampleRate);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -259,24 +547,26 @@ void sendMidiLightning(uint32_t learnt, const midimap::Message& m)
 	// Skip lightning message if not defined in midi map
 
 	if (!midimap::isDefined(m))
-	{
-		u::log::print("[KM::sendMidiLightning] message skipped (not defined in midimap)");
 		return;
-	}
-
-	u::log::print("[KM::sendMidiLightning] learnt=0x%X, chan=%d, msg=0x%X, offset=%d\n",
-	    learnt, m.channel, m.value, m.offset);
 
 	/* Isolate 'channel' from learnt message and offset it as requested by 'nn' in 
 	the midimap configuration file. */
 
 	uint32_t out = ((learnt & 0x00FF0000) >> 16) << m.offset;
 
-	/* Merge the previously prepared channel into final message, and finally send 
-	it. */
+	/* Merge the previously prepared channel into final message. */
 
 	out |= m.value | (m.channel << 24);
-	send(out);
+
+	/* Don't send it right away: store the new state of the controller (MIDI 
+	channel and note/CC number), the MIDI output thread will send it only if 
+	changed. */
+
+	if (!outOpen_.load())
+		return;
+
+	std::scoped_lock lock(lightsMutex_);
+	lights_.set(out);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -27,6 +27,7 @@
 #ifndef G_KERNELMIDI_H
 #define G_KERNELMIDI_H
 
+#include "core/types.h"
 #include "midiMapConf.h"
 #include <cstdint>
 #include <string>
@@ -44,13 +45,30 @@ int getB3(uint32_t iValue);
 uint32_t getIValue(int b1, int b2, int b3);
 
 /* send
-Sends a MIDI message 's' as uint32_t or as separate bytes. */
+Sends a MIDI message 's' as uint32_t or as separate bytes. Messages are queued
+and sent as soon as possible by the MIDI output thread. Not for the audio 
+thread: use send_RT() instead. */
 
 void send(uint32_t s);
 void send(int b1, int b2 = -1, int b3 = -1);
 
+/* send_RT
+Real-time version of send(). Pushes message 's' to a lock-free queue, to be
+sent by the MIDI output thread when frame 'delta' of the current audio block
+reaches the output. Audio thread only. */
+
+void send_RT(uint32_t s, Frame delta);
+
+/* startBlock_RT
+Marks the beginning of a new audio block of 'bufferSize' frames, starting at
+sequencer frame 'currentFrame'. Timestamps of messages queued with send_RT() are
+relative to it. Audio thread only. */
+
+void startBlock_RT(Frame bufferSize, int sampleRate, Frame currentFrame);
+
 /* sendMidiLightning
-Sends a MIDI lightning message defined by 'msg'. */
+Sends a MIDI lightning message defined by 'msg'. Messages are sent only when the
+state of the controller changes, with lower priority than regular ones. */
 
 void sendMidiLightning(uint32_t learnt, const midimap::Message& msg);
 
@@ -0,0 +1,123 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/midiClockFilter.h"
+#include "core/const.h"
+#include <cmath>
+
+namespace giada::m
+{
+namespace
+{
+constexpr double PI_ = 3.14159265358979323846;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MidiClockFilter::MidiClockFilter(double bandwidth)
+: m_bandwidth(bandwidth)
+{
+	reset();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiClockFilter::reset()
+{
+	m_next        = 0.0;
+	m_period      = 0.0;
+	m_ticks       = 0;
+	m_lockedTicks = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiClockFilter::tick(double t)
+{
+	/* The first two ticks just initialize the loop with a raw period. */
+
+	if (m_ticks == 0)
+	{
+		m_next = t;
+		m_ticks++;
+		return;
+	}
+	if (m_ticks == 1)
+	{
+		m_period = t - m_next;
+		m_next   = t + m_period;
+		m_ticks++;
+		return;
+	}
+
+	const double error = t - m_next;
+
+	/* Way off the prediction (tempo jump, lost ticks, restart): start over from
+	this tick. */
+
+	if (m_period <= 0.0 || std::abs(error) > m_period * G_MIDI_SYNC_RESET_ERROR)
+	{
+		reset();
+		tick(t);
+		return;
+	}
+
+	/* Loop coefficients, for a 0.707 damping. The loop is updated once per 
+	tick, hence the bandwidth scaled by the current period. */
+
+	const double omega = 2.0 * PI_ * m_bandwidth * m_period;
+	const double b     = std::sqrt(2.0) * omega;
+	const double c     = omega * omega;
+
+	m_next += b * error + m_period;
+	m_period += c * error;
+	m_ticks++;
+
+	if (std::abs(error) < m_period * G_MIDI_SYNC_LOCK_ERROR)
+		m_lockedTicks++;
+	else
+		m_lockedTicks = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MidiClockFilter::isLocked() const
+{
+	return m_lockedTicks >= G_MIDI_SYNC_LOCK_TICKS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+double MidiClockFilter::getBpm() const
+{
+	if (m_ticks < 2 || m_period <= 0.0)
+		return 0.0;
+	return 60.0 / (m_period * G_MIDI_CLOCK_PPQN);
+}
+} // namespace giada::m
@@ -0,0 +1,80 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_MIDI_CLOCK_FILTER_H
+#define G_MIDI_CLOCK_FILTER_H
+
+namespace giada::m
+{
+/* MidiClockFilter
+Tempo estimator for incoming MIDI clock (24 ticks per quarter note). Tick times
+go through a second order delay-locked loop (F. Adriaensen, "Using a DLL to 
+filter time"): the loop predicts the time of the next tick and corrects both 
+phase and period with the prediction error, so transport jitter is averaged out
+and the period converges to the master one. Time comes from the outside, in 
+seconds. */
+
+class MidiClockFilter final
+{
+public:
+	/* MidiClockFilter
+	'bandwidth' is the loop bandwidth in Hz: lower values filter out more jitter
+	but follow tempo changes more slowly. */
+
+	MidiClockFilter(double bandwidth);
+
+	/* tick
+	Feeds a new tick received at time 't'. */
+
+	void tick(double t);
+
+	/* reset
+	Forgets the current estimate, e.g. when the master restarts. */
+
+	void reset();
+
+	/* isLocked
+	Tells whether the prediction error has been small enough for a while, i.e. 
+	getBpm() can be trusted. */
+
+	bool isLocked() const;
+
+	/* getBpm
+	Returns the current tempo estimate, or 0.0 if not enough ticks came in. */
+
+	double getBpm() const;
+
+private:
+	double m_bandwidth;
+	double m_next;   // Predicted time of the next tick
+	double m_period; // Filtered tick period
+	int    m_ticks;
+	int    m_lockedTicks;
+};
+} // namespace giada::m
+
+#endif
@@ -35,9 +35,10 @@
 #include "core/types.h"
 #include "glue/events.h"
 #include "glue/plugin.h"
-#include "utils/log.h"
 #include "utils/math.h"
+#include <atomic>
 #include <cassert>
+#include <unordered_map>
 #include <vector>
 
 namespace giada::m::midiDispatcher
@@ -53,6 +54,46 @@ std::function<void(MidiEvent)> learnCb_  = nullptr;
 
 /* -------------------------------------------------------------------------- */
 
+/* Target_, Binding_
+What a learned MIDI message is bound to. 'channelIndex' is the position of the
+owning channel in the layout; plug-in fields are used by PLUGIN_PARAM only. */
+
+enum class Target_
+{
+	KEY_PRESS,
+	KEY_RELEASE,
+	MUTE,
+	KILL,
+	ARM,
+	SOLO,
+	VOLUME,
+	PITCH,
+	READ_ACTIONS,
+	PLUGIN_PARAM
+};
+
+struct Binding_
+{
+	Target_     target;
+	std::size_t channelIndex;
+	ID          channelId;
+	ID          pluginId   = 0;
+	std::size_t paramIndex = 0;
+};
+
+/* bindings_
+Lookup table from learned messages (MidiEvent::getRawNoVelocity()) to their
+bindings, in channel order. Lives in the Event Dispatcher thread. It is rebuilt
+lazily when 'dirty_' is set by a learn operation or when the layout structure
+has changed since the last build ('revision_', 'channels_'). */
+
+std::unordered_map<uint32_t, std::vector<Binding_>> bindings_;
+std::atomic<bool>                                   dirty_    = true;
+unsigned                                            revision_ = 0;
+std::size_t                                         channels_ = 0;
+
+/* -------------------------------------------------------------------------- */
+
 bool isMasterMidiInAllowed_(int c)
 {
 	int  filter  = model::get().midiIn.filter;
@@ -69,107 +110,126 @@ bool isChannelMidiInAllowed_(ID channelId, int c)
 
 /* -------------------------------------------------------------------------- */
 
-#ifdef WITH_VST
-
-void processPlugins_(const std::vector<Plugin*>& plugins, const MidiEvent& midiEvent)
+void rebuildBindings_()
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
-	float    vf   = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+	const std::vector<channel::Data>& channels = model::get().channels;
 
-	/* Plugins' parameters layout reflects the structure of the matrix
-	Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
-	parameter indexes match both the structure of Channel::midiInPlugins and the 
-	vector of plugins. */
+	bindings_.clear();
+	revision_ = model::getRevision();
+	channels_ = channels.size();
 
-	for (Plugin* p : plugins)
+	for (std::size_t i = 0; i < channels.size(); i++)
 	{
-		for (const MidiLearnParam& param : p->midiInParams)
+		const channel::Data&     c = channels[i];
+		const midiLearner::Data& l = c.midiLearner;
+
+		/* Channel parameters are mutually exclusive: only the first one learned
+		with a given message fires, in this order. */
+
+		const std::pair<Target_, uint32_t> params[] = {
+		    {Target_::KEY_PRESS, l.keyPress.getValue()},
+		    {Target_::KEY_RELEASE, l.keyRelease.getValue()},
+		    {Target_::MUTE, l.mute.getValue()},
+		    {Target_::KILL, l.kill.getValue()},
+		    {Target_::ARM, l.arm.getValue()},
+		    {Target_::SOLO, l.solo.getValue()},
+		    {Target_::VOLUME, l.volume.getValue()},
+		    {Target_::PITCH, l.pitch.getValue()},
+		    {Target_::READ_ACTIONS, l.readActions.getValue()}};
+
+		for (const auto& [target, value] : params)
 		{
-			if (pure != param.getValue())
+			if (value == 0x0)
 				continue;
-			c::events::setPluginParameter(p->id, param.getIndex(), vf, /*gui=*/false);
-			u::log::print("  >>> [pluginId=%d paramIndex=%d] (pure=0x%X, value=%d, float=%f)\n",
-			    p->id, param.getIndex(), pure, midiEvent.getVelocity(), vf);
+			std::vector<Binding_>& list = bindings_[value];
+			if (!list.empty() && list.back().channelIndex == i)
+				continue;
+			list.push_back({target, i, c.id});
 		}
+
+#ifdef WITH_VST
+		for (const Plugin* p : c.plugins)
+			for (const MidiLearnParam& param : p->midiInParams)
+				if (param.getValue() != 0x0)
+					bindings_[param.getValue()].push_back({Target_::PLUGIN_PARAM, i, c.id, p->id, param.getIndex()});
+#endif
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+
+void processBinding_(const Binding_& b, const MidiEvent& midiEvent)
+{
+	switch (b.target)
+	{
+	case Target_::KEY_PRESS:
+		c::events::pressChannel(b.channelId, midiEvent.getVelocity(), Thread::MIDI, midiEvent.getDelta());
+		break;
+	case Target_::KEY_RELEASE:
+		c::events::releaseChannel(b.channelId, Thread::MIDI);
+		break;
+	case Target_::MUTE:
+		c::events::toggleMuteChannel(b.channelId, Thread::MIDI);
+		break;
+	case Target_::KILL:
+		c::events::killChannel(b.channelId, Thread::MIDI);
+		break;
+	case Target_::ARM:
+		c::events::toggleArmChannel(b.channelId, Thread::MIDI);
+		break;
+	case Target_::SOLO:
+		c::events::toggleSoloChannel(b.channelId, Thread::MIDI);
+		break;
+	case Target_::VOLUME:
+		c::events::setChannelVolume(b.channelId,
+		    u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME), Thread::MIDI);
+		break;
+	case Target_::PITCH:
+		c::events::setChannelPitch(b.channelId,
+		    u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH), Thread::MIDI);
+		break;
+	case Target_::READ_ACTIONS:
+		c::events::toggleReadActionsChannel(b.channelId, Thread::MIDI);
+		break;
+#ifdef WITH_VST
+	case Target_::PLUGIN_PARAM:
+		c::events::setPluginParameter(b.pluginId, b.paramIndex,
+		    u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f), /*gui=*/false);
+		break;
 #endif
+	default:
+		break;
+	}
+}
 
 /* -------------------------------------------------------------------------- */
 
-void processChannels_(const MidiEvent& midiEvent)
+void processChannels_(const MidiEvent& midiEvent, Frame frame)
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
+	const std::vector<channel::Data>& channels = model::get().channels;
 
-	for (const channel::Data& c : model::get().channels)
-	{
+	if (dirty_.exchange(false) || revision_ != model::getRevision() || channels_ != channels.size())
+		rebuildBindings_();
 
-		/* Do nothing on this channel if MIDI in is disabled or filtered out for
-		the current MIDI channel. */
-		if (!c.midiLearner.isAllowed(midiEvent.getChannel()))
-			continue;
-
-		if (pure == c.midiLearner.keyPress.getValue())
-		{
-			u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::pressChannel(c.id, midiEvent.getVelocity(), Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.keyRelease.getValue())
-		{
-			u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::releaseChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.mute.getValue())
-		{
-			u::log::print("  >>> mute ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleMuteChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.kill.getValue())
-		{
-			u::log::print("  >>> kill ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::killChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.arm.getValue())
-		{
-			u::log::print("  >>> arm ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleArmChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.solo.getValue())
-		{
-			u::log::print("  >>> solo ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleSoloChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.volume.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-			u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::events::setChannelVolume(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.pitch.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH);
-			u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::events::setChannelPitch(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.readActions.getValue())
+	if (auto it = bindings_.find(midiEvent.getRawNoVelocity()); it != bindings_.end())
+	{
+		for (const Binding_& b : it->second)
 		{
-			u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleReadActionsChannel(c.id, Thread::MIDI);
-		}
+			const channel::Data& c = channels[b.channelIndex];
+			assert(c.id == b.channelId);
 
-#ifdef WITH_VST
-		/* Process learned plugins parameters. */
-		processPlugins_(c.plugins, midiEvent);
-#endif
-
-		/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
-		channels. */
-		if (c.armed)
-			c::events::sendMidiToChannel(c.id, midiEvent, Thread::MIDI);
+			/* Do nothing on this channel if MIDI in is disabled or filtered out
+			for the current MIDI channel. */
+			if (c.midiLearner.isAllowed(midiEvent.getChannel()))
+				processBinding_(b, midiEvent);
+		}
 	}
+
+	/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
+	channels. */
+	for (const channel::Data& c : channels)
+		if (c.armed && c.midiLearner.isAllowed(midiEvent.getChannel()))
+			c::events::sendMidiToChannel(c.id, midiEvent, Thread::MIDI, frame);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -180,54 +240,23 @@ void processMaster_(const MidiEvent& midiEvent)
 	const model::MidiIn& midiIn = model::get().midiIn;
 
 	if (pure == midiIn.rewind)
-	{
 		c::events::rewindSequencer(Thread::MIDI);
-		u::log::print("  >>> rewind (master) (pure=0x%X)\n", pure);
-	}
 	else if (pure == midiIn.startStop)
-	{
 		c::events::toggleSequencer(Thread::MIDI);
-		u::log::print("  >>> startStop (master) (pure=0x%X)\n", pure);
-	}
 	else if (pure == midiIn.actionRec)
-	{
 		c::events::toggleActionRecording();
-		u::log::print("  >>> actionRec (master) (pure=0x%X)\n", pure);
-	}
 	else if (pure == midiIn.inputRec)
-	{
 		c::events::toggleInputRecording();
-		u::log::print("  >>> inputRec (master) (pure=0x%X)\n", pure);
-	}
 	else if (pure == midiIn.metronome)
-	{
 		c::events::toggleMetronome();
-		u::log::print("  >>> metronome (master) (pure=0x%X)\n", pure);
-	}
 	else if (pure == midiIn.volumeIn)
-	{
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-		c::events::setMasterInVolume(vf, Thread::MIDI);
-		u::log::print("  >>> input volume (master) (pure=0x%X, value=%d, float=%f)\n",
-		    pure, midiEvent.getVelocity(), vf);
-	}
+		c::events::setMasterInVolume(u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME), Thread::MIDI);
 	else if (pure == midiIn.volumeOut)
-	{
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-		c::events::setMasterOutVolume(vf, Thread::MIDI);
-		u::log::print("  >>> output volume (master) (pure=0x%X, value=%d, float=%f)\n",
-		    pure, midiEvent.getVelocity(), vf);
-	}
+		c::events::setMasterOutVolume(u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME), Thread::MIDI);
 	else if (pure == midiIn.beatDouble)
-	{
 		c::events::multiplyBeats();
-		u::log::print("  >>> sequencer x2 (master) (pure=0x%X)\n", pure);
-	}
 	else if (pure == midiIn.beatHalf)
-	{
 		c::events::divideBeats();
-		u::log::print("  >>> sequencer /2 (master) (pure=0x%X)\n", pure);
-	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -282,6 +311,7 @@ void learnChannel_(MidiEvent e, int param, ID channelId, std::function<void()> d
 	}
 
 	model::swap(model::SwapType::SOFT);
+	dirty_.store(true);
 
 	stopLearn();
 	doneCb();
@@ -343,6 +373,7 @@ void learnPlugin_(MidiEvent e, std::size_t paramIndex, ID pluginId, std::functio
 	assert(paramIndex < plugin->midiInParams.size());
 
 	plugin->midiInParams[paramIndex].setValue(e.getRawNoVelocity());
+	dirty_.store(true);
 
 	stopLearn();
 	doneCb();
@@ -412,27 +443,24 @@ void clearPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()>
 
 /* -------------------------------------------------------------------------- */
 
-void dispatch(int byte1, int byte2, int byte3)
+void dispatch(int byte1, int byte2, int byte3, Frame delta, Frame frame)
 {
 	/* Here we want to catch two things: a) note on/note off from a MIDI keyboard 
 	and b) knob/wheel/slider movements from a MIDI controller. 
 	We must also fix the velocity zero issue for those devices that sends NOTE
 	OFF events as NOTE ON + velocity zero. Let's make it a real NOTE OFF event. */
 
-	MidiEvent midiEvent(byte1, byte2, byte3);
+	MidiEvent midiEvent(byte1, byte2, byte3, delta);
 	midiEvent.fixVelocityZero();
 
-	u::log::print("[midiDispatcher] MIDI received - 0x%X (chan %d)\n", midiEvent.getRaw(),
-	    midiEvent.getChannel());
-
 	/* Start dispatcher. Don't parse channels if MIDI learn is ON, just learn 
 	the incoming MIDI signal. The action is not invoked directly, but scheduled 
 	to be performed by the Event Dispatcher. */
 
-	Action                     action = {0, 0, 0, midiEvent};
+	Action                     action = {0, 0, frame, midiEvent};
 	eventDispatcher::EventType event  = learnCb_ != nullptr ? eventDispatcher::EventType::MIDI_DISPATCHER_LEARN : eventDispatcher::EventType::MIDI_DISPATCHER_PROCESS;
 
-	eventDispatcher::pumpMidiEvent({event, 0, 0, action});
+	eventDispatcher::pumpEvent({event, delta, 0, action});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -445,10 +473,10 @@ void learn(const MidiEvent& e)
 
 /* -------------------------------------------------------------------------- */
 
-void process(const MidiEvent& e)
+void process(const MidiEvent& e, Frame frame)
 {
 	processMaster_(e);
-	processChannels_(e);
+	processChannels_(e, frame);
 	triggerSignalCb_();
 }
 
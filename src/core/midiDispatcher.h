@@ -46,9 +46,11 @@ void clearPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()>
 #endif
 
 /* dispatch
-Main callback invoked by kernelMidi whenever a new MIDI data comes in. */
+Main callback invoked by kernelMidi whenever a new MIDI data comes in. 'delta'
+is the frame offset of the message within an audio block, 'frame' the sequencer
+frame at which it arrived (-1 if unknown). */
 
-void dispatch(int byte1, int byte2, int byte3);
+void dispatch(int byte1, int byte2, int byte3, Frame delta = 0, Frame frame = -1);
 
 /* learn
 Learns event 'e'. Called by the Event Dispatcher. */
@@ -56,10 +58,10 @@ Learns event 'e'. Called by the Event Dispatcher. */
 void learn(const MidiEvent& e);
 
 /* process
-Sends event 'e' to channels (masters and keyboard). Called by the Event 
-Dispatcher. */
+Sends event 'e', arrived at sequencer frame 'frame', to channels (masters and
+keyboard). Called by the Event Dispatcher. */
 
-void process(const MidiEvent& e);
+void process(const MidiEvent& e, Frame frame = -1);
 
 void setSignalCallback(std::function<void()> f);
 } // namespace giada::m::midiDispatcher
@@ -0,0 +1,76 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/midiLights.h"
+
+namespace giada::m
+{
+namespace
+{
+/* getKey_
+Returns the controller addressed by 'msg': MIDI channel (low nibble of the 
+status byte) and note/CC number. */
+
+uint32_t getKey_(uint32_t msg)
+{
+	return msg & 0x0FFF0000;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MidiLights::set(uint32_t msg)
+{
+	m_lights[getKey_(msg)].value = msg;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiLights::collect(std::vector<uint32_t>& out, std::size_t max)
+{
+	std::size_t count = 0;
+	for (auto& [key, light] : m_lights)
+	{
+		if (count == max)
+			break;
+		if (light.value == light.sent)
+			continue;
+		out.push_back(light.value);
+		light.sent = light.value;
+		count++;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiLights::clear()
+{
+	m_lights.clear();
+}
+} // namespace giada::m
@@ -0,0 +1,79 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_MIDI_LIGHTS_H
+#define G_MIDI_LIGHTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m
+{
+/* MidiLights
+State of the lighting controllers of a MIDI device. A controller is addressed by
+MIDI channel and note/CC number, whatever the status: note on and note off for 
+the same note drive the same light. Only the last message requested for each
+controller is kept, and it is sent only if it differs from the last one sent.
+Not thread-safe. */
+
+class MidiLights final
+{
+public:
+	/* set
+	Requests message 'msg', packed as in kernelMidi::getIValue(). */
+
+	void set(uint32_t msg);
+
+	/* collect
+	Appends to 'out' at most 'max' messages for controllers changed since they
+	were last collected, and marks them as sent. The others are left for the 
+	next call. */
+
+	void collect(std::vector<uint32_t>& out, std::size_t max);
+
+	/* clear
+	Forgets all controllers, e.g. when the device state is unknown. */
+
+	void clear();
+
+private:
+	/* Light
+	'value' is the last message requested, 'sent' the last one actually sent. */
+
+	struct Light
+	{
+		uint32_t value = 0x0;
+		uint32_t sent  = 0x0;
+	};
+
+	std::unordered_map<uint32_t, Light> m_lights;
+};
+} // namespace giada::m
+
+#endif
@@ -0,0 +1,137 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/midiStream.h"
+#include <bitset>
+
+namespace giada::m
+{
+namespace
+{
+constexpr int CONTROL_CHANGE_ = 0xB0;
+constexpr int CONTROLLERS_    = 16 * 128; // MIDI channels * controllers
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t getControllerIndex_(const MidiEvent& e)
+{
+	return ((e.getChannel() & 0x0F) << 7) | (e.getNote() & 0x7F);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MidiStream::MidiStream(std::size_t capacity)
+: m_capacity(capacity)
+, m_compact(false)
+, m_dropped(0)
+, m_coalesced(0)
+{
+	m_events.reserve(capacity);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MidiStream::push(const MidiEvent& e)
+{
+	if (m_events.size() == m_capacity && !m_compact)
+		coalesce();
+
+	if (m_events.size() == m_capacity)
+	{
+		markDropped();
+		return false;
+	}
+
+	m_events.push_back(e);
+	m_compact = false;
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiStream::markDropped()
+{
+	m_dropped.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiStream::clear()
+{
+	m_events.clear();
+	m_compact = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+MidiStream::Stats MidiStream::takeStats()
+{
+	return {m_dropped.exchange(0), m_coalesced.exchange(0)};
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t MidiStream::size() const { return m_events.size(); }
+std::size_t MidiStream::getCapacity() const { return m_capacity; }
+
+std::vector<MidiEvent>::const_iterator MidiStream::begin() const { return m_events.begin(); }
+std::vector<MidiEvent>::const_iterator MidiStream::end() const { return m_events.end(); }
+
+/* -------------------------------------------------------------------------- */
+
+void MidiStream::coalesce()
+{
+	/* Compact in place, walking backwards: a Control Change message is kept 
+	only if no later one targeting the same controller has been seen. Kept
+	events are moved towards the end, so unvisited ones are never overwritten
+	as 'first' >= 'i'. */
+
+	std::bitset<CONTROLLERS_> seen;
+
+	std::size_t first = m_events.size();
+	for (std::size_t i = m_events.size(); i-- > 0;)
+	{
+		const MidiEvent& e = m_events[i];
+		if (e.getStatus() == CONTROL_CHANGE_)
+		{
+			const std::size_t index = getControllerIndex_(e);
+			if (seen.test(index))
+			{
+				m_coalesced.fetch_add(1);
+				continue;
+			}
+			seen.set(index);
+		}
+		m_events[--first] = e;
+	}
+	m_events.erase(m_events.begin(), m_events.begin() + first);
+	m_compact = true;
+}
+} // namespace giada::m
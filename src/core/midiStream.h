@@ -0,0 +1,105 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_MIDI_STREAM_H
+#define G_MIDI_STREAM_H
+
+#include "core/midiEvent.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace giada::m
+{
+/* MidiStream
+Fixed-capacity list of MIDI events for a single audio block. Memory is 
+allocated once, so push() is safe to call from the audio thread. When the stream
+is full, Control Change messages for the same controller are merged into the 
+last one to make room, before any event is dropped. Merging runs at most once
+per full stream: if it frees nothing, further events are dropped right away. */
+
+class MidiStream final
+{
+public:
+	struct Stats
+	{
+		unsigned dropped   = 0;
+		unsigned coalesced = 0;
+	};
+
+	MidiStream(std::size_t capacity);
+
+	/* push
+	Appends event 'e'. Returns false if there's no room left even after 
+	coalescing: 'e' is then dropped. */
+
+	bool push(const MidiEvent& e);
+
+	/* markDropped
+	Accounts for an event dropped before reaching the stream, e.g. on a full 
+	queue. */
+
+	void markDropped();
+
+	/* clear
+	Removes all events. Statistics are left untouched. */
+
+	void clear();
+
+	/* takeStats
+	Returns the number of events dropped and coalesced since the last call. 
+	Thread safe. */
+
+	Stats takeStats();
+
+	std::size_t                            size() const;
+	std::size_t                            getCapacity() const;
+	std::vector<MidiEvent>::const_iterator begin() const;
+	std::vector<MidiEvent>::const_iterator end() const;
+
+private:
+	/* coalesce
+	Removes Control Change messages followed by another one for the same 
+	controller. Linear in the number of events. */
+
+	void coalesce();
+
+	std::vector<MidiEvent> m_events;
+	std::size_t            m_capacity;
+
+	/* m_compact
+	True if nothing was added since the last coalesce(), i.e. running it again 
+	would be useless. */
+
+	bool m_compact;
+
+	std::atomic<unsigned>  m_dropped;
+	std::atomic<unsigned>  m_coalesced;
+};
+} // namespace giada::m
+
+#endif
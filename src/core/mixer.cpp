@@ -26,7 +26,9 @@
 
 #include "core/mixer.h"
 #include "core/const.h"
+#include "core/dsp.h"
 #include "core/model/model.h"
+#include "core/plugins/pluginHost.h"
 #include "core/sequencer.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/log.h"
@@ -86,7 +88,7 @@ from model:: that the realtime thread cannot perform directly. */
 
 void fireSignalCb_()
 {
-	eventDispatcher::pumpUIevent({eventDispatcher::EventType::MIXER_SIGNAL_CALLBACK});
+	eventDispatcher::pumpEvent({eventDispatcher::EventType::MIXER_SIGNAL_CALLBACK});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -96,7 +98,7 @@ Same rationale of fireSignalCb_, for the endOfRecCb_ callback. */
 
 void fireEndOfRecCb_()
 {
-	eventDispatcher::pumpUIevent({eventDispatcher::EventType::MIXER_END_OF_REC_CALLBACK});
+	eventDispatcher::pumpEvent({eventDispatcher::EventType::MIXER_END_OF_REC_CALLBACK});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -167,10 +169,26 @@ void processLineIn_(const model::Mixer& mixer, const mcl::AudioBuffer& inBuf,
 
 /* -------------------------------------------------------------------------- */
 
+/* processChannels_
+Renders regular channels first, each one into master out or into the group bus
+it is routed to, plus its aux send if any. Then group buses, which by then have
+their input ready: shared plug-ins run once per bus, not once per channel. */
+
 void processChannels_(const model::Layout& layout, mcl::AudioBuffer& out, mcl::AudioBuffer& in)
 {
 	for (const channel::Data& c : layout.channels)
-		if (!c.isInternal())
+		if (c.type == ChannelType::GROUP)
+			c.buffer->audio.clear();
+
+	for (const channel::Data& c : layout.channels)
+	{
+		if (c.isInternal() || c.type == ChannelType::GROUP)
+			continue;
+		channel::render(c, c.outputBus != nullptr ? c.outputBus : &out, &in, isChannelAudible(c), c.sendBus);
+	}
+
+	for (const channel::Data& c : layout.channels)
+		if (c.type == ChannelType::GROUP)
 			channel::render(c, &out, &in, isChannelAudible(c));
 }
 
@@ -220,9 +238,7 @@ Applies a very dumb hard limiter. */
 
 void limit_(mcl::AudioBuffer& outBuf)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = std::max(-1.0f, std::min(outBuf[i][j], 1.0f));
+	dsp::clamp(outBuf[0], outBuf.countFrames() * outBuf.countChannels(), -1.0f, 1.0f);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -342,6 +358,11 @@ int render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const RenderInfo&
 	renderMasterOut_(rtLock.get(), out);
 	renderPreview_(rtLock.get(), out);
 
+#ifdef WITH_VST
+	if (!rtLock.get().locked)
+		pluginHost::applyParameters(rtLock.get().channels);
+#endif
+
 	/* Post processing. */
 
 	finalizeOutput_(mixer, out, info);
@@ -378,6 +399,12 @@ bool isChannelAudible(const channel::Data& c)
 		return true;
 	if (c.mute)
 		return false;
+
+	/* Group buses don't take part in solo: soloed channels routed to a bus must
+	be heard through it. */
+
+	if (c.type == ChannelType::GROUP)
+		return true;
 	bool hasSolos = model::get().mixer.hasSolos;
 	return !hasSolos || (hasSolos && c.solo);
 }
@@ -322,6 +322,16 @@ void deleteChannel(ID channelId)
 	u::vector::removeIf(model::get().channels, [channelId](const channel::Data& c) {
 		return c.id == channelId;
 	});
+
+	/* Channels routed or sent to a deleted group bus go back to master out. */
+
+	for (channel::Data& c : model::get().channels)
+	{
+		if (c.outputId == channelId)
+			c.outputId = 0;
+		if (c.sendId == channelId)
+			c.sendId = 0;
+	}
 	model::swap(model::SwapType::HARD);
 
 	if (wave != nullptr)
@@ -344,6 +354,34 @@ void renameChannel(ID channelId, const std::string& name)
 
 /* -------------------------------------------------------------------------- */
 
+void setOutput(ID channelId, ID busId)
+{
+	channel::Data& ch = model::get().getChannel(channelId);
+
+	assert(ch.type != ChannelType::GROUP);
+	assert(busId == 0 || model::get().getChannel(busId).type == ChannelType::GROUP);
+
+	ch.outputId = busId;
+	model::swap(model::SwapType::SOFT);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setSend(ID channelId, ID busId, float level, bool pre)
+{
+	channel::Data& ch = model::get().getChannel(channelId);
+
+	assert(ch.type != ChannelType::GROUP);
+	assert(busId == 0 || model::get().getChannel(busId).type == ChannelType::GROUP);
+
+	ch.sendId    = busId;
+	ch.sendLevel = level;
+	ch.sendPre   = pre;
+	model::swap(model::SwapType::SOFT);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void updateSoloCount()
 {
 	bool hasSolos = anyChannel_([](const channel::Data& ch) {
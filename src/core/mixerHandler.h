@@ -82,6 +82,18 @@ void deleteChannel(ID channelId);
 
 void cloneChannel(ID channelId);
 void renameChannel(ID channelId, const std::string& name);
+
+/* setOutput
+Routes channel 'channelId' to group bus 'busId', or back to master out if 
+'busId' is 0. Group buses themselves always play into master out. */
+
+void setOutput(ID channelId, ID busId);
+
+/* setSend
+Sends channel 'channelId' to group bus 'busId' (0 = no send) with level 
+'level', before ('pre' = true) or after volume and pan. */
+
+void setSend(ID channelId, ID busId, float level, bool pre);
 void freeAllChannels();
 
 void setInToOut(bool v);
@@ -25,6 +25,8 @@
  * -------------------------------------------------------------------------- */
 
 #include "core/model/model.h"
+#include "core/rtCheck.h"
+#include <atomic>
 #include <cassert>
 #ifdef G_DEBUG_MODE
 #include "core/channels/channelManager.h"
@@ -77,13 +79,45 @@ void remove_(D& dest, T& ref)
 {
 	u::vector::removeIf(dest, [&ref](const auto& other) { return other.get() == &ref; });
 }
+
+/* -------------------------------------------------------------------------- */
+
+/* getBusInput_
+Returns the input buffer of group bus 'id' in layout 'l', or nullptr if there's
+no such bus (e.g. 0, or a bus just deleted). */
+
+mcl::AudioBuffer* getBusInput_(const Layout& l, ID id)
+{
+	if (id == 0)
+		return nullptr;
+	for (const channel::Data& c : l.channels)
+		if (c.id == id && c.type == ChannelType::GROUP)
+			return &c.buffer->audio;
+	return nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* resolveBuses_
+Points each channel in layout 'l' to the input buffers of the group buses it is
+routed and sent to. */
+
+void resolveBuses_(Layout& l)
+{
+	for (channel::Data& c : l.channels)
+	{
+		c.outputBus = getBusInput_(l, c.outputId);
+		c.sendBus   = getBusInput_(l, c.sendId);
+	}
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-std::function<void(SwapType)> onSwap_ = nullptr;
+std::function<void(SwapType)> onSwap_   = nullptr;
+std::atomic<unsigned>         revision_ = 0;
 
 AtomicSwapper<Layout> layout;
 State                 state;
@@ -133,6 +167,7 @@ void init()
 
 Layout& get()
 {
+	rtCheck::check("model::get()"); // Use get_RT() instead
 	return layout.get();
 }
 
@@ -143,7 +178,10 @@ Lock get_RT()
 
 void swap(SwapType t)
 {
+	resolveBuses_(layout.get());
 	layout.swap();
+	if (t == SwapType::HARD)
+		revision_++;
 	if (onSwap_)
 		onSwap_(t);
 }
@@ -153,6 +191,11 @@ void onSwap(std::function<void(SwapType)> f)
 	onSwap_ = f;
 }
 
+unsigned getRevision()
+{
+	return revision_.load();
+}
+
 /* -------------------------------------------------------------------------- */
 
 bool isLocked()
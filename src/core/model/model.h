@@ -95,6 +95,9 @@ struct Mixer
 		WeakAtomic<float> peakOutR = 0.0f;
 		WeakAtomic<float> peakInL  = 0.0f;
 		WeakAtomic<float> peakInR  = 0.0f;
+#ifdef WITH_VST
+		WeakAtomic<Frame> latency  = 0; // Added by plug-ins, see pluginHost::updateLatency()
+#endif
 	};
 
 	State* state    = nullptr;
@@ -184,6 +187,12 @@ for listening to model changes. */
 
 void onSwap(std::function<void(SwapType)> f);
 
+/* getRevision
+Returns a counter increased on every HARD swap, i.e. whenever the structure of
+the layout changes. Useful to invalidate data derived from it. */
+
+unsigned getRevision();
+
 bool isLocked();
 
 /* -------------------------------------------------------------------------- */
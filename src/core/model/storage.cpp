@@ -30,6 +30,7 @@
 #include "core/kernelAudio.h"
 #include "core/model/model.h"
 #include "core/patch.h"
+#include "core/plugins/pluginLoader.h"
 #include "core/plugins/pluginManager.h"
 #include "core/recorderHandler.h"
 #include "core/sequencer.h"
@@ -60,7 +61,7 @@ void loadActions_(const std::vector<patch::Action>& pactions)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void store(patch::Patch& patch)
+void store(patch::Patch& patch, const std::string& basePath)
 {
 	const Layout& layout = get();
 
@@ -73,7 +74,7 @@ void store(patch::Patch& patch)
 
 #ifdef WITH_VST
 	for (const auto& p : getAll<PluginPtrs>())
-		patch.plugins.push_back(pluginManager::serializePlugin(*p));
+		patch.plugins.push_back(pluginManager::serializePlugin(*p, basePath));
 #endif
 
 	patch.actions = recorderHandler::serializeActions(getAll<Actions>());
@@ -119,9 +120,10 @@ void load(const patch::Patch& patch)
 	/* Load external data first: plug-ins and waves. */
 
 #ifdef WITH_VST
+	pluginLoader::reset();
 	getAll<PluginPtrs>().clear();
 	for (const patch::Plugin& pplugin : patch.plugins)
-		getAll<PluginPtrs>().push_back(pluginManager::deserializePlugin(pplugin, patch.version));
+		getAll<PluginPtrs>().push_back(pluginLoader::load(pplugin, patch.version));
 #endif
 
 	getAll<WavePtrs>().clear();
@@ -27,6 +27,8 @@
 #ifndef G_MODEL_STORAGE_H
 #define G_MODEL_STORAGE_H
 
+#include <string>
+
 namespace giada::m::patch
 {
 struct Patch;
@@ -38,7 +40,13 @@ struct Conf;
 namespace giada::m::model
 {
 void store(conf::Conf& c);
-void store(patch::Patch& p);
+
+/* store (2)
+Fills patch 'p'. Plug-in states are written to 'basePath' (the project 
+folder) as a side effect. */
+
+void store(patch::Patch& p, const std::string& basePath);
+
 void load(const patch::Patch& p);
 void load(const conf::Conf& c);
 } // namespace giada::m::model
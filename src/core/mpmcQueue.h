@@ -0,0 +1,156 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_MPMC_QUEUE_H
+#define G_MPMC_QUEUE_H
+
+#include "core/const.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace giada::m
+{
+/* MpmcQueue
+Bounded multi-producer, multi-consumer lock-free queue (D. Vyukov's design). 
+Each slot carries a sequence number telling whether it's ready to be written or
+read, so producers and consumers only contend on their own index. Indexes live
+on separate cache lines to avoid false sharing. 'size' must be a power of two. 
+Pushes to a full queue fail and are counted, see takeDropped(). */
+
+template <typename T, std::size_t size>
+class MpmcQueue
+{
+	static_assert(size >= 2 && (size & (size - 1)) == 0, "Size must be a power of two");
+
+public:
+	MpmcQueue()
+	: m_dropped(0)
+	, m_writePos(0)
+	, m_readPos(0)
+	{
+		for (std::size_t i = 0; i < size; i++)
+			m_slots[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue(MpmcQueue&&)      = delete;
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+	MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+	bool push(const T& item)
+	{
+		Slot*       slot;
+		std::size_t pos = m_writePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			slot                = &m_slots[pos & MASK];
+			const intptr_t diff = static_cast<intptr_t>(slot->seq.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+			if (diff == 0)
+			{
+				if (m_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0) // Queue full, nothing to do
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else // Another producer got there first
+				pos = m_writePos.load(std::memory_order_relaxed);
+		}
+		slot->data = item;
+		slot->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& item)
+	{
+		Slot*       slot;
+		std::size_t pos = m_readPos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			slot                = &m_slots[pos & MASK];
+			const intptr_t diff = static_cast<intptr_t>(slot->seq.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (m_readPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0) // Queue empty, nothing to do
+				return false;
+			else
+				pos = m_readPos.load(std::memory_order_relaxed);
+		}
+		item = slot->data;
+		slot->seq.store(pos + size, std::memory_order_release);
+		return true;
+	}
+
+	/* popAll
+	Pops up to 'max' items in one go, passing each one to 'f'. Returns the number
+	of items popped. */
+
+	template <typename F>
+	std::size_t popAll(F&& f, std::size_t max = size)
+	{
+		T           item;
+		std::size_t count = 0;
+		while (count < max && pop(item))
+		{
+			f(item);
+			count++;
+		}
+		return count;
+	}
+
+	/* takeDropped
+	Returns the number of failed pushes since the last call. */
+
+	std::size_t takeDropped()
+	{
+		return m_dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr std::size_t MASK = size - 1;
+
+	struct Slot
+	{
+		std::atomic<std::size_t> seq;
+		T                        data;
+	};
+
+	std::array<Slot, size>                              m_slots;
+	std::atomic<std::size_t>                            m_dropped;
+	alignas(G_CACHE_LINE_SIZE) std::atomic<std::size_t> m_writePos;
+	alignas(G_CACHE_LINE_SIZE) std::atomic<std::size_t> m_readPos;
+};
+} // namespace giada::m
+
+#endif
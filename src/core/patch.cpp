@@ -71,7 +71,7 @@ void readColumns_(const nl::json& j)
 
 #ifdef WITH_VST
 
-void readPlugins_(const nl::json& j)
+void readPlugins_(const nl::json& j, const std::string& basePath)
 {
 	if (!j.contains(PATCH_KEY_PLUGINS))
 		return;
@@ -88,7 +88,12 @@ void readPlugins_(const nl::json& j)
 			for (const auto& jparam : jplugin[PATCH_KEY_PLUGIN_PARAMS])
 				p.params.push_back(jparam);
 		else
-			p.state = jplugin.value(PATCH_KEY_PLUGIN_STATE, "");
+		{
+			p.state     = jplugin.value(PATCH_KEY_PLUGIN_STATE, "");
+			p.stateHash = jplugin.value(PATCH_KEY_PLUGIN_STATE_HASH, "");
+			if (!p.stateHash.empty())
+				p.statePath = basePath + p.stateHash + G_PLUGIN_STATE_EXT;
+		}
 
 		for (const auto& jmidiParam : jplugin[PATCH_KEY_PLUGIN_MIDI_IN_PARAMS])
 			p.midiInParams.push_back(jmidiParam);
@@ -181,6 +186,7 @@ void readChannels_(const nl::json& j)
 		c.shift             = jchannel.value(PATCH_KEY_CHANNEL_SHIFT, 0);
 		c.readActions       = jchannel.value(PATCH_KEY_CHANNEL_READ_ACTIONS, false);
 		c.pitch             = jchannel.value(PATCH_KEY_CHANNEL_PITCH, G_DEFAULT_PITCH);
+		c.resampleQuality   = jchannel.value(PATCH_KEY_CHANNEL_RESAMPLE_QUALITY, -1);
 		c.inputMonitor      = jchannel.value(PATCH_KEY_CHANNEL_INPUT_MONITOR, false);
 		c.overdubProtection = jchannel.value(PATCH_KEY_CHANNEL_OVERDUB_PROTECTION, false);
 		c.midiInVeloAsVol   = jchannel.value(PATCH_KEY_CHANNEL_MIDI_IN_VELO_AS_VOL, 0);
@@ -188,6 +194,10 @@ void readChannels_(const nl::json& j)
 		c.midiInPitch       = jchannel.value(PATCH_KEY_CHANNEL_MIDI_IN_PITCH, 0);
 		c.midiOut           = jchannel.value(PATCH_KEY_CHANNEL_MIDI_OUT, 0);
 		c.midiOutChan       = jchannel.value(PATCH_KEY_CHANNEL_MIDI_OUT_CHAN, 0);
+		c.outputId          = jchannel.value(PATCH_KEY_CHANNEL_OUTPUT_ID, 0);
+		c.sendId            = jchannel.value(PATCH_KEY_CHANNEL_SEND_ID, 0);
+		c.sendLevel         = jchannel.value(PATCH_KEY_CHANNEL_SEND_LEVEL, G_DEFAULT_VOL);
+		c.sendPre           = jchannel.value(PATCH_KEY_CHANNEL_SEND_PRE, false);
 
 #ifdef WITH_VST
 		if (jchannel.contains(PATCH_KEY_CHANNEL_PLUGINS))
@@ -212,10 +222,11 @@ void writePlugins_(nl::json& j)
 
 		nl::json jplugin;
 
-		jplugin[PATCH_KEY_PLUGIN_ID]     = p.id;
-		jplugin[PATCH_KEY_PLUGIN_PATH]   = p.path;
-		jplugin[PATCH_KEY_PLUGIN_BYPASS] = p.bypass;
-		jplugin[PATCH_KEY_PLUGIN_STATE]  = p.state;
+		jplugin[PATCH_KEY_PLUGIN_ID]         = p.id;
+		jplugin[PATCH_KEY_PLUGIN_PATH]       = p.path;
+		jplugin[PATCH_KEY_PLUGIN_BYPASS]     = p.bypass;
+		jplugin[PATCH_KEY_PLUGIN_STATE]      = p.state;
+		jplugin[PATCH_KEY_PLUGIN_STATE_HASH] = p.stateHash;
 
 		jplugin[PATCH_KEY_PLUGIN_MIDI_IN_PARAMS] = nl::json::array();
 		for (uint32_t param : p.midiInParams)
@@ -338,6 +349,7 @@ void writeChannels_(nl::json& j)
 		jchannel[PATCH_KEY_CHANNEL_SHIFT]                = c.shift;
 		jchannel[PATCH_KEY_CHANNEL_READ_ACTIONS]         = c.readActions;
 		jchannel[PATCH_KEY_CHANNEL_PITCH]                = c.pitch;
+		jchannel[PATCH_KEY_CHANNEL_RESAMPLE_QUALITY]     = c.resampleQuality;
 		jchannel[PATCH_KEY_CHANNEL_INPUT_MONITOR]        = c.inputMonitor;
 		jchannel[PATCH_KEY_CHANNEL_OVERDUB_PROTECTION]   = c.overdubProtection;
 		jchannel[PATCH_KEY_CHANNEL_MIDI_IN_VELO_AS_VOL]  = c.midiInVeloAsVol;
@@ -345,6 +357,10 @@ void writeChannels_(nl::json& j)
 		jchannel[PATCH_KEY_CHANNEL_MIDI_IN_PITCH]        = c.midiInPitch;
 		jchannel[PATCH_KEY_CHANNEL_MIDI_OUT]             = c.midiOut;
 		jchannel[PATCH_KEY_CHANNEL_MIDI_OUT_CHAN]        = c.midiOutChan;
+		jchannel[PATCH_KEY_CHANNEL_OUTPUT_ID]            = c.outputId;
+		jchannel[PATCH_KEY_CHANNEL_SEND_ID]              = c.sendId;
+		jchannel[PATCH_KEY_CHANNEL_SEND_LEVEL]           = c.sendLevel;
+		jchannel[PATCH_KEY_CHANNEL_SEND_PRE]             = c.sendPre;
 
 #ifdef WITH_VST
 		jchannel[PATCH_KEY_CHANNEL_PLUGINS] = nl::json::array();
@@ -465,7 +481,7 @@ int read(const std::string& file, const std::string& basePath)
 		readCommons_(j);
 		readColumns_(j);
 #ifdef WITH_VST
-		readPlugins_(j);
+		readPlugins_(j, basePath);
 #endif
 		readWaves_(j, basePath);
 		readActions_(j);
@@ -82,6 +82,10 @@ struct Channel
 	uint32_t    midiOutLplaying;
 	uint32_t    midiOutLmute;
 	uint32_t    midiOutLsolo;
+	ID          outputId  = 0;
+	ID          sendId    = 0;
+	float       sendLevel = G_DEFAULT_VOL;
+	bool        sendPre   = false;
 	// sample channel
 	ID               waveId = 0;
 	SamplePlayerMode mode;
@@ -89,7 +93,8 @@ struct Channel
 	Frame            end;
 	Frame            shift;
 	bool             readActions;
-	float            pitch = G_DEFAULT_PITCH;
+	float            pitch           = G_DEFAULT_PITCH;
+	int              resampleQuality = -1; // -1: use default from configuration
 	bool             inputMonitor;
 	bool             overdubProtection;
 	bool             midiInVeloAsVol;
@@ -126,7 +131,9 @@ struct Plugin
 	std::string           path;
 	bool                  bypass;
 	std::vector<float>    params; // TODO - to be removed in 0.18.0
-	std::string           state;
+	std::string           state;     // Base64, inline. Only in older patches
+	std::string           stateHash; // Binary state file, named after its hash
+	std::string           statePath; // Full path of the binary state file, on read
 	std::vector<uint32_t> midiInParams;
 };
 #endif
@@ -164,7 +171,8 @@ Initializes the patch with default values. */
 void init();
 
 /* read
-Reads patch from file. It takes 'basePath' as parameter for Wave reading. */
+Reads patch from file. It takes 'basePath' as parameter for Wave and plug-in
+state reading. */
 
 int read(const std::string& file, const std::string& basePath);
 
@@ -0,0 +1,437 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/pieceTable.h"
+#include "core/dsp.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <cassert>
+
+namespace giada::m
+{
+namespace
+{
+constexpr int SMOOTH_SIZE = 32;
+
+/* READ_CHUNK_SIZE
+Number of frames read at once when scanning the table, e.g. for computing the
+peak value. */
+
+constexpr Frame READ_CHUNK_SIZE = 4096;
+
+/* -------------------------------------------------------------------------- */
+
+/* split_
+Makes sure a piece begins at frame 'f'. Returns the index of such piece, or
+the number of pieces if 'f' is the end of the table. */
+
+std::size_t split_(PieceTable::Pieces& pieces, Frame f)
+{
+	Frame pos = 0;
+	for (std::size_t i = 0; i < pieces.size(); i++)
+	{
+		PieceTable::Piece& p = pieces[i];
+
+		if (pos == f)
+			return i;
+		if (f < pos + p.length)
+		{
+			const Frame k = f - pos;
+
+			/* Left part keeps the first 'k' frames as they are read, i.e. the
+			tail of the block range if the piece is reversed. */
+
+			PieceTable::Piece left  = p;
+			PieceTable::Piece right = p;
+			left.length             = k;
+			right.length            = p.length - k;
+			if (p.reversed)
+				left.offset += right.length;
+			else
+				right.offset += k;
+			for (PieceTable::Envelope& e : right.envelopes)
+				e.start += e.step * k;
+
+			pieces[i] = std::move(left);
+			pieces.insert(pieces.begin() + i + 1, std::move(right));
+			return i + 1;
+		}
+		pos += p.length;
+	}
+	return pieces.size();
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::read(const Pieces& pieces, int channels, float* out, Frame start, Frame frames)
+{
+	Frame pos = 0; // Position of the current piece in the table
+	for (const Piece& p : pieces)
+	{
+		if (frames <= 0)
+			break;
+		if (pos + p.length <= start)
+		{
+			pos += p.length;
+			continue;
+		}
+
+		const Frame local = start - pos; // First frame to read within the piece
+		const Frame count = std::min(p.length - local, frames);
+		const int   size  = count * channels;
+
+		if (p.block == nullptr || p.gain == 0.0f)
+			dsp::fill(out, size, 0.0f);
+		else if (!p.reversed)
+			dsp::copy((*p.block)[p.offset + local], out, size);
+		else
+		{
+			dsp::copy((*p.block)[p.offset + p.length - local - count], out, size);
+			dsp::reverse(out, count, channels);
+		}
+
+		if (p.block != nullptr && p.gain != 0.0f)
+		{
+			if (p.gain != 1.0f)
+				dsp::applyGain(out, size, p.gain);
+			for (const Envelope& e : p.envelopes)
+				dsp::applyRamp(out, count, channels, e.start + (e.step * local), e.step);
+		}
+
+		out += size;
+		start += count;
+		frames -= count;
+		pos += p.length;
+	}
+
+	/* Reading past the end of the table yields silence. */
+
+	if (frames > 0)
+		dsp::fill(out, frames * channels, 0.0f);
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer PieceTable::render(const Pieces& pieces, int channels)
+{
+	Frame frames = 0;
+	for (const Piece& p : pieces)
+		frames += p.length;
+
+	mcl::AudioBuffer out;
+	if (frames == 0)
+		return out;
+
+	out.alloc(frames, channels);
+	read(pieces, channels, out[0], 0, frames);
+
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+PieceTable::PieceTable(const mcl::AudioBuffer& source)
+: m_channels(source.countChannels())
+{
+	if (source.countFrames() == 0)
+		return;
+
+	Piece p;
+	p.block  = std::make_shared<const mcl::AudioBuffer>(source);
+	p.length = source.countFrames();
+	m_pieces.push_back(p);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame PieceTable::countFrames() const
+{
+	Frame frames = 0;
+	for (const Piece& p : m_pieces)
+		frames += p.length;
+	return frames;
+}
+
+int                        PieceTable::countChannels() const { return m_channels; }
+const PieceTable::Pieces& PieceTable::getPieces() const { return m_pieces; }
+bool                       PieceTable::canUndo() const { return !m_undo.empty(); }
+bool                       PieceTable::canRedo() const { return !m_redo.empty(); }
+
+/* -------------------------------------------------------------------------- */
+
+float PieceTable::getPeak(Frame a, Frame b) const
+{
+	clamp_(a, b);
+
+	std::vector<float> chunk(READ_CHUNK_SIZE * m_channels);
+	float              peak = 0.0f;
+
+	for (Frame i = a; i < b; i += READ_CHUNK_SIZE)
+	{
+		const Frame frames = std::min(READ_CHUNK_SIZE, b - i);
+		read(m_pieces, m_channels, chunk.data(), i, frames);
+		peak = std::max(peak, dsp::getPeak(chunk.data(), frames * m_channels));
+	}
+
+	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+PieceTable::Pieces PieceTable::copy(Frame a, Frame b) const
+{
+	clamp_(a, b);
+
+	/* Split a temporary copy, so that the current pieces are left untouched. */
+
+	Pieces      tmp = m_pieces;
+	std::size_t ia  = split_(tmp, a);
+	std::size_t ib  = split_(tmp, b);
+
+	return Pieces(tmp.begin() + ia, tmp.begin() + ib);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::cut(Frame a, Frame b)
+{
+	clamp_(a, b);
+	pushHistory_();
+
+	u::log::print("[PieceTable::cut] cutting from %d to %d\n", a, b);
+
+	std::size_t ia = split_(m_pieces, a);
+	std::size_t ib = split_(m_pieces, b);
+	m_pieces.erase(m_pieces.begin() + ia, m_pieces.begin() + ib);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::trim(Frame a, Frame b)
+{
+	clamp_(a, b);
+	pushHistory_();
+
+	u::log::print("[PieceTable::trim] trimming from %d to %d (area = %d)\n", a, b, b - a);
+
+	std::size_t ib = split_(m_pieces, b);
+	m_pieces.erase(m_pieces.begin() + ib, m_pieces.end());
+	std::size_t ia = split_(m_pieces, a);
+	m_pieces.erase(m_pieces.begin(), m_pieces.begin() + ia);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::paste(const Pieces& src, Frame a)
+{
+	a = std::clamp(a, 0, countFrames());
+	pushHistory_();
+
+	std::size_t ia = split_(m_pieces, a);
+	m_pieces.insert(m_pieces.begin() + ia, src.begin(), src.end());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::silence(Frame a, Frame b)
+{
+	clamp_(a, b);
+	pushHistory_();
+
+	u::log::print("[PieceTable::silence] silencing from %d to %d\n", a, b);
+
+	std::size_t ia = split_(m_pieces, a);
+	std::size_t ib = split_(m_pieces, b);
+
+	/* Replace the whole range with a single block-less piece. */
+
+	Piece p;
+	p.length = b - a;
+
+	m_pieces.erase(m_pieces.begin() + ia, m_pieces.begin() + ib);
+	m_pieces.insert(m_pieces.begin() + ia, p);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::normalize(Frame a, Frame b)
+{
+	clamp_(a, b);
+
+	const float peak = getPeak(a, b);
+	if (peak == 0.0f || peak > 1.0f)
+		return;
+
+	pushHistory_();
+
+	std::size_t ia = split_(m_pieces, a);
+	std::size_t ib = split_(m_pieces, b);
+	for (std::size_t i = ia; i < ib; i++)
+		m_pieces[i].gain *= 1.0f / peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::fade(Frame a, Frame b, wfx::Fade type)
+{
+	u::log::print("[PieceTable::fade] fade from %d to %d (range = %d)\n", a, b, b - a);
+
+	pushHistory_();
+
+	/* Same as wfx::fade: range is inclusive, gain goes from 0.0 on frame 'a' to
+	1.0 on frame 'b' when fading in, the other way around when fading out. */
+
+	const float d = 1.0f / (float)(b - a);
+
+	if (type == wfx::Fade::IN)
+		applyRamp_(a, b + 1, 0.0f, d);
+	else
+		applyRamp_(a, b + 1, d * (b - a), -d);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::smooth(Frame a, Frame b)
+{
+	if (SMOOTH_SIZE * 2 > (b - a))
+	{
+		u::log::print("[PieceTable::smooth] selection is too small, nothing to do\n");
+		return;
+	}
+
+	pushHistory_();
+
+	const float d = 1.0f / (float)SMOOTH_SIZE;
+
+	applyRamp_(a, a + SMOOTH_SIZE + 1, 0.0f, d);
+	applyRamp_(b - SMOOTH_SIZE, b + 1, d * SMOOTH_SIZE, -d);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::reverse(Frame a, Frame b)
+{
+	clamp_(a, b);
+	pushHistory_();
+
+	std::size_t ia = split_(m_pieces, a);
+	std::size_t ib = split_(m_pieces, b);
+
+	std::reverse(m_pieces.begin() + ia, m_pieces.begin() + ib);
+
+	/* Each piece is now read backwards: envelopes must follow. */
+
+	for (std::size_t i = ia; i < ib; i++)
+	{
+		Piece& p   = m_pieces[i];
+		p.reversed = !p.reversed;
+		for (Envelope& e : p.envelopes)
+			e = {e.start + (e.step * (p.length - 1)), -e.step};
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::shift(Frame offset)
+{
+	const Frame frames = countFrames();
+	if (frames == 0)
+		return;
+
+	pushHistory_();
+
+	/* Rotate right by 'offset' frames: the last 'offset' frames go first. */
+
+	offset = ((offset % frames) + frames) % frames;
+
+	std::size_t i = split_(m_pieces, frames - offset);
+	std::rotate(m_pieces.begin(), m_pieces.begin() + i, m_pieces.end());
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool PieceTable::undo()
+{
+	if (m_undo.empty())
+		return false;
+	m_redo.push_back(std::move(m_pieces));
+	m_pieces = std::move(m_undo.back());
+	m_undo.pop_back();
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool PieceTable::redo()
+{
+	if (m_redo.empty())
+		return false;
+	m_undo.push_back(std::move(m_pieces));
+	m_pieces = std::move(m_redo.back());
+	m_redo.pop_back();
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::clamp_(Frame& a, Frame& b) const
+{
+	const Frame frames = countFrames();
+	a                  = std::clamp(a, 0, frames);
+	b                  = std::clamp(b, a, frames);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::pushHistory_()
+{
+	m_undo.push_back(m_pieces);
+	m_redo.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PieceTable::applyRamp_(Frame a, Frame b, float start, float step)
+{
+	const Frame from = a;
+	clamp_(a, b);
+
+	std::size_t ia  = split_(m_pieces, a);
+	std::size_t ib  = split_(m_pieces, b);
+	Frame       pos = a;
+	for (std::size_t i = ia; i < ib; i++)
+	{
+		Piece& p = m_pieces[i];
+		p.envelopes.push_back({start + (step * (pos - from)), step});
+		pos += p.length;
+	}
+}
+} // namespace giada::m
@@ -0,0 +1,152 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_PIECE_TABLE_H
+#define G_PIECE_TABLE_H
+
+#include "core/types.h"
+#include "core/waveFx.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <memory>
+#include <vector>
+
+namespace giada::m
+{
+/* PieceTable
+Non-destructive edit model for a Wave. Audio data lives in immutable source
+blocks; the edited sample is described by a list of pieces, each one pointing
+to a range of a block plus some lazy gain segments. Edits only touch the piece
+list, so their cost depends on the number of pieces and not on the sample
+length. Undo/redo is done by swapping piece lists. Audio is produced with read()
+or render(), which can safely run on another thread on a copy of the pieces. */
+
+class PieceTable
+{
+public:
+	/* Block
+	Immutable audio data, shared among pieces, undo history and clipboard. */
+
+	using Block = std::shared_ptr<const mcl::AudioBuffer>;
+
+	/* Envelope
+	Linear gain segment applied when reading. Gain of the i-th frame of a piece
+	is 'start + (step * i)'. */
+
+	struct Envelope
+	{
+		float start;
+		float step;
+	};
+
+	/* Piece
+	Range [offset, offset + length) of frames taken from a block. A piece with
+	no block produces silence. If 'reversed', frames are read backwards. */
+
+	struct Piece
+	{
+		Block                 block    = nullptr;
+		Frame                 offset   = 0;
+		Frame                 length   = 0;
+		bool                  reversed = false;
+		float                 gain     = 1.0f;
+		std::vector<Envelope> envelopes;
+	};
+
+	using Pieces = std::vector<Piece>;
+
+	/* read
+	Renders 'frames' frames of 'pieces', starting from frame 'start', into the
+	interleaved buffer 'out'. */
+
+	static void read(const Pieces& pieces, int channels, float* out, Frame start, Frame frames);
+
+	/* render
+	Materializes 'pieces' into a brand new audio buffer. */
+
+	static mcl::AudioBuffer render(const Pieces& pieces, int channels);
+
+	/* PieceTable
+	Creates a piece table with a copy of 'source' as the only source block. */
+
+	PieceTable(const mcl::AudioBuffer& source);
+
+	Frame         countFrames() const;
+	int           countChannels() const;
+	const Pieces& getPieces() const;
+	bool          canUndo() const;
+	bool          canRedo() const;
+
+	/* getPeak
+	Returns the highest absolute value in range [a, b), any channel. */
+
+	float getPeak(Frame a, Frame b) const;
+
+	/* copy
+	Returns the pieces in range [a, b), to be pasted later on. */
+
+	Pieces copy(Frame a, Frame b) const;
+
+	/* Edits
+	Same semantics of their wfx:: counterparts. Each one is a single undo
+	step. */
+
+	void cut(Frame a, Frame b);
+	void trim(Frame a, Frame b);
+	void paste(const Pieces& src, Frame a);
+	void silence(Frame a, Frame b);
+	void normalize(Frame a, Frame b);
+	void fade(Frame a, Frame b, wfx::Fade type);
+	void smooth(Frame a, Frame b);
+	void reverse(Frame a, Frame b);
+	void shift(Frame offset);
+
+	/* undo, redo
+	Return false if there is nothing to undo/redo. */
+
+	bool undo();
+	bool redo();
+
+private:
+	/* clamp_
+	Clamps range [a, b) to the table boundaries. */
+
+	void clamp_(Frame& a, Frame& b) const;
+
+	/* pushHistory_
+	Saves current pieces into the undo stack and clears the redo one. */
+
+	void pushHistory_();
+
+	void applyRamp_(Frame a, Frame b, float start, float step);
+
+	Pieces              m_pieces;
+	std::vector<Pieces> m_undo;
+	std::vector<Pieces> m_redo;
+	int                 m_channels;
+};
+} // namespace giada::m
+
+#endif
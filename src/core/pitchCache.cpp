@@ -0,0 +1,300 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/pitchCache.h"
+#include "core/channels/channel.h"
+#include "core/conf.h"
+#include "core/const.h"
+#include "core/model/model.h"
+#include "core/resampler.h"
+#include "core/wave.h"
+#include "core/waveManager.h"
+#include "core/worker.h"
+#include "utils/vector.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m::pitchCache
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/* Key
+Everything a pitched Wave depends on. The buffer pointer changes when the
+Sample Editor replaces the Wave content. */
+
+struct Key
+{
+	bool operator==(const Key& o) const
+	{
+		return sameSource(o) && pitch == o.pitch;
+	}
+
+	bool operator!=(const Key& o) const { return !(*this == o); }
+
+	bool sameSource(const Key& o) const
+	{
+		return waveId == o.waveId && data == o.data && frames == o.frames && quality == o.quality;
+	}
+
+	ID                 waveId;
+	const float*       data;
+	Frame              frames;
+	Resampler::Quality quality;
+	float              pitch;
+};
+
+struct Cache
+{
+	Key                   key;
+	std::unique_ptr<Wave> wave;
+};
+
+struct Settle
+{
+	Key               key;
+	Clock::time_point since;
+	bool              requested = false;
+};
+
+/* Job, Result
+Render request sent to the worker thread, along with a private copy of the
+source Wave taken on the main thread: the original one might be edited or go 
+away while rendering. */
+
+struct Job
+{
+	ID   channelId;
+	Key  key;
+	Wave wave;
+};
+
+struct Result
+{
+	ID                    channelId;
+	Key                   key;
+	std::unique_ptr<Wave> wave;
+};
+
+Worker              worker_;
+std::mutex          mutex_;
+std::vector<Job>    jobs_;
+std::vector<Result> results_;
+
+/* caches_, settle_, lastUpdate_
+Owned by the main thread. */
+
+std::vector<Cache>             caches_;
+std::unordered_map<ID, Settle> settle_;
+Clock::time_point              lastUpdate_;
+
+/* -------------------------------------------------------------------------- */
+
+bool canCache_(const channel::Data& ch)
+{
+	/* Armed channels are left alone: input recording writes into the Wave
+	without replacing its buffer. */
+
+	return ch.samplePlayer && ch.samplePlayer->hasWave() && ch.state->resampler &&
+	       ch.samplePlayer->pitch != 1.0f && !ch.armed;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Key makeKey_(const channel::Data& ch)
+{
+	const mcl::AudioBuffer& buffer = ch.samplePlayer->getWave()->getBuffer();
+
+	return {
+	    ch.samplePlayer->getWaveId(),
+	    buffer[0],
+	    buffer.countFrames(),
+	    ch.state->resampler->getQuality(),
+	    ch.samplePlayer->pitch};
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Cache* findCache_(const Wave* w)
+{
+	auto it = u::vector::findIf(caches_, [w](const Cache& c) { return c.wave.get() == w; });
+	return it == caches_.end() ? nullptr : &*it;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool isOrphan_(const Cache& c)
+{
+	return !u::vector::has(model::get().channels, [&c](const channel::Data& ch) {
+		return ch.samplePlayer && ch.samplePlayer->waveReader.cache == c.wave.get();
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void request_(const channel::Data& ch, const Key& key)
+{
+	Job job = {ch.id, key, Wave(*ch.samplePlayer->getWave())};
+
+	std::scoped_lock lock(mutex_);
+	u::vector::removeIf(jobs_, [id = ch.id](const Job& j) { return j.channelId == id; });
+	jobs_.push_back(std::move(job));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void render_()
+{
+	std::optional<Job> job;
+	{
+		std::scoped_lock lock(mutex_);
+		if (jobs_.empty())
+			return;
+		job.emplace(std::move(jobs_.front()));
+		jobs_.erase(jobs_.begin());
+	}
+
+	std::unique_ptr<Wave> wave = waveManager::createPitched(job->wave, job->key.pitch,
+	    static_cast<int>(job->key.quality));
+
+	std::scoped_lock lock(mutex_);
+	results_.push_back({job->channelId, job->key, std::move(wave)});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* install_
+Hands finished renders to their channels. Renders that no longer match the
+channel (pitch moved again, Wave replaced, ...) are just thrown away. Returns
+true if the model has changed. */
+
+bool install_()
+{
+	std::vector<Result> results;
+	{
+		std::scoped_lock lock(mutex_);
+		results.swap(results_);
+	}
+
+	bool changed = false;
+	for (Result& r : results)
+	{
+		auto it = u::vector::findIf(model::get().channels, [&r](const channel::Data& ch) {
+			return ch.id == r.channelId;
+		});
+		if (it == model::get().channels.end() || !canCache_(*it) || makeKey_(*it) != r.key)
+			continue;
+
+		it->samplePlayer->waveReader.cache      = r.wave.get();
+		it->samplePlayer->waveReader.cachePitch = r.key.pitch;
+		caches_.push_back({r.key, std::move(r.wave)});
+		changed = true;
+	}
+	return changed;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init()
+{
+	worker_.start(render_, /*sleep=*/G_PITCH_CACHE_RATE_MS);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void update()
+{
+	const Clock::time_point now = Clock::now();
+
+	if (now - lastUpdate_ < std::chrono::milliseconds(G_PITCH_CACHE_RATE_MS))
+		return;
+	lastUpdate_ = now;
+
+	bool                           changed = false;
+	std::unordered_map<ID, Settle> settle;
+
+	for (channel::Data& ch : model::get().channels)
+	{
+		if (!ch.samplePlayer)
+			continue;
+
+		WaveReader& reader = ch.samplePlayer->waveReader;
+
+		if (!conf::conf.pitchCache || !canCache_(ch))
+		{
+			changed |= reader.cache != nullptr;
+			reader.cache = nullptr;
+			continue;
+		}
+
+		/* A cache rendered at another pitch is kept around, as the pitch might
+		come back to it: WaveReader just ignores it in the meantime. */
+
+		const Key    key   = makeKey_(ch);
+		const Cache* cache = findCache_(reader.cache);
+
+		if (cache != nullptr && !cache->key.sameSource(key))
+		{
+			reader.cache = nullptr;
+			changed      = true;
+		}
+		else if (cache != nullptr && cache->key.pitch == key.pitch)
+			continue;
+
+		auto   it = settle_.find(ch.id);
+		Settle s  = it != settle_.end() && it->second.key == key ? it->second : Settle{key, now};
+
+		if (!s.requested && now - s.since >= std::chrono::milliseconds(G_PITCH_CACHE_SETTLE_MS))
+		{
+			request_(ch, key);
+			s.requested = true;
+		}
+		settle[ch.id] = s;
+	}
+
+	settle_ = std::move(settle);
+	changed |= install_();
+
+	/* Release caches nobody points to, but only once the audio thread has
+	received a model without them. */
+
+	if (!changed && std::none_of(caches_.begin(), caches_.end(), isOrphan_))
+		return;
+
+	model::swap(model::SwapType::SOFT);
+	u::vector::removeIf(caches_, isOrphan_);
+}
+} // namespace giada::m::pitchCache
@@ -0,0 +1,53 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_PITCH_CACHE_H
+#define G_PITCH_CACHE_H
+
+/* giada::m::pitchCache
+Keeps a pre-rendered pitched version of the Wave of each Sample Channel whose
+pitch has settled, so that the channel can play it with a plain copy instead of
+resampling it in real-time. Rendering happens in a separate worker thread. The
+pitched Waves are derived ones: they are owned here and never saved. */
+
+namespace giada::m::pitchCache
+{
+/* init
+Starts the render thread. */
+
+void init();
+
+/* update
+Requests a new render for channels whose pitch has been still for a while,
+installs the finished renders and releases the unused ones. Must be called
+periodically by the main thread: it takes a snapshot of the Wave to render,
+which must not be edited (e.g. by the Sample Editor) in the meantime. */
+
+void update();
+} // namespace giada::m::pitchCache
+
+#endif
@@ -32,16 +32,29 @@
 #include "utils/log.h"
 #include "utils/time.h"
 #include <FL/Fl.H>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 
 namespace giada::m
 {
-Plugin::Plugin(ID id, const std::string& UID)
+Plugin::Plugin(ID id, const std::string& UID, bool loading)
 : id(id)
 , valid(false)
 , onEditorResize(nullptr)
 , m_plugin(nullptr)
+, m_bypass(false)
 , m_UID(UID)
+, m_loading(loading)
+, m_samplerate(0.0)
+, m_silentFrames(0)
+, m_idle(false)
+, m_avgTime(0.0f)
+, m_peakTime(0.0f)
+, m_blockTime(0.0f)
+, m_windowPeak(0.0f)
+, m_windowFrames(0)
 , m_hasEditor(false)
 {
 }
@@ -56,6 +69,15 @@ Plugin::Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> plugin, double
 , m_plugin(std::move(plugin))
 , m_playHead(std::make_unique<pluginHost::Info>())
 , m_bypass(false)
+, m_loading(false)
+, m_samplerate(samplerate)
+, m_silentFrames(0)
+, m_idle(false)
+, m_avgTime(0.0f)
+, m_peakTime(0.0f)
+, m_blockTime(0.0f)
+, m_windowPeak(0.0f)
+, m_windowFrames(0)
 , m_hasEditor(m_plugin->hasEditor())
 {
 	/* (1) Initialize midiInParams vector, where midiInParams.size == number of 
@@ -66,6 +88,7 @@ Plugin::Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> plugin, double
 		midiInParams.emplace_back(0x0, i);
 
 	m_buffer.setSize(G_MAX_IO_CHANS, buffersize);
+	m_midiBuffer.ensureSize(G_DEFAULT_VST_MIDIBUFFER_SIZE);
 
 	/* Try to set the main bus to the current number of channels. In the future
 	this setup will be performed manually through a proper channel matrix. */
@@ -84,6 +107,8 @@ Plugin::Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> plugin, double
 
 	m_plugin->prepareToPlay(samplerate, buffersize);
 
+	initParamOverflows();
+
 	u::log::print("[Plugin] plugin initialized and ready. MIDI input params: %lu\n",
 	    midiInParams.size());
 }
@@ -97,7 +122,21 @@ Plugin::Plugin(const Plugin& o)
 , onEditorResize(o.onEditorResize)
 , m_plugin(std::move(pluginManager::makePlugin(o)->m_plugin))
 , m_bypass(o.m_bypass.load())
+, m_loading(false)
+, m_samplerate(o.m_samplerate)
+, m_silentFrames(0)
+, m_idle(false)
+, m_avgTime(0.0f)
+, m_peakTime(0.0f)
+, m_blockTime(0.0f)
+, m_windowPeak(0.0f)
+, m_windowFrames(0)
 {
+	m_buffer.setSize(G_MAX_IO_CHANS, o.m_buffer.getNumSamples());
+	m_midiBuffer.ensureSize(G_DEFAULT_VST_MIDIBUFFER_SIZE);
+
+	if (valid)
+		initParamOverflows();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -145,6 +184,19 @@ int Plugin::countMainOutChannels() const
 
 /* -------------------------------------------------------------------------- */
 
+Frame Plugin::getSuspendFrames() const
+{
+	/* The tail is read each time, as it might depend on the current parameters
+	(e.g. reverb decay). */
+
+	const double tail = std::max(m_plugin->getTailLengthSeconds(), G_PLUGIN_SUSPEND_HOLD_MS / 1000.0);
+	if (!std::isfinite(tail) || tail * m_samplerate >= std::numeric_limits<Frame>::max())
+		return std::numeric_limits<Frame>::max();
+	return static_cast<Frame>(tail * m_samplerate);
+}
+
+/* -------------------------------------------------------------------------- */
+
 juce::AudioProcessorEditor* Plugin::createEditor() const
 {
 	juce::AudioProcessorEditor* e = m_plugin->createEditorIfNeeded();
@@ -215,7 +267,7 @@ bool Plugin::acceptsMidi() const
 PluginState Plugin::getState() const
 {
 	if (!valid)
-		return {};
+		return m_state;
 	juce::MemoryBlock data;
 	m_plugin->getStateInformation(data);
 	return PluginState(std::move(data));
@@ -223,13 +275,134 @@ PluginState Plugin::getState() const
 
 /* -------------------------------------------------------------------------- */
 
+Plugin::Stats Plugin::getStats() const
+{
+	Stats stats;
+	if (!valid)
+		return stats;
+
+	const float blockTime = m_blockTime.load();
+
+	stats.avgTime  = m_avgTime.load();
+	stats.peakTime = m_peakTime.load();
+	stats.avgLoad  = blockTime > 0.0f ? stats.avgTime / blockTime : 0.0f;
+	stats.peakLoad = blockTime > 0.0f ? stats.peakTime / blockTime : 0.0f;
+	stats.latency  = m_plugin->getLatencySamples();
+	stats.idle     = isIdle();
+	return stats;
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool Plugin::isBypassed() const { return m_bypass.load(); }
+bool Plugin::isLoading() const { return m_loading; }
+bool Plugin::isIdle() const { return m_idle.load(); }
 void Plugin::setBypass(bool b) { m_bypass.store(b); }
 
 /* -------------------------------------------------------------------------- */
 
-void Plugin::process(juce::AudioBuffer<float>& out, juce::MidiBuffer m)
+void Plugin::process(juce::AudioBuffer<float>& out, const juce::MidiBuffer& m, bool autoSuspend)
+{
+	using Clock = std::chrono::steady_clock;
+
+	const Clock::time_point start = Clock::now();
+	processBlock(out, m, autoSuspend);
+	const Clock::time_point end = Clock::now();
+
+	updateStats(std::chrono::duration<float, std::micro>(end - start).count(), out.getNumSamples());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Plugin::processBlock(juce::AudioBuffer<float>& out, const juce::MidiBuffer& m, bool autoSuspend)
+{
+	assert(out.getNumSamples() <= m_buffer.getNumSamples());
+
+	const bool        isInstrument = m_plugin->acceptsMidi();
+	const int         numFrames    = out.getNumSamples();
+	const std::size_t numParams    = drainParameters();
+
+	/* Input for an instrument is MIDI, audio for anything else. New input or 
+	parameter changes wake up an idle plug-in right away. */
+
+	const bool hasInput = numParams > 0 ||
+	                      (isInstrument ? !m.isEmpty() : out.getMagnitude(0, numFrames) >= G_PLUGIN_SILENCE_LEVEL);
+
+	if (!autoSuspend || hasInput)
+	{
+		m_silentFrames = 0;
+		m_idle.store(false);
+	}
+	else if (m_idle.load())
+		return; // Silent FX output is its silent input, already in 'out'
+
+	/* Split the block at each parameter change, so that changes take effect on
+	the exact frame they were scheduled for. */
+
+	Frame start = 0;
+	for (std::size_t i = 0; i < numParams; i++)
+	{
+		const ParamEvent& e     = m_paramEvents[i];
+		const Frame       delta = std::clamp(e.delta, 0, numFrames);
+		if (delta > start)
+		{
+			processRange(out, m, start, delta - start, isInstrument);
+			start = delta;
+		}
+		setParameter(e.index, e.value);
+	}
+	if (start < numFrames)
+		processRange(out, m, start, numFrames - start, isInstrument);
+
+	/* Count silent frames while there is no input, until the tail is over. */
+
+	if (autoSuspend && !hasInput)
+	{
+		if (m_buffer.getMagnitude(0, numFrames) < G_PLUGIN_SILENCE_LEVEL)
+			m_silentFrames += numFrames;
+		else
+			m_silentFrames = 0;
+		if (m_silentFrames >= getSuspendFrames())
+			m_idle.store(true);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Plugin::updateStats(float elapsed, Frame numFrames)
+{
+	if (m_samplerate <= 0.0 || numFrames <= 0)
+		return;
+
+	const float avgTime = m_avgTime.load();
+	m_avgTime.store(avgTime + (elapsed - avgTime) * G_PLUGIN_METER_SMOOTH);
+	m_blockTime.store(static_cast<float>(numFrames / m_samplerate * 1000000.0));
+
+	/* Peak over a fixed window of frames: the last complete window is published,
+	unless the current one has already seen a higher value. */
+
+	m_windowPeak = std::max(m_windowPeak, elapsed);
+	m_windowFrames += numFrames;
+	if (m_windowFrames >= m_samplerate * G_PLUGIN_METER_WINDOW_MS / 1000.0)
+	{
+		m_peakTime.store(m_windowPeak);
+		m_windowPeak   = 0.0f;
+		m_windowFrames = 0;
+	}
+	else if (m_windowPeak > m_peakTime.load())
+		m_peakTime.store(m_windowPeak);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Plugin::processRange(juce::AudioBuffer<float>& out, const juce::MidiBuffer& m,
+    Frame start, Frame length, bool isInstrument)
 {
+	/* Non-owning views on the same range of both buffers: no allocations. */
+
+	juce::AudioBuffer<float> outRange(out.getArrayOfWritePointers(), out.getNumChannels(), start, length);
+	juce::AudioBuffer<float> buffer(m_buffer.getArrayOfWritePointers(), m_buffer.getNumChannels(), start, length);
+
 	/* If this is not an instrument (i.e. doesn't accept MIDI), copy the 
 	incoming buffer data into the temporary one. This way FXes will process
 	existing audio data. Conversely, if the plug-in is an instrument, it 
@@ -237,25 +410,33 @@ void Plugin::process(juce::AudioBuffer<float>& out, juce::MidiBuffer m)
 	than one plug-in instrument in the same stack, driven by the same set of 
 	MIDI events. */
 
-	const bool isInstrument = m_plugin->acceptsMidi();
-
 	if (!isInstrument)
-		m_buffer = out;
+		for (int i = 0; i < std::min(buffer.getNumChannels(), outRange.getNumChannels()); i++)
+			buffer.copyFrom(i, 0, outRange, i, 0, length);
 	else
-		m_buffer.clear();
+		buffer.clear();
+
+	/* Copy MIDI events only if the plug-in can actually deal with them. The
+	local buffer is cleared anyway, as a plug-in is free to write into it. 
+	clear() and addEvents() reuse the existing storage: no allocations here, as
+	long as events fit in the preallocated space. */
+
+	m_midiBuffer.clear();
+	if (isInstrument && !m.isEmpty())
+		m_midiBuffer.addEvents(m, start, length, -start);
 
-	m_plugin->processBlock(m_buffer, m);
+	m_plugin->processBlock(buffer, m_midiBuffer);
 
 	/* The local buffer is now filled. Let's try to fill the 'out' one as well
 	by taking into account the bus layout - many plug-ins might have mono output
 	and we have a stereo buffer to fill. */
 
-	for (int i = 0, j = 0; i < out.getNumChannels(); i++)
+	for (int i = 0, j = 0; i < outRange.getNumChannels(); i++)
 	{
 		if (isInstrument)
-			out.addFrom(i, 0, m_buffer, j, 0, m_buffer.getNumSamples());
+			outRange.addFrom(i, 0, buffer, j, 0, length);
 		else
-			out.copyFrom(i, 0, m_buffer, j, 0, m_buffer.getNumSamples());
+			outRange.copyFrom(i, 0, buffer, j, 0, length);
 		if (i < countMainOutChannels() - 1)
 			j++;
 	}
@@ -263,8 +444,127 @@ void Plugin::process(juce::AudioBuffer<float>& out, juce::MidiBuffer m)
 
 /* -------------------------------------------------------------------------- */
 
+void Plugin::enqueueParameter(int index, float value, Frame delta, Thread t)
+{
+	assert(t == Thread::MAIN || t == Thread::MIDI);
+
+	if (!valid)
+		return;
+
+	const std::size_t thread   = t == Thread::MAIN ? 0 : 1;
+	ParamOverflow&    overflow = m_paramOverflows[thread];
+
+	/* Once in overflow, stay there until the audio thread has picked it up: a 
+	value pushed to the queue meanwhile would be overwritten by an older one. */
+
+	if (!overflow.pending.load() && m_paramQueues[thread].push({index, value, delta}))
+		return;
+	if (index < 0 || index >= static_cast<int>(overflow.values.size()))
+		return;
+	overflow.values[index].store(value);
+	overflow.pending.store(true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Plugin::applyParameters()
+{
+	const std::size_t numParams = drainParameters();
+	for (std::size_t i = 0; i < numParams; i++)
+		setParameter(m_paramEvents[i].index, m_paramEvents[i].value);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Plugin::initParamOverflows()
+{
+	const std::size_t numParams = m_plugin->getParameters().size();
+	for (ParamOverflow& o : m_paramOverflows)
+	{
+		o.values = std::vector<std::atomic<float>>(numParams);
+		for (std::atomic<float>& v : o.values)
+			v.store(std::numeric_limits<float>::quiet_NaN());
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t Plugin::drainParameters()
+{
+	std::size_t count = 0;
+	ParamEvent  e;
+
+	for (std::size_t thread = 0; thread < m_paramQueues.size(); thread++)
+	{
+		while (m_paramQueues[thread].pop(e))
+		{
+			/* Coalesce bursts (e.g. a knob being turned): only the last value
+			for a parameter at a given frame matters. */
+
+			const auto end = m_paramEvents.begin() + count;
+			const auto it  = std::find_if(m_paramEvents.begin(), end, [&e](const ParamEvent& o) {
+				return o.index == e.index && o.delta == e.delta;
+			});
+			if (it != end)
+				it->value = e.value;
+			else
+				m_paramEvents[count++] = e;
+		}
+		count = drainOverflow(m_paramOverflows[thread], count);
+	}
+
+	std::sort(m_paramEvents.begin(), m_paramEvents.begin() + count,
+	    [](const ParamEvent& a, const ParamEvent& b) { return a.delta < b.delta; });
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t Plugin::drainOverflow(ParamOverflow& o, std::size_t count)
+{
+	if (!o.pending.exchange(false))
+		return count;
+
+	for (std::size_t index = 0; index < o.values.size(); index++)
+	{
+		if (count == m_paramEvents.size()) // No room left, try again next block
+		{
+			o.pending.store(true);
+			break;
+		}
+
+		const float value = o.values[index].exchange(std::numeric_limits<float>::quiet_NaN());
+		if (std::isnan(value))
+			continue;
+
+		/* The overflow value is the newest one: it replaces the last queued 
+		value for the same parameter, if any. */
+
+		ParamEvent* last = nullptr;
+		for (std::size_t i = 0; i < count; i++)
+			if (m_paramEvents[i].index == static_cast<int>(index) &&
+			    (last == nullptr || m_paramEvents[i].delta >= last->delta))
+				last = &m_paramEvents[i];
+
+		if (last != nullptr)
+			last->value = value;
+		else
+			m_paramEvents[count++] = {static_cast<int>(index), value, /*delta=*/0};
+	}
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Plugin::setState(PluginState state)
 {
+	if (!valid)
+	{
+		m_state = std::move(state);
+		return;
+	}
 	m_plugin->setStateInformation(state.getData(), state.getSize());
 }
 
@@ -329,6 +629,13 @@ std::string Plugin::getParameterText(int index) const
 
 /* -------------------------------------------------------------------------- */
 
+std::string Plugin::getParameterText(int index, float value) const
+{
+	return m_plugin->getParameters()[index]->getText(value, /*maximumStringLength=*/1024).toStdString();
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::string Plugin::getParameterLabel(int index) const
 {
 	return m_plugin->getParameters()[index]->getLabel().toStdString();
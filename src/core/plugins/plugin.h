@@ -33,7 +33,12 @@
 #include "core/midiLearnParam.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginState.h"
+#include "core/queue.h"
+#include "core/types.h"
 #include "deps/juce-config.h"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <vector>
 
 namespace giada::m
@@ -41,7 +46,27 @@ namespace giada::m
 class Plugin : private juce::ComponentListener
 {
 public:
-	Plugin(ID id, const std::string& UID);
+	/* Stats
+	Performance figures, measured on the audio thread. Times are in 
+	microseconds, loads are fractions of the block duration (1.0 = the whole 
+	block). The peak is the highest value over the last 
+	G_PLUGIN_METER_WINDOW_MS. */
+
+	struct Stats
+	{
+		float avgTime  = 0.0f;
+		float peakTime = 0.0f;
+		float avgLoad  = 0.0f;
+		float peakLoad = 0.0f;
+		int   latency  = 0; // In frames, as reported by the plug-in
+		bool  idle     = false;
+	};
+
+	/* Plugin (1)
+	Invalid plug-in, i.e. missing or - if 'loading' - a placeholder for a 
+	plug-in being instantiated in background. */
+
+	Plugin(ID id, const std::string& UID, bool loading = false);
 	Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> p, double samplerate, int buffersize);
 	Plugin(const Plugin& o);
 	~Plugin();
@@ -57,9 +82,12 @@ public:
 	float                       getParameter(int index) const;
 	std::string                 getParameterName(int index) const;
 	std::string                 getParameterText(int index) const;
+	std::string                 getParameterText(int index, float value) const;
 	std::string                 getParameterLabel(int index) const;
 	bool                        isSuspended() const;
 	bool                        isBypassed() const;
+	bool                        isLoading() const;
+	bool                        isIdle() const;
 	int                         getNumPrograms() const;
 	int                         getCurrentProgram() const;
 	std::string                 getProgramName(int index) const;
@@ -67,16 +95,39 @@ public:
 	void                        setCurrentProgram(int index) const;
 	bool                        acceptsMidi() const;
 	PluginState                 getState() const;
+	Stats                       getStats() const;
 	juce::AudioProcessorEditor* createEditor() const;
 
 	/* process
 	Process the plug-in with audio and MIDI data. The audio buffer is a reference:
-	it has to be altered by the plug-in itself. Conversely, the MIDI buffer must
-	be passed by copy: each plug-in must receive its own copy of the event set, so
-	that any attempt to change/clear the MIDI buffer will only modify the local 
-	copy. */
+	it has to be altered by the plug-in itself. The MIDI buffer is read-only:
+	each plug-in receives its own copy of the event set in a preallocated 
+	buffer, so that any attempt to change/clear it will only modify the local 
+	copy. 
+	If 'autoSuspend' is set, the plug-in goes idle - i.e. it is not processed
+	anymore - once its input and its output have been silent for longer than its
+	tail. It wakes up as soon as new audio or MIDI events come in. Each call is
+	timed, see getStats(). */
+
+	void process(juce::AudioBuffer<float>& b, const juce::MidiBuffer& m, bool autoSuspend);
 
-	void process(juce::AudioBuffer<float>& b, juce::MidiBuffer m);
+	/* enqueueParameter
+	Schedules a parameter change, applied by the audio thread at frame 'delta' 
+	of the next block. Lock-free: each producer thread (MAIN or MIDI) has its 
+	own queue. When the queue is full the value goes to a per-parameter overflow
+	slot instead, so the last value set is never lost. */
+
+	void enqueueParameter(int index, float value, Frame delta, Thread t);
+
+	/* applyParameters
+	Applies all pending parameter changes at once. Used by the audio thread when
+	the plug-in is not processed (e.g. bypassed, or in a stack not rendered). */
+
+	void applyParameters();
+
+	/* setState
+	Invalid plug-ins just keep the state around, so that it won't get lost when
+	the patch is saved again. */
 
 	void setState(PluginState p);
 	void setBypass(bool b);
@@ -112,6 +163,26 @@ private:
 		OUT = false
 	};
 
+	struct ParamEvent
+	{
+		int   index;
+		float value;
+		Frame delta;
+	};
+
+	using ParamQueue = Queue<ParamEvent, G_MAX_PLUGIN_PARAM_EVENTS>;
+
+	/* ParamOverflow
+	Last values that didn't fit in a full ParamQueue, one slot per parameter 
+	(NaN = empty). While 'pending' is set the producer keeps writing here, so 
+	that these values are always newer than the ones in the queue. */
+
+	struct ParamOverflow
+	{
+		std::vector<std::atomic<float>> values;
+		std::atomic<bool>               pending{false};
+	};
+
 	/* JUCE overrides. */
 
 	void componentMovedOrResized(juce::Component& c, bool moved, bool resized) override;
@@ -123,10 +194,59 @@ private:
 
 	int countMainOutChannels() const;
 
+	/* getSuspendFrames
+	Returns how many frames of silence are needed before going idle. Infinite
+	tails (e.g. oscillators, loopers) never suspend. */
+
+	Frame getSuspendFrames() const;
+
+	/* initParamOverflows
+	Allocates one overflow slot per parameter. Main thread only. */
+
+	void initParamOverflows();
+
+	/* drainParameters
+	Moves pending parameter changes from the queues to m_paramEvents, keeping
+	only the last value for each parameter and frame, sorted by frame. Overflow
+	values are merged into the last event of their parameter. Returns the number
+	of events. */
+
+	std::size_t drainParameters();
+
+	/* drainOverflow
+	Merges overflow values from 'o' into the first 'count' events of 
+	m_paramEvents. Returns the new number of events. */
+
+	std::size_t drainOverflow(ParamOverflow& o, std::size_t count);
+
+	/* processBlock
+	The actual processing, timed by process(). */
+
+	void processBlock(juce::AudioBuffer<float>& b, const juce::MidiBuffer& m, bool autoSuspend);
+
+	/* updateStats
+	Updates rolling average and peak with the time ('elapsed', in microseconds)
+	spent on a block of 'numFrames' frames. */
+
+	void updateStats(float elapsed, Frame numFrames);
+
+	/* processRange
+	Processes 'length' frames of 'out' starting at 'start'. */
+
+	void processRange(juce::AudioBuffer<float>& out, const juce::MidiBuffer& m,
+	    Frame start, Frame length, bool isInstrument);
+
 	std::unique_ptr<juce::AudioPluginInstance> m_plugin;
 	std::unique_ptr<pluginHost::Info>          m_playHead;
 	juce::AudioBuffer<float>                   m_buffer;
 
+	/* m_midiBuffer
+	Private copy of the incoming MIDI events, preallocated so that filling it
+	doesn't allocate memory on the audio thread. Left empty for plug-ins that
+	don't take MIDI. */
+
+	juce::MidiBuffer m_midiBuffer;
+
 	std::atomic<bool> m_bypass;
 
 	/* UID
@@ -134,6 +254,41 @@ private:
 
 	std::string m_UID;
 
+	/* m_state
+	State of an invalid plug-in. See setState(). */
+
+	PluginState m_state;
+
+	/* m_loading
+	Whether this is a placeholder for a plug-in being loaded. */
+
+	bool m_loading;
+
+	/* m_samplerate, m_silentFrames, m_idle
+	Automatic suspension state. See process(). */
+
+	double            m_samplerate;
+	Frame             m_silentFrames;
+	std::atomic<bool> m_idle;
+
+	/* m_paramQueues, m_paramOverflows, m_paramEvents
+	Parameter changes, one queue and one overflow per producer thread (MAIN and
+	MIDI), and their drained version for the current block. */
+
+	std::array<ParamQueue, 2>                             m_paramQueues;
+	std::array<ParamOverflow, 2>                          m_paramOverflows;
+	std::array<ParamEvent, G_MAX_PLUGIN_PARAM_EVENTS * 2> m_paramEvents;
+
+	/* m_avgTime, m_peakTime, m_blockTime, m_windowPeak, m_windowFrames
+	Performance stats. The first three are written by the audio thread and read
+	by the UI, the last two are private to the audio thread. See updateStats(). */
+
+	std::atomic<float> m_avgTime;
+	std::atomic<float> m_peakTime;
+	std::atomic<float> m_blockTime;
+	float              m_windowPeak;
+	Frame              m_windowFrames;
+
 	/* m_hasEditor
 	Cached boolean value that tells if the plug-in has editor. Some plug-ins
 	take ages to query it, better fetch the property during construction. */
@@ -29,55 +29,86 @@
 #include "core/plugins/pluginHost.h"
 #include "core/channels/channel.h"
 #include "core/clock.h"
+#include "core/conf.h"
 #include "core/const.h"
+#include "core/dsp.h"
+#include "core/mixer.h"
 #include "core/model/model.h"
 #include "core/plugins/plugin.h"
 #include "core/plugins/pluginManager.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/log.h"
 #include "utils/vector.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 
 namespace giada::m::pluginHost
 {
 namespace
 {
-std::vector<Plugin*>     plugins_;
-juce::MessageManager*    messageManager_;
-juce::AudioBuffer<float> audioBuffer_;
-ID                       pluginId_;
+std::vector<Plugin*>  plugins_;
+juce::MessageManager* messageManager_;
+ID                    pluginId_;
+
+/* lastLog_
+Owned by the thread calling logStats(). */
+
+std::chrono::steady_clock::time_point lastLog_;
+
+/* emptyEvents_
+Reusable, always empty MIDI buffer for audio stacks. Plug-ins get their own
+copy of the events, so nobody ever writes into this. */
+
+const juce::MidiBuffer emptyEvents_;
 
 /* -------------------------------------------------------------------------- */
 
-void giadaToJuceTempBuf_(const mcl::AudioBuffer& outBuf)
+/* getLatency_
+Returns the latency of a plug-in stack, i.e. the sum of the latencies of all 
+plug-ins that are actually processed. */
+
+Frame getLatency_(const std::vector<Plugin*>& plugins)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			audioBuffer_.setSample(j, i, outBuf[i][j]);
+	Frame latency = 0;
+	for (const Plugin* p : plugins)
+		if (p->valid && !p->isSuspended() && !p->isBypassed())
+			latency += p->getStats().latency;
+	return latency;
 }
 
-/* juceToGiadaOutBuf_
-Converts buffer from Juce to Giada. A note for the future: if we overwrite (=) 
-(as we do now) it's SEND, if we add (+) it's INSERT. */
+/* -------------------------------------------------------------------------- */
+
+/* getPathLatency_
+Returns the plug-in latency along the whole path of a channel, that is its own
+stack plus the one of the group bus it outputs to, if any. */
 
-void juceToGiadaOutBuf_(mcl::AudioBuffer& outBuf)
+Frame getPathLatency_(const model::Layout& layout, const channel::Data& ch)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = audioBuffer_.getSample(j, i);
+	Frame latency = getLatency_(ch.plugins);
+	if (ch.outputId != 0)
+		for (const channel::Data& bus : layout.channels)
+			if (bus.id == ch.outputId)
+				latency += getLatency_(bus.plugins);
+	return latency;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void processPlugins_(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events)
+void processPlugins_(const std::vector<Plugin*>& plugins, juce::AudioBuffer<float>& workBuf,
+    const juce::MidiBuffer& events)
 {
+	const bool autoSuspend = conf::conf.pluginAutoSuspend;
+
 	for (Plugin* p : plugins)
 	{
-		if (!p->valid || p->isSuspended() || p->isBypassed())
+		if (!p->valid)
 			continue;
-		p->process(audioBuffer_, events);
+		if (p->isSuspended() || p->isBypassed())
+			p->applyParameters();
+		else
+			p->process(workBuf, events, autoSuspend);
 	}
-	events.clear();
 }
 } // namespace
 
@@ -114,19 +145,22 @@ void close()
 
 /* -------------------------------------------------------------------------- */
 
-void init(int buffersize)
+void init()
 {
 	messageManager_ = juce::MessageManager::getInstance();
-	audioBuffer_.setSize(G_MAX_IO_CHANS, buffersize);
-	pluginId_ = 0;
+	pluginId_       = 0;
 }
 
 /* -------------------------------------------------------------------------- */
 
 void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-    juce::MidiBuffer* events)
+    juce::AudioBuffer<float>& workBuf, juce::MidiBuffer* events)
 {
-	assert(outBuf.countFrames() == audioBuffer_.getNumSamples());
+	assert(outBuf.countFrames() == workBuf.getNumSamples());
+	assert(outBuf.countChannels() == workBuf.getNumChannels());
+
+	const Frame frames   = outBuf.countFrames();
+	const int   channels = outBuf.countChannels();
 
 	/* If events are null: Audio stack processing (master in, master out or
 	sample channels. No need for MIDI events. 
@@ -135,16 +169,20 @@ void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
 
 	if (events == nullptr)
 	{
-		giadaToJuceTempBuf_(outBuf);
-		juce::MidiBuffer dummyEvents; // empty
-		processPlugins_(plugins, dummyEvents);
+		dsp::deinterleave(outBuf[0], workBuf.getArrayOfWritePointers(), frames, channels);
+		processPlugins_(plugins, workBuf, emptyEvents_);
 	}
 	else
 	{
-		audioBuffer_.clear();
-		processPlugins_(plugins, *events);
+		workBuf.clear();
+		processPlugins_(plugins, workBuf, *events);
+		events->clear();
 	}
-	juceToGiadaOutBuf_(outBuf);
+
+	/* A note for the future: if we overwrite (as we do now) it's SEND, if we
+	add it's INSERT. */
+
+	dsp::interleave(workBuf.getArrayOfReadPointers(), outBuf[0], frames, channels);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -205,9 +243,31 @@ std::vector<Plugin*> clonePlugins(const std::vector<Plugin*>& plugins)
 
 /* -------------------------------------------------------------------------- */
 
-void setPluginParameter(ID pluginId, int paramIndex, float value)
+void setPluginParameter(ID pluginId, int paramIndex, float value, Thread t)
+{
+	Plugin* plugin = model::find<Plugin>(pluginId);
+	if (plugin == nullptr || !plugin->valid)
+		return;
+
+	/* No audio thread around to pick up the change: apply it right away. */
+
+	if (!model::get().mixer.state->active.load())
+	{
+		plugin->setParameter(paramIndex, value);
+		return;
+	}
+
+	plugin->enqueueParameter(paramIndex, value, /*delta=*/0, t);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void applyParameters(const std::vector<channel::Data>& channels)
 {
-	model::find<Plugin>(pluginId)->setParameter(paramIndex, value);
+	for (const channel::Data& ch : channels)
+		for (Plugin* p : ch.plugins)
+			if (p->valid)
+				p->applyParameters();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -231,6 +291,65 @@ void runDispatchLoop()
 {
 	messageManager_->runDispatchLoopUntil(10);
 }
+
+/* -------------------------------------------------------------------------- */
+
+void updateLatency()
+{
+	model::Layout& layout = model::get();
+
+	Frame maxLatency = 0;
+	for (const channel::Data& ch : layout.channels)
+		if (!ch.isInternal() && ch.type != ChannelType::GROUP)
+			maxLatency = std::max(maxLatency, getPathLatency_(layout, ch));
+	maxLatency = std::min(maxLatency, G_MAX_PLUGIN_LATENCY);
+
+	/* Group buses are not delayed: their inputs are already aligned by the
+	channels routed to them. */
+
+	for (const channel::Data& ch : layout.channels)
+		if (ch.type == ChannelType::GROUP)
+			ch.state->delay.store(0);
+		else if (!ch.isInternal())
+			ch.state->delay.store(std::max(0, maxLatency - getPathLatency_(layout, ch)));
+
+	const Frame latency = maxLatency + getLatency_(layout.getChannel(mixer::MASTER_OUT_CHANNEL_ID).plugins);
+
+	if (latency != layout.mixer.state->latency.load())
+	{
+		layout.mixer.state->latency.store(latency);
+		u::log::print("[pluginHost::updateLatency] plug-in latency changed: %d frames\n", latency);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void logStats()
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	if (now - lastLog_ < std::chrono::milliseconds(G_PLUGIN_METER_LOG_MS))
+		return;
+	lastLog_ = now;
+
+	for (const channel::Data& ch : model::get().channels)
+	{
+		const MidiStream::Stats m = ch.buffer->midiStream.takeStats();
+		if (m.dropped > 0 || m.coalesced > 0)
+			u::log::print(u::log::Level::WARN, "[pluginHost::logStats] channel=%d MIDI events dropped=%u coalesced=%u\n",
+			    ch.id, m.dropped, m.coalesced);
+
+		for (const Plugin* p : ch.plugins)
+		{
+			if (!p->valid)
+				continue;
+			const Plugin::Stats s = p->getStats();
+			u::log::print(u::log::Level::DBG, "[pluginHost::logStats] channel=%d plugin=%d '%s' avg=%.1fus (%.1f%%) peak=%.1fus (%.1f%%) latency=%d%s\n",
+			    ch.id, p->id, p->getName(), s.avgTime, s.avgLoad * 100.0f, s.peakTime,
+			    s.peakLoad * 100.0f, s.latency, s.idle ? " idle" : "");
+		}
+	}
+}
 } // namespace giada::m::pluginHost
 
 #endif // #ifdef WITH_VST
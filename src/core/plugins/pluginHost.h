@@ -41,6 +41,10 @@ namespace giada::m
 {
 class Plugin;
 } // namespace giada::m
+namespace giada::m::channel
+{
+struct Data;
+}
 namespace giada::m::pluginHost
 {
 struct Info : public juce::AudioPlayHead
@@ -51,7 +55,7 @@ struct Info : public juce::AudioPlayHead
 
 /* -------------------------------------------------------------------------- */
 
-void init(int buffersize);
+void init();
 void close();
 
 /* addPlugin
@@ -60,10 +64,13 @@ Adds a new plugin to channel 'channelId'. */
 void addPlugin(std::unique_ptr<Plugin> p, ID channelId);
 
 /* processStack
-Applies the fx list to the buffer. */
+Applies the fx list to the buffer. Plug-ins work on the planar 'workBuf', which
+must have the same size of 'outBuf'. Each stack owns its own work buffer, so
+stacks don't share any state. MIDI 'events', if any, are consumed and left
+empty afterwards. */
 
 void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-    juce::MidiBuffer* events = nullptr);
+    juce::AudioBuffer<float>& workBuf, juce::MidiBuffer* events = nullptr);
 
 /* swapPlugin 
 Swaps plug-in 1 with plug-in 2 in Channel 'channelId'. */
@@ -85,7 +92,19 @@ Clones all the plug-ins in the 'plugins' vector. */
 
 std::vector<Plugin*> clonePlugins(const std::vector<Plugin*>& plugins);
 
-void setPluginParameter(ID pluginId, int paramIndex, float value);
+/* setPluginParameter
+Schedules a parameter change from thread 't' (MAIN or MIDI). The change is 
+applied by the audio thread at the beginning of the next block. */
+
+void setPluginParameter(ID pluginId, int paramIndex, float value, Thread t);
+
+/* applyParameters
+Applies pending parameter changes of all plug-ins in 'channels'. Called by the 
+audio thread at the end of each block, for stacks that haven't been rendered 
+(e.g. Master In with no input): plug-ins processed in the block have empty 
+queues by then. */
+
+void applyParameters(const std::vector<channel::Data>& channels);
 void setPluginProgram(ID pluginId, int programIndex);
 void toggleBypass(ID pluginId);
 
@@ -93,6 +112,23 @@ void toggleBypass(ID pluginId);
 Wakes up plugins' GUI manager for N milliseconds. */
 
 void runDispatchLoop();
+
+/* updateLatency
+Computes the plug-in delay compensation for each channel: channels with a 
+faster plug-in stack are delayed to line up with the slowest one at the master
+bus. Plug-ins may change their latency at any time (e.g. a lookahead setting), 
+so this is meant to be polled rather than called on stack changes only. Also 
+updates the total latency, master out stack included. */
+
+void updateLatency();
+
+/* logStats
+Prints CPU usage and latency of all plug-ins to the log (debug level), plus 
+MIDI events dropped or coalesced on each channel since the last call (warning
+level). Rate-limited to once every G_PLUGIN_METER_LOG_MS, so it can be called 
+in a loop. */
+
+void logStats();
 } // namespace giada::m::pluginHost
 
 #endif
@@ -0,0 +1,252 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_VST
+
+#include "core/plugins/pluginLoader.h"
+#include "core/channels/channel.h"
+#include "core/const.h"
+#include "core/model/model.h"
+#include "core/plugins/plugin.h"
+#include "core/plugins/pluginHost.h"
+#include "core/plugins/pluginManager.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <vector>
+
+namespace giada::m::pluginLoader
+{
+namespace
+{
+/* Load
+A load request and its progress. The plug-in state, if stored in a file, is read
+in background by 'state' while the plug-in is being created. 'created' tells 
+whether the creation callback has run: a null 'plugin' then means that the 
+instantiation has failed. */
+
+struct Load
+{
+	ID                           id;
+	std::string                  pid;
+	std::optional<patch::Plugin> patch;
+	patch::Version               version;
+	std::future<PluginState>     state;
+	bool                         created = false;
+	std::unique_ptr<Plugin>      plugin;
+};
+
+/* loads_, generation_
+Main thread only, JUCE callbacks included. 'generation_' tells stale callbacks
+apart, i.e. the ones for loads requested before the last reset(). */
+
+std::vector<Load> loads_;
+int               generation_ = 0;
+
+/* -------------------------------------------------------------------------- */
+
+/* readState_
+Reads the state file of patch plug-in 'p', if any, in a separate thread. The 
+file can be big: no reason to keep the main thread busy with it. */
+
+std::future<PluginState> readState_(const std::optional<patch::Plugin>& p)
+{
+	if (!p || p->statePath.empty())
+		return {};
+	return std::async(std::launch::async, [path = p->statePath]() {
+		PluginState state = PluginState::fromFile(path);
+		state.getData(); // Force lazy loading
+		return state;
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool isReady_(const Load& l)
+{
+	if (!l.created)
+		return false;
+	return !l.state.valid() || l.state.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<Plugin> request_(std::unique_ptr<Plugin> placeholder, std::optional<patch::Plugin> p,
+    patch::Version version)
+{
+	if (placeholder == nullptr || !placeholder->isLoading())
+		return placeholder;
+
+	const ID          id         = placeholder->id;
+	const std::string pid        = placeholder->getUniqueId();
+	const int         generation = generation_;
+
+	loads_.push_back({id, pid, p, version, readState_(p)});
+
+	/* Plug-in creation and prepareToPlay() happen later on, in the JUCE message
+	loop pumped by update(). */
+
+	pluginManager::makeInstanceAsync(pid, id, [id, generation](std::unique_ptr<Plugin> plugin) {
+		if (generation != generation_)
+			return;
+		auto it = std::find_if(loads_.begin(), loads_.end(), [id](const Load& l) { return l.id == id; });
+		if (it == loads_.end())
+			return;
+		it->plugin  = std::move(plugin);
+		it->created = true;
+	});
+
+	return placeholder;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* install_
+Puts a loaded plug-in in place of its placeholder, in the model and in any 
+channel stack. Returns the replaced placeholder, or nullptr if the placeholder
+is gone in the meantime (e.g. removed by the user). */
+
+Plugin* install_(Load& r)
+{
+	Plugin* placeholder = model::find<Plugin>(r.id);
+	if (placeholder == nullptr || !placeholder->isLoading())
+		return nullptr;
+
+	/* A failed load turns into a regular missing plug-in, which keeps the
+	patch data of the placeholder. */
+
+	std::unique_ptr<Plugin> plugin = std::move(r.plugin);
+	if (plugin == nullptr)
+	{
+		u::log::print("[pluginLoader::install_] unable to load plugin with pid=%s\n", r.pid);
+		plugin               = std::make_unique<Plugin>(r.id, r.pid);
+		plugin->midiInParams = placeholder->midiInParams;
+		plugin->setState(placeholder->getState());
+	}
+	plugin->setBypass(placeholder->isBypassed());
+
+	model::add(std::move(plugin));
+	Plugin* loaded = &model::back<Plugin>();
+
+	for (channel::Data& ch : model::get().channels)
+		std::replace(ch.plugins.begin(), ch.plugins.end(), placeholder, loaded);
+
+	return placeholder;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void close()
+{
+	reset();
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<Plugin> load(int pluginListIndex)
+{
+	return request_(pluginManager::makePlaceholder(pluginListIndex), {}, {});
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<Plugin> load(const patch::Plugin& p, patch::Version version)
+{
+	std::unique_ptr<Plugin> placeholder = pluginManager::makePlaceholder(p.path, p.id);
+	pluginManager::restorePlugin(*placeholder, p, version);
+	return request_(std::move(placeholder), p, version);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void reset()
+{
+	loads_.clear();
+	generation_++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void update()
+{
+	/* JUCE delivers plug-in instances through its message loop, which runs 
+	only on demand here. */
+
+	if (std::any_of(loads_.begin(), loads_.end(), [](const Load& l) { return !l.created; }))
+		pluginHost::runDispatchLoop();
+
+	std::vector<Load> ready;
+	for (auto it = loads_.begin(); it != loads_.end();)
+	{
+		if (isReady_(*it))
+		{
+			ready.push_back(std::move(*it));
+			it = loads_.erase(it);
+		}
+		else
+			++it;
+	}
+
+	if (ready.empty())
+		return;
+
+	/* State restoring goes through the plug-in, on the main thread. The state 
+	file has been read already, if any. */
+
+	for (Load& l : ready)
+	{
+		if (l.plugin == nullptr || !l.patch)
+			continue;
+		if (l.state.valid())
+			pluginManager::restorePlugin(*l.plugin, *l.patch, l.version, l.state.get());
+		else
+			pluginManager::restorePlugin(*l.plugin, *l.patch, l.version);
+	}
+
+	std::vector<Plugin*> placeholders;
+	for (Load& l : ready)
+		if (Plugin* p = install_(l); p != nullptr)
+			placeholders.push_back(p);
+
+	if (placeholders.empty())
+		return;
+
+	/* Placeholders can be freed only once the audio thread has picked up the
+	new layout. */
+
+	model::swap(model::SwapType::HARD);
+	for (const Plugin* p : placeholders)
+		model::remove(*p);
+}
+} // namespace giada::m::pluginLoader
+
+#endif // #ifdef WITH_VST
@@ -0,0 +1,86 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_VST
+
+#ifndef G_PLUGIN_LOADER_H
+#define G_PLUGIN_LOADER_H
+
+#include "core/patch.h"
+#include <memory>
+
+namespace giada::m
+{
+class Plugin;
+}
+
+/* giada::m::pluginLoader
+Defers plug-in creation, so that the patch loading doesn't wait for it. JUCE 
+creates plug-ins on its message thread, i.e. the main one: requests are served 
+while update() runs the JUCE message loop. Note that VST and VST3 plug-ins are
+still created synchronously there, so a slow plug-in blocks the UI while it 
+loads. Only plug-in state files are read in background threads, in parallel with
+the creation. A placeholder Plugin is returned right away: it sits in the 
+channel stack as an invalid plug-in (i.e. never processed) and it is swapped 
+with the real instance once ready. All functions are main thread only. */
+
+namespace giada::m::pluginLoader
+{
+/* close
+Drops all pending loads. */
+
+void close();
+
+/* load (1)
+Returns a placeholder for the plug-in at 'pluginListIndex' in the list of
+available ones. Returns nullptr if the index is invalid. */
+
+std::unique_ptr<Plugin> load(int pluginListIndex);
+
+/* load (2)
+Returns a placeholder for a plug-in described in a patch. Patch data is applied
+to the real instance as well as to the placeholder, so that the latter can be
+saved back as is. */
+
+std::unique_ptr<Plugin> load(const patch::Plugin& p, patch::Version version);
+
+/* reset
+Drops all pending loads, e.g. when the current plug-ins are going away. */
+
+void reset();
+
+/* update
+Runs the JUCE message loop while loads are pending, then swaps placeholders 
+with the real plug-ins that are ready. Must be called periodically by the main
+thread. */
+
+void update();
+} // namespace giada::m::pluginLoader
+
+#endif
+
+#endif // #ifdef WITH_VST
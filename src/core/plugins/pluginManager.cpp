@@ -33,15 +33,33 @@
 #include "core/model/model.h"
 #include "core/patch.h"
 #include "core/plugins/plugin.h"
+#include "core/plugins/pluginScanner.h"
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "utils/string.h"
 #include <cassert>
+#include <map>
+#include <set>
 
 namespace giada::m::pluginManager
 {
 namespace
 {
+constexpr auto SCAN_CACHE_TAG = "GIADA_SCAN_CACHE";
+
+/* FileStamp
+Identifies a specific build of a plug-in file on disk. */
+
+struct FileStamp
+{
+	bool operator==(const FileStamp& o) const { return mtime == o.mtime && size == o.size; }
+
+	juce::int64 mtime;
+	juce::int64 size;
+};
+
+/* -------------------------------------------------------------------------- */
+
 IdManager pluginId_;
 
 int samplerate_;
@@ -67,12 +85,66 @@ If some plugins from any stack are missing. */
 
 bool missingPlugins_;
 
+/* scanCache_
+Files already scanned (crashed ones included), with their stamp at scan time.
+Stored alongside knownPluginList_ in plugins.xml. */
+
+std::map<std::string, FileStamp> scanCache_;
+
+/* -------------------------------------------------------------------------- */
+
 std::unique_ptr<Plugin> makeInvalidPlugin_(const std::string& pid, ID id)
 {
 	missingPlugins_ = true;
 	unknownPluginList_.push_back(pid);
 	return std::make_unique<Plugin>(pluginId_.generate(id), pid); // Invalid plug-in
 }
+
+/* -------------------------------------------------------------------------- */
+
+FileStamp makeFileStamp_(const std::string& path)
+{
+	/* Some formats (e.g. AudioUnit) use identifiers instead of paths. */
+
+	if (!juce::File::isAbsolutePath(path))
+		return {0, 0};
+
+	const juce::File f(path);
+	return {f.getLastModificationTime().toMilliseconds(), f.getSize()};
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* removeTypesForFile_
+Removes from knownPluginList_ all the plug-ins found in 'file'. A single file 
+might contain multiple plug-ins (e.g. shells). */
+
+void removeTypesForFile_(const std::string& file)
+{
+	for (const juce::PluginDescription& pd : knownPluginList_.getTypes())
+		if (pd.fileOrIdentifier.toStdString() == file)
+			knownPluginList_.removeType(pd);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* forgetMissingFiles_
+Drops plug-ins, blacklisted files and cache entries that are not part of the
+current search paths anymore. */
+
+void forgetMissingFiles_(const std::set<std::string>& files)
+{
+	for (const juce::PluginDescription& pd : knownPluginList_.getTypes())
+		if (files.count(pd.fileOrIdentifier.toStdString()) == 0)
+			knownPluginList_.removeType(pd);
+
+	for (const juce::String& f : knownPluginList_.getBlacklistedFiles())
+		if (files.count(f.toStdString()) == 0)
+			knownPluginList_.removeFromBlacklist(f);
+
+	for (auto it = scanCache_.begin(); it != scanCache_.end();)
+		it = files.count(it->first) == 0 ? scanCache_.erase(it) : std::next(it);
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -100,28 +172,60 @@ int scanDirs(const std::string& dirs, const std::function<void(float)>& cb)
 	u::log::print("[pluginManager::scanDir] requested directories: '%s'\n", dirs);
 	u::log::print("[pluginManager::scanDir] current plugins: %d\n", knownPluginList_.getNumTypes());
 
-	knownPluginList_.clear(); // clear up previous plugins
-
 	std::vector<std::string> dirVec = u::string::split(dirs, ";");
 
 	juce::FileSearchPath searchPath;
 	for (const std::string& dir : dirVec)
 		searchPath.add(juce::File(dir));
 
+	/* Collect all plug-in files in the search paths. Only new or changed ones
+	(i.e. not in the scan cache or with a different stamp) are scanned again. */
+
+	std::set<std::string>           files;
+	std::vector<pluginScanner::Job> jobs;
+	std::vector<FileStamp>          stamps;
+
 	for (int i = 0; i < formatManager_.getNumFormats(); i++)
 	{
+		juce::AudioPluginFormat* format = formatManager_.getFormat(i);
+		for (const juce::String& f : format->searchPathsForPlugins(searchPath, /*recursive=*/true))
+		{
+			const std::string file  = f.toStdString();
+			const FileStamp   stamp = makeFileStamp_(file);
 
-		juce::PluginDirectoryScanner scanner(knownPluginList_, *formatManager_.getFormat(i), searchPath,
-		    /*recursive=*/true, juce::File());
+			files.insert(file);
 
-		juce::String name;
-		while (scanner.scanNextFile(false, name))
-		{
-			u::log::print("[pluginManager::scanDir]   scanning '%s'\n", name.toRawUTF8());
-			cb(scanner.getProgress());
+			const auto it = scanCache_.find(file);
+			if (it != scanCache_.end() && it->second == stamp)
+				continue;
+
+			u::log::print("[pluginManager::scanDir]   scheduling '%s'\n", file);
+
+			removeTypesForFile_(file);
+			knownPluginList_.removeFromBlacklist(file);
+			jobs.push_back({format->getName().toStdString(), file});
+			stamps.push_back(stamp);
 		}
 	}
 
+	forgetMissingFiles_(files);
+
+	/* Merge results. Crashed files are blacklisted, yet cached: they won't be
+	scanned again until they change on disk. */
+
+	std::vector<pluginScanner::Result> results = pluginScanner::scan(jobs, cb);
+
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const pluginScanner::Result& r = results[i];
+		if (r.crashed)
+			knownPluginList_.addToBlacklist(r.file);
+		else
+			for (const juce::PluginDescription& pd : r.types)
+				knownPluginList_.addType(pd);
+		scanCache_[r.file] = stamps[i];
+	}
+
 	u::log::print("[pluginManager::scanDir] %d plugin(s) found\n", knownPluginList_.getNumTypes());
 	return knownPluginList_.getNumTypes();
 }
@@ -130,7 +234,18 @@ int scanDirs(const std::string& dirs, const std::function<void(float)>& cb)
 
 bool saveList(const std::string& filepath)
 {
-	bool out = knownPluginList_.createXml()->writeTo(juce::File(filepath));
+	std::unique_ptr<juce::XmlElement> elem = knownPluginList_.createXml();
+
+	juce::XmlElement* cache = elem->createNewChildElement(SCAN_CACHE_TAG);
+	for (const auto& [file, stamp] : scanCache_)
+	{
+		juce::XmlElement* e = cache->createNewChildElement("FILE");
+		e->setAttribute("path", juce::String(file));
+		e->setAttribute("mtime", juce::String(stamp.mtime));
+		e->setAttribute("size", juce::String(stamp.size));
+	}
+
+	bool out = elem->writeTo(juce::File(filepath));
 	if (!out)
 		u::log::print("[pluginManager::saveList] unable to save plugin list to %s\n", filepath);
 	return out;
@@ -144,6 +259,17 @@ bool loadList(const std::string& filepath)
 	if (elem == nullptr)
 		return false;
 	knownPluginList_.recreateFromXml(*elem);
+
+	scanCache_.clear();
+	if (const juce::XmlElement* cache = elem->getChildByName(SCAN_CACHE_TAG); cache != nullptr)
+		for (int i = 0; i < cache->getNumChildElements(); i++)
+		{
+			const juce::XmlElement* e = cache->getChildElement(i);
+			scanCache_[e->getStringAttribute("path").toStdString()] = {
+			    e->getStringAttribute("mtime").getLargeIntValue(),
+			    e->getStringAttribute("size").getLargeIntValue()};
+		}
+
 	return true;
 }
 
@@ -156,25 +282,98 @@ std::unique_ptr<Plugin> makePlugin(const std::string& pid, ID id)
 
 	pluginId_.set(id);
 
+	const ID                newId = pluginId_.generate(id);
+	std::unique_ptr<Plugin> p     = makeInstance(pid, newId);
+
+	if (p == nullptr)
+		return makeInvalidPlugin_(pid, newId);
+	return p;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<Plugin> makeInstance(const std::string& pid, ID id)
+{
 	const std::unique_ptr<juce::PluginDescription> pd = knownPluginList_.getTypeForIdentifierString(pid);
 	if (pd == nullptr)
 	{
-		u::log::print("[pluginManager::makePlugin] no plugin found with pid=%s!\n", pid);
-		return makeInvalidPlugin_(pid, id);
+		u::log::print("[pluginManager::makeInstance] no plugin found with pid=%s!\n", pid);
+		return nullptr;
 	}
 
 	juce::String                               error;
 	std::unique_ptr<juce::AudioPluginInstance> pi = formatManager_.createPluginInstance(*pd, samplerate_, buffersize_, error);
 	if (pi == nullptr)
 	{
-		u::log::print("[pluginManager::makePlugin] unable to create instance with pid=%s! Error: %s\n",
+		u::log::print("[pluginManager::makeInstance] unable to create instance with pid=%s! Error: %s\n",
 		    pid, error.toStdString());
+		return nullptr;
+	}
+
+	u::log::print("[pluginManager::makeInstance] plugin instance with pid=%s created\n", pid);
+
+	return std::make_unique<Plugin>(id, std::move(pi), samplerate_, buffersize_);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void makeInstanceAsync(const std::string& pid, ID id, std::function<void(std::unique_ptr<Plugin>)> f)
+{
+	const std::unique_ptr<juce::PluginDescription> pd = knownPluginList_.getTypeForIdentifierString(pid);
+	if (pd == nullptr)
+	{
+		u::log::print("[pluginManager::makeInstanceAsync] no plugin found with pid=%s!\n", pid);
+		f(nullptr);
+		return;
+	}
+
+	/* Sample rate and buffer size are copied now, as they might change before
+	the callback runs. */
+
+	const int samplerate = samplerate_;
+	const int buffersize = buffersize_;
+
+	formatManager_.createPluginInstanceAsync(*pd, samplerate, buffersize,
+	    [pid, id, samplerate, buffersize, f](std::unique_ptr<juce::AudioPluginInstance> pi, const juce::String& error) {
+		    if (pi == nullptr)
+		    {
+			    u::log::print("[pluginManager::makeInstanceAsync] unable to create instance with pid=%s! Error: %s\n",
+			        pid, error.toStdString());
+			    f(nullptr);
+			    return;
+		    }
+
+		    u::log::print("[pluginManager::makeInstanceAsync] plugin instance with pid=%s created\n", pid);
+
+		    f(std::make_unique<Plugin>(id, std::move(pi), samplerate, buffersize));
+	    });
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<Plugin> makePlaceholder(const std::string& pid, ID id)
+{
+	pluginId_.set(id);
+
+	if (knownPluginList_.getTypeForIdentifierString(pid) == nullptr)
+	{
+		u::log::print("[pluginManager::makePlaceholder] no plugin found with pid=%s!\n", pid);
 		return makeInvalidPlugin_(pid, id);
 	}
 
-	u::log::print("[pluginManager::makePlugin] plugin instance with pid=%s created\n", pid);
+	return std::make_unique<Plugin>(pluginId_.generate(id), pid, /*loading=*/true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<Plugin> makePlaceholder(int index)
+{
+	juce::PluginDescription pd = knownPluginList_.getTypes()[index];
+
+	if (pd.uniqueId == 0) // Invalid
+		return {};
 
-	return std::make_unique<Plugin>(pluginId_.generate(id), std::move(pi), samplerate_, buffersize_);
+	return makePlaceholder(pd.createIdentifierString().toStdString());
 }
 
 /* -------------------------------------------------------------------------- */
@@ -206,13 +405,31 @@ std::unique_ptr<Plugin> makePlugin(const Plugin& src)
 
 /* -------------------------------------------------------------------------- */
 
-const patch::Plugin serializePlugin(const Plugin& p)
+const patch::Plugin serializePlugin(const Plugin& p, const std::string& basePath)
 {
 	patch::Plugin pp;
 	pp.id     = p.id;
 	pp.path   = p.getUniqueId();
 	pp.bypass = p.isBypassed();
-	pp.state  = p.getState().asBase64();
+
+	/* States are stored as binary files, so that big ones (e.g. samplers) don't
+	bloat the patch. Same states share the same file, and a file already there
+	doesn't need to be written again. Fall back to the inline version if the
+	file can't be written. */
+
+	const PluginState state = p.getState();
+	if (state.getSize() > 0)
+	{
+		const std::string hash = state.getHash();
+		const std::string path = basePath + G_SLASH + hash + G_PLUGIN_STATE_EXT;
+		if (u::fs::fileExists(path) || state.save(path))
+			pp.stateHash = hash;
+		else
+		{
+			u::log::print("[pluginManager::serializePlugin] unable to write state to %s\n", path);
+			pp.state = state.asBase64();
+		}
+	}
 
 	for (const MidiLearnParam& param : p.midiInParams)
 		pp.midiInParams.push_back(param.getValue());
@@ -228,14 +445,32 @@ std::unique_ptr<Plugin> deserializePlugin(const patch::Plugin& p, patch::Version
 	if (!plugin->valid)
 		return plugin; // Return invalid version
 
+	restorePlugin(*plugin, p, version);
+	return plugin;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void restorePlugin(Plugin& plugin, const patch::Plugin& p, patch::Version version)
+{
+	restorePlugin(plugin, p, version, p.statePath.empty() ? PluginState(p.state) : PluginState::fromFile(p.statePath));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void restorePlugin(Plugin& plugin, const patch::Plugin& p, patch::Version version, PluginState state)
+{
 	/* Fill plug-in parameters. */
-	plugin->setBypass(p.bypass);
+	plugin.setBypass(p.bypass);
 
 	if (version < patch::Version{0, 17, 0}) // TODO - to be removed in 0.18.0
-		for (unsigned j = 0; j < p.params.size(); j++)
-			plugin->setParameter(j, p.params.at(j));
+	{
+		if (plugin.valid)
+			for (unsigned j = 0; j < p.params.size(); j++)
+				plugin.setParameter(j, p.params.at(j));
+	}
 	else
-		plugin->setState(PluginState(p.state));
+		plugin.setState(std::move(state));
 
 	/* Fill plug-in MidiIn parameters. Don't fill Plugin::midiInParam if 
 	Patch::midiInParams are zero: it would wipe out the current default 0x0
@@ -243,13 +478,28 @@ std::unique_ptr<Plugin> deserializePlugin(const patch::Plugin& p, patch::Version
 
 	if (!p.midiInParams.empty())
 	{
-		plugin->midiInParams.clear();
+		plugin.midiInParams.clear();
 		std::size_t paramIndex = 0;
 		for (uint32_t midiInParam : p.midiInParams)
-			plugin->midiInParams.emplace_back(midiInParam, paramIndex++);
+			plugin.midiInParams.emplace_back(midiInParam, paramIndex++);
 	}
+}
 
-	return plugin;
+/* -------------------------------------------------------------------------- */
+
+void removeUnusedStates(const std::string& basePath, const std::vector<patch::Plugin>& plugins)
+{
+	std::set<std::string> used;
+	for (const patch::Plugin& p : plugins)
+		if (!p.stateHash.empty())
+			used.insert(p.stateHash + G_PLUGIN_STATE_EXT);
+
+	const juce::Array<juce::File> files = juce::File(basePath).findChildFiles(
+	    juce::File::findFiles, /*searchRecursively=*/false, juce::String("*") + G_PLUGIN_STATE_EXT);
+
+	for (const juce::File& f : files)
+		if (used.count(f.getFileName().toStdString()) == 0)
+			f.deleteFile();
 }
 
 /* -------------------------------------------------------------------------- */
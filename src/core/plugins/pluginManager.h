@@ -31,6 +31,8 @@
 
 #include "deps/juce-config.h"
 #include "plugin.h"
+#include <functional>
+#include <memory>
 
 namespace giada::m::patch
 {
@@ -61,7 +63,9 @@ void init(int samplerate, int buffersize);
 
 /* scanDirs
 Parses plugin directories (semicolon-separated) and store list in 
-knownPluginList. The callback is called on each plugin found. Used to update the 
+knownPluginList. Scanning is incremental: only files new or changed since the
+last scan are probed, in parallel helper processes. Files that crash the helper
+are blacklisted. The callback is called on each file scanned. Used to update the 
 main window from the GUI thread. */
 
 int scanDirs(const std::string& paths, const std::function<void(float)>& cb);
@@ -86,13 +90,53 @@ std::unique_ptr<Plugin> makePlugin(const std::string& pid, ID id = 0);
 std::unique_ptr<Plugin> makePlugin(int index);
 std::unique_ptr<Plugin> makePlugin(const Plugin& other);
 
+/* makePlaceholder
+Returns an invalid Plugin in a 'loading' state, standing in for a plug-in to be
+created later on with makeInstance(). Returns a missing plug-in if 'pid' is 
+unknown. */
+
+std::unique_ptr<Plugin> makePlaceholder(const std::string& pid, ID id = 0);
+std::unique_ptr<Plugin> makePlaceholder(int index);
+
+/* makeInstance
+Creates and prepares a plug-in with the given, already generated ID. Returns 
+nullptr on failure. Main thread only: JUCE creates plug-ins on its message 
+thread. */
+
+std::unique_ptr<Plugin> makeInstance(const std::string& pid, ID id);
+
+/* makeInstanceAsync
+Asynchronous version of makeInstance(). The plug-in is created while the JUCE
+message loop runs (see pluginHost::runDispatchLoop()), then passed to callback 
+'f' on the main thread. Main thread only. */
+
+void makeInstanceAsync(const std::string& pid, ID id, std::function<void(std::unique_ptr<Plugin>)> f);
+
 /* (de)serializePlugin
-Transforms patch data into a Plugin object and vice versa. */
+Transforms patch data into a Plugin object and vice versa. The plug-in state is
+stored as a raw binary file in 'basePath', named after its hash. */
 
-const patch::Plugin     serializePlugin(const Plugin& p);
+const patch::Plugin     serializePlugin(const Plugin& p, const std::string& basePath);
 std::unique_ptr<Plugin> deserializePlugin(const patch::Plugin& p, patch::Version version);
 std::vector<Plugin*>    hydratePlugins(std::vector<ID> pluginIds);
 
+/* restorePlugin
+Fills an existing Plugin with bypass, state and MIDI learn data from patch. A 
+state stored in a binary file is read only when the plug-in actually needs it,
+i.e. never for placeholders. */
+
+void restorePlugin(Plugin& plugin, const patch::Plugin& p, patch::Version version);
+
+/* restorePlugin (2)
+Same as above, with state 'state' already read from the patch state file. */
+
+void restorePlugin(Plugin& plugin, const patch::Plugin& p, patch::Version version, PluginState state);
+
+/* removeUnusedStates
+Deletes binary state files in 'basePath' not referenced by 'plugins'. */
+
+void removeUnusedStates(const std::string& basePath, const std::vector<patch::Plugin>& plugins);
+
 /* getAvailablePluginInfo
 Returns the available plugin information (name, type, ...) given a plug-in
 index. */
@@ -0,0 +1,208 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_VST
+
+#include "core/plugins/pluginScanner.h"
+#include "core/const.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace giada::m::pluginScanner
+{
+namespace
+{
+constexpr auto RESULT_TAG = "GIADA_SCAN_RESULT";
+
+/* -------------------------------------------------------------------------- */
+
+/* readResult_
+Parses the XML file written by a helper process. Returns false if missing or
+malformed, i.e. the helper didn't make it to the end. */
+
+bool readResult_(const juce::File& f, Result& r)
+{
+	std::unique_ptr<juce::XmlElement> xml = juce::XmlDocument::parse(f);
+	if (xml == nullptr || !xml->hasTagName(RESULT_TAG))
+		return false;
+
+	for (int i = 0; i < xml->getNumChildElements(); i++)
+	{
+		juce::PluginDescription pd;
+		if (pd.loadFromXml(*xml->getChildElement(i)))
+			r.types.push_back(pd);
+	}
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* runJob_
+Spawns a helper process for 'job' and waits for it. Anything but a clean exit
+with a valid result file within G_PLUGIN_SCAN_TIMEOUT is considered a crash. */
+
+Result runJob_(const Job& job, const juce::File& outFile)
+{
+	Result r;
+	r.file = job.file;
+
+	const juce::String exe = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName();
+
+	juce::StringArray args;
+	args.add(exe);
+	args.add(G_PLUGIN_SCAN_ARG);
+	args.add(job.format);
+	args.add(job.file);
+	args.add(outFile.getFullPathName());
+
+	outFile.deleteFile();
+
+	juce::ChildProcess proc;
+	if (!proc.start(args, /*streamFlags=*/0))
+	{
+		u::log::print("[pluginScanner::runJob_] unable to start helper process for '%s'\n", job.file);
+		r.crashed = true;
+		return r;
+	}
+
+	if (!proc.waitForProcessToFinish(G_PLUGIN_SCAN_TIMEOUT))
+	{
+		u::log::print("[pluginScanner::runJob_] '%s' timed out\n", job.file);
+		proc.kill();
+		r.crashed = true;
+		return r;
+	}
+
+	r.crashed = proc.getExitCode() != EXIT_SUCCESS || !readResult_(outFile, r);
+	if (r.crashed)
+		u::log::print("[pluginScanner::runJob_] '%s' crashed while scanning\n", job.file);
+
+	outFile.deleteFile();
+	return r;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+std::vector<Result> scan(const std::vector<Job>& jobs, const std::function<void(float)>& cb)
+{
+	std::vector<Result> results(jobs.size());
+	if (jobs.empty())
+		return results;
+
+	const std::size_t numWorkers = std::min<std::size_t>(jobs.size(),
+	    std::max(1u, std::thread::hardware_concurrency()));
+
+	u::log::print("[pluginScanner::scan] scanning %zu file(s) with %zu helper(s)\n",
+	    jobs.size(), numWorkers);
+
+	std::atomic<std::size_t> next = 0;
+	std::size_t              done = 0;
+	std::mutex               mutex;
+	std::condition_variable  cond;
+
+	/* Each worker picks the next available job, runs it in a helper process and
+	stores the result in its own slot: no locking needed on 'results'. */
+
+	auto work = [&](std::size_t workerIndex) {
+		const juce::File outFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+		                               .getNonexistentChildFile("giada-scan-" + juce::String(workerIndex), ".xml");
+		for (std::size_t i = next++; i < jobs.size(); i = next++)
+		{
+			results[i] = runJob_(jobs[i], outFile);
+			std::scoped_lock lock(mutex);
+			done++;
+			cond.notify_one();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (std::size_t i = 0; i < numWorkers; i++)
+		workers.emplace_back(work, i);
+
+	/* Report progress from the calling thread, which is usually the GUI one. */
+
+	std::size_t reported = 0;
+	while (reported < jobs.size())
+	{
+		{
+			std::unique_lock lock(mutex);
+			cond.wait(lock, [&] { return done > reported; });
+			reported = done;
+		}
+		cb(reported / static_cast<float>(jobs.size()));
+	}
+
+	for (std::thread& w : workers)
+		w.join();
+
+	return results;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int runHelper(const std::string& format, const std::string& file, const std::string& outPath)
+{
+	/* The calling thread becomes the message thread: some plug-in formats need
+	one while being instantiated. */
+
+	juce::MessageManager::getInstance();
+
+	juce::AudioPluginFormatManager formatManager;
+	formatManager.addDefaultFormats();
+
+	juce::AudioPluginFormat* pluginFormat = nullptr;
+	for (int i = 0; i < formatManager.getNumFormats(); i++)
+		if (formatManager.getFormat(i)->getName() == juce::String(format))
+			pluginFormat = formatManager.getFormat(i);
+
+	if (pluginFormat == nullptr)
+		return EXIT_FAILURE;
+
+	juce::OwnedArray<juce::PluginDescription> types;
+	pluginFormat->findAllTypesForFile(types, file);
+
+	juce::XmlElement xml(RESULT_TAG);
+	for (const juce::PluginDescription* pd : types)
+		xml.addChildElement(pd->createXml().release());
+
+	const int res = xml.writeTo(juce::File(outPath)) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	juce::MessageManager::deleteInstance();
+	return res;
+}
+} // namespace giada::m::pluginScanner
+
+#endif // #ifdef WITH_VST
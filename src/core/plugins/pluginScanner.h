@@ -0,0 +1,75 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_VST
+
+#ifndef G_PLUGIN_SCANNER_H
+#define G_PLUGIN_SCANNER_H
+
+#include "deps/juce-config.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/* pluginScanner
+Probes plug-in binaries in a pool of helper processes, i.e. Giada itself 
+started with the G_PLUGIN_SCAN_ARG argument. A plug-in that crashes or hangs
+while being scanned only takes its own helper process down. */
+
+namespace giada::m::pluginScanner
+{
+struct Job
+{
+	std::string format; // Plug-in format name, e.g. "VST3"
+	std::string file;
+};
+
+struct Result
+{
+	std::string                          file;
+	bool                                 crashed = false;
+	std::vector<juce::PluginDescription> types   = {};
+};
+
+/* scan
+Runs all 'jobs' in parallel and returns their results in the same order. The 
+callback is invoked on the calling thread each time a job is done, with the 
+overall progress in [0.0, 1.0]. */
+
+std::vector<Result> scan(const std::vector<Job>& jobs, const std::function<void(float)>& cb);
+
+/* runHelper
+Entry point of the helper process: scans 'file' with the 'format' plug-in format
+and writes the plug-in descriptions found to the 'outPath' XML file. Returns the
+process exit code. */
+
+int runHelper(const std::string& format, const std::string& file, const std::string& outPath);
+} // namespace giada::m::pluginScanner
+
+#endif
+
+#endif // #ifdef WITH_VST
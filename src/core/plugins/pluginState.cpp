@@ -28,6 +28,8 @@
 
 #include "pluginState.h"
 #include "core/const.h"
+#include "utils/log.h"
+#include <cstdint>
 
 namespace giada::m
 {
@@ -47,8 +49,52 @@ PluginState::PluginState(const std::string& base64)
 
 /* -------------------------------------------------------------------------- */
 
+PluginState PluginState::fromFile(const std::string& path)
+{
+	PluginState state;
+	state.m_path = path;
+	return state;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PluginState::load() const
+{
+	if (m_path.empty())
+		return;
+	if (!juce::File(m_path).loadFileAsData(m_data))
+		u::log::print("[PluginState::load] unable to read plug-in state from %s\n", m_path);
+	m_path.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string PluginState::getHash() const
+{
+	/* 64-bit FNV-1a. Good enough to tell states apart, and way faster than any
+	cryptographic hash on multi-megabyte data. */
+
+	const auto* data = static_cast<const uint8_t*>(getData());
+	uint64_t    hash = 0xcbf29ce484222325;
+	for (size_t i = 0; i < getSize(); i++)
+		hash = (hash ^ data[i]) * 0x100000001b3;
+
+	return juce::String::toHexString(static_cast<juce::int64>(hash)).paddedLeft('0', 16).toStdString();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool PluginState::save(const std::string& path) const
+{
+	load();
+	return juce::File(path).replaceWithData(m_data.getData(), m_data.getSize());
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::string PluginState::asBase64() const
 {
+	load();
 	return m_data.toBase64Encoding().toStdString();
 }
 
@@ -56,11 +102,13 @@ std::string PluginState::asBase64() const
 
 const void* PluginState::getData() const
 {
+	load();
 	return m_data.getData();
 }
 
 size_t PluginState::getSize() const
 {
+	load();
 	return m_data.getSize();
 }
 } // namespace giada::m
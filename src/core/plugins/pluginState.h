@@ -41,12 +41,39 @@ public:
 	PluginState(juce::MemoryBlock&& data);
 	PluginState(const std::string& base64);
 
+	/* fromFile
+	Returns a state backed by the raw binary file 'path'. The file is read 
+	lazily, the first time data is accessed. */
+
+	static PluginState fromFile(const std::string& path);
+
+	/* getHash
+	Returns a hex string that identifies the content. Used as file name when 
+	storing the state. */
+
+	std::string getHash() const;
+
+	/* save
+	Writes data to 'path' as raw binary file. */
+
+	bool save(const std::string& path) const;
+
 	std::string asBase64() const;
 	const void* getData() const;
 	size_t      getSize() const;
 
 private:
-	juce::MemoryBlock m_data;
+	/* load
+	Reads data from m_path, if any. */
+
+	void load() const;
+
+	/* m_data, m_path
+	Data is loaded from file on demand, hence the 'mutable'. An empty m_path
+	means the data is already there. */
+
+	mutable juce::MemoryBlock m_data;
+	mutable std::string       m_path;
 };
 } // namespace giada::m
 
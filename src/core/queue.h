@@ -27,13 +27,15 @@
 #ifndef G_QUEUE_H
 #define G_QUEUE_H
 
+#include "core/const.h"
 #include <array>
 #include <atomic>
 
 namespace giada::m
 {
 /* Queue
-Single producer, single consumer lock-free queue. */
+Single producer, single consumer lock-free queue. Head and tail live on separate
+cache lines, so that producer and consumer don't invalidate each other's. */
 
 template <typename T, std::size_t size>
 class Queue
@@ -80,9 +82,9 @@ private:
 		return (i + 1) % size;
 	}
 
-	std::array<T, size>      m_data;
-	std::atomic<std::size_t> m_head;
-	std::atomic<std::size_t> m_tail;
+	std::array<T, size>                                 m_data;
+	alignas(G_CACHE_LINE_SIZE) std::atomic<std::size_t> m_head;
+	alignas(G_CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail;
 };
 } // namespace giada::m
 
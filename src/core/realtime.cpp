@@ -0,0 +1,162 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/realtime.h"
+#include "core/conf.h"
+#include "core/const.h"
+#include "utils/log.h"
+#ifdef __linux__
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace giada::m::realtime
+{
+namespace
+{
+struct Settings_
+{
+	int priority = 0;
+	int cpu      = -1;
+};
+
+Settings_ audio_;
+Settings_ midi_;
+Settings_ dispatcher_;
+bool      memoryLocked_ = false;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __linux__
+
+const Settings_& getSettings_(ThreadRole role)
+{
+	switch (role)
+	{
+	case ThreadRole::AUDIO:
+		return audio_;
+	case ThreadRole::MIDI:
+		return midi_;
+	default:
+		return dispatcher_;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* prefaultStack_
+Touches one byte per page of a big stack frame, so that the pages get mapped 
+now instead of on the first deep call in a time-critical moment. */
+
+[[gnu::noinline]] void prefaultStack_()
+{
+	[[maybe_unused]] volatile char stack[G_RT_STACK_PREFAULT];
+	for (int i = 0; i < G_RT_STACK_PREFAULT; i += 4096)
+		stack[i] = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setPriority_(int priority)
+{
+	sched_param param;
+	param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+
+	if (const int res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); res != 0)
+		u::log::print(u::log::Level::WARN, "[realtime] can't set priority %d: %s\n", priority, std::strerror(res));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setAffinity_(int cpu)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+
+	if (const int res = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); res != 0)
+		u::log::print(u::log::Level::WARN, "[realtime] can't pin thread to CPU %d: %s\n", cpu, std::strerror(res));
+}
+
+#endif
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init(const conf::Conf& c)
+{
+	audio_      = {c.rtPriorityAudio, c.rtCpuAudio};
+	midi_       = {c.rtPriorityMidi, c.rtCpuMidi};
+	dispatcher_ = {c.rtPriorityDispatcher, c.rtCpuDispatcher};
+
+	if (!c.rtMemoryLock)
+		return;
+
+#ifdef __linux__
+
+	/* MCL_FUTURE: memory allocated later (e.g. Wave buffers) is locked too, and
+	faulted in right away. */
+
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+	{
+		memoryLocked_ = true;
+		u::log::print("[realtime] memory locked\n");
+	}
+	else
+		u::log::print(u::log::Level::WARN, "[realtime] can't lock memory: %s\n", std::strerror(errno));
+
+#else
+
+	u::log::print(u::log::Level::WARN, "[realtime] memory locking not supported\n");
+
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setupThread([[maybe_unused]] ThreadRole role)
+{
+#ifdef __linux__
+
+	const Settings_& s = getSettings_(role);
+
+	if (s.priority > 0)
+		setPriority_(s.priority);
+	if (s.cpu >= 0)
+		setAffinity_(s.cpu);
+	if (memoryLocked_)
+		prefaultStack_();
+
+#endif
+}
+} // namespace giada::m::realtime
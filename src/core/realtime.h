@@ -0,0 +1,64 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_REALTIME_H
+#define G_REALTIME_H
+
+namespace giada::m::conf
+{
+struct Conf;
+}
+
+/* giada::m::realtime
+Scheduling settings for time-critical threads: real-time priority, CPU affinity
+(e.g. to pin them to cores isolated with 'isolcpus') and memory locking, to 
+avoid page faults. All optional, driven by the configuration. Linux only: a 
+no-op elsewhere. */
+
+namespace giada::m::realtime
+{
+enum class ThreadRole
+{
+	AUDIO,
+	MIDI,
+	DISPATCHER
+};
+
+/* init
+Stores settings and locks all current and future process memory, if required.
+Call it at startup, before starting any thread. */
+
+void init(const conf::Conf& c);
+
+/* setupThread
+Applies priority and CPU affinity for 'role' to the calling thread, and 
+prefaults its stack if memory is locked. Call it once, from the thread itself. */
+
+void setupThread(ThreadRole role);
+} // namespace giada::m::realtime
+
+#endif
@@ -135,7 +135,7 @@ void updateBpm(float ratio, int quantizerStep)
 		quantizer set to 44100. That would mean two recs completely useless. So we 
 		compute a reject value ('delta'): if it's lower than 6 frames the new frame 
 		is collapsed with a quantized frame. FIXME - maybe 6 frames are too low. */
-		Frame frame = static_cast<Frame>(old * ratio);
+		Frame frame = static_cast<Frame>(std::lround(old * ratio));
 		if (frame != 0)
 		{
 			Frame delta = quantizerStep % frame;
@@ -25,8 +25,11 @@
  * -------------------------------------------------------------------------- */
 
 #include "core/resampler.h"
+#include "core/dsp.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <new>
 #include <utility>
 
@@ -34,13 +37,142 @@
 
 namespace giada::m
 {
+namespace
+{
+/* FIR_TAPS, FIR_PHASES
+Size of the polyphase FIR used by Quality::BUILTIN_FIR: FIR_TAPS coefficients
+for each one of the FIR_PHASES + 1 fractional positions in [0.0, 1.0]. */
+
+constexpr int FIR_TAPS   = 8;
+constexpr int FIR_PHASES = 256;
+
+/* FIR_CUTOFF
+Cutoff frequency of the FIR, relative to Nyquist. */
+
+constexpr double FIR_CUTOFF = 0.9;
+
+/* -------------------------------------------------------------------------- */
+
+/* makeFirTable_
+Builds a Blackman-windowed sinc for each phase. Coefficients are normalized to
+unity gain at DC. */
+
+std::vector<float> makeFirTable_()
+{
+	const double pi = std::acos(-1.0);
+
+	std::vector<float> table((FIR_PHASES + 1) * FIR_TAPS);
+
+	for (int p = 0; p <= FIR_PHASES; p++)
+	{
+		const double frac = p / static_cast<double>(FIR_PHASES);
+		double       sum  = 0.0;
+		double       coeffs[FIR_TAPS];
+
+		for (int t = 0; t < FIR_TAPS; t++)
+		{
+			/* Tap 't' reads frame 'i - 3 + t', 'x' is its distance from the
+			current read position 'i + frac'. */
+
+			const double x      = (t - (FIR_TAPS / 2 - 1)) - frac;
+			const double sinc   = x == 0.0 ? 1.0 : std::sin(pi * x * FIR_CUTOFF) / (pi * x * FIR_CUTOFF);
+			const double window = 0.42 + 0.5 * std::cos(pi * x / (FIR_TAPS / 2)) + 0.08 * std::cos(2 * pi * x / (FIR_TAPS / 2));
+
+			coeffs[t] = std::abs(x) >= FIR_TAPS / 2 ? 0.0 : sinc * window;
+			sum += coeffs[t];
+		}
+		for (int t = 0; t < FIR_TAPS; t++)
+			table[(p * FIR_TAPS) + t] = static_cast<float>(coeffs[t] / sum);
+	}
+	return table;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const std::vector<float>& getFirTable_()
+{
+	static const std::vector<float> table = makeFirTable_();
+	return table;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(G_DSP_SSE2)
+
+/* loadFrames_
+Loads two stereo frames 'a' and 'b' into a single vector [La, Ra, Lb, Rb]. */
+
+__m128 loadFrames_(const float* a, const float* b)
+{
+	__m128 v = _mm_setzero_ps();
+	v        = _mm_loadl_pi(v, reinterpret_cast<const __m64*>(a));
+	v        = _mm_loadh_pi(v, reinterpret_cast<const __m64*>(b));
+	return v;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* interpolate2Stereo_
+Computes two consecutive stereo output frames at once, at fractional positions
+'fa' and 'fb' of stereo input frames 'a' and 'b' respectively. */
+
+void interpolate2Stereo_(Resampler::Quality q, const float* a, float fa,
+    const float* b, float fb, float* output)
+{
+	const __m128 frac = _mm_setr_ps(fa, fa, fb, fb);
+	const __m128 x0   = loadFrames_(a, b);
+	const __m128 x1   = loadFrames_(a + 2, b + 2);
+
+	if (q == Resampler::Quality::BUILTIN_LINEAR)
+	{
+		_mm_storeu_ps(output, _mm_add_ps(x0, _mm_mul_ps(frac, _mm_sub_ps(x1, x0))));
+		return;
+	}
+
+	/* Cubic Hermite (Catmull-Rom). */
+
+	const __m128 xm1  = loadFrames_(a - 2, b - 2);
+	const __m128 x2   = loadFrames_(a + 4, b + 4);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	const __m128 c1 = _mm_mul_ps(half, _mm_sub_ps(x1, xm1));
+	const __m128 c2 = _mm_sub_ps(
+	    _mm_add_ps(xm1, _mm_add_ps(x1, x1)),
+	    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.5f), x0), _mm_mul_ps(half, x2)));
+	const __m128 c3 = _mm_add_ps(
+	    _mm_mul_ps(half, _mm_sub_ps(x2, xm1)),
+	    _mm_mul_ps(_mm_set1_ps(1.5f), _mm_sub_ps(x0, x1)));
+
+	__m128 y = _mm_add_ps(_mm_mul_ps(c3, frac), c2);
+	y        = _mm_add_ps(_mm_mul_ps(y, frac), c1);
+	y        = _mm_add_ps(_mm_mul_ps(y, frac), x0);
+
+	_mm_storeu_ps(output, y);
+}
+#endif
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool Resampler::isBuiltin(Quality q)
+{
+	return q == Quality::BUILTIN_LINEAR || q == Quality::BUILTIN_HERMITE || q == Quality::BUILTIN_FIR;
+}
+
+/* -------------------------------------------------------------------------- */
+
 Resampler::Resampler()
 : m_state(nullptr)
+, m_quality(Quality::SINC_BEST)
 , m_input(nullptr)
 , m_inputPos(0)
 , m_inputLength(0)
 , m_channels(0)
 , m_usedFrames(0)
+, m_position(0.0)
+, m_fir(nullptr)
 {
 }
 
@@ -114,7 +246,7 @@ long Resampler::callback(float** audio)
 {
 	assert(audio != nullptr);
 
-	/* Move pointer properly, taking into account read data and number of 
+	/* Move pointer properly, taking into account read data and number of
 	channels in input data. */
 
 	*audio = m_input + (m_inputPos * m_channels);
@@ -142,9 +274,20 @@ void Resampler::alloc(Quality quality, int channels)
 {
 	if (m_state != nullptr)
 		src_delete(m_state);
-	m_state    = src_callback_new(callback, static_cast<int>(quality), channels, nullptr, this);
+	m_state    = nullptr;
 	m_quality  = quality;
 	m_channels = channels;
+
+	if (isBuiltin(quality))
+	{
+		m_history.assign(HISTORY * channels, 0.0f);
+		m_window.assign((HISTORY + 1 + LOOKAHEAD) * channels, 0.0f);
+		m_fir      = getFirTable_().data();
+		m_position = 0.0;
+		return;
+	}
+
+	m_state = src_callback_new(callback, static_cast<int>(quality), channels, nullptr, this);
 	if (m_state == nullptr)
 		throw std::bad_alloc();
 	src_reset(m_state);
@@ -155,6 +298,9 @@ void Resampler::alloc(Quality quality, int channels)
 Resampler::Result Resampler::process(float* input, long inputPos, long inputLength,
     float* output, long outputLength, float ratio)
 {
+	if (isBuiltin(m_quality))
+		return processBuiltin(input, inputPos, inputLength, output, outputLength, ratio);
+
 	assert(m_state != nullptr); // Must be initialized first!
 
 	m_input       = input;
@@ -169,8 +315,180 @@ Resampler::Result Resampler::process(float* input, long inputPos, long inputLeng
 
 /* -------------------------------------------------------------------------- */
 
+Resampler::Result Resampler::processBuiltin(const float* input, long inputPos,
+    long inputLength, float* output, long outputLength, float ratio)
+{
+	assert(!m_history.empty()); // Must be initialized first!
+
+	/* Positions are relative to the first frame of this chunk. Frames before
+	it come from history, frames past the end are silence. */
+
+	const float* in        = input + (inputPos * m_channels);
+	const long   available = inputLength - inputPos;
+	double       pos       = m_position;
+	long         generated = 0;
+
+	while (generated < outputLength)
+	{
+		const long i = static_cast<long>(pos);
+		if (i >= available)
+			break;
+
+#if defined(G_DSP_SSE2)
+		/* Fast path: two stereo frames at once, when all neighbours are
+		available straight from input. */
+
+		if (m_channels == 2 && m_quality != Quality::BUILTIN_FIR && generated + 2 <= outputLength)
+		{
+			const double next = pos + ratio;
+			const long   j    = static_cast<long>(next);
+			if (i >= HISTORY && j + LOOKAHEAD < available)
+			{
+				interpolate2Stereo_(m_quality, in + (i * 2), static_cast<float>(pos - i),
+				    in + (j * 2), static_cast<float>(next - j), output + (generated * 2));
+				pos = next + ratio;
+				generated += 2;
+				continue;
+			}
+		}
+#endif
+		const bool   inside = i >= HISTORY && i + LOOKAHEAD < available;
+		const float* x      = inside ? in + (i * m_channels) : gather(in, available, i);
+
+		interpolate(x, static_cast<float>(pos - i), output + (generated * m_channels));
+
+		pos += ratio;
+		generated++;
+	}
+
+	const long used = std::min(static_cast<long>(pos), available);
+
+	updateHistory(in, used);
+	m_position = pos - used;
+
+	return {used, generated};
+}
+
+/* -------------------------------------------------------------------------- */
+
+const float* Resampler::gather(const float* input, long inputLength, long i)
+{
+	for (int k = 0; k < HISTORY + 1 + LOOKAHEAD; k++)
+	{
+		const long   f    = i - HISTORY + k;
+		float*       dest = m_window.data() + (k * m_channels);
+		const float* src  = f < 0 ? m_history.data() + ((HISTORY + f) * m_channels) : input + (f * m_channels);
+
+		if (f >= inputLength)
+			std::fill(dest, dest + m_channels, 0.0f);
+		else
+			std::copy(src, src + m_channels, dest);
+	}
+	return m_window.data() + (HISTORY * m_channels);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Resampler::interpolate(const float* x, float frac, float* output) const
+{
+	const int ch = m_channels;
+
+	switch (m_quality)
+	{
+	case Quality::BUILTIN_LINEAR:
+		for (int c = 0; c < ch; c++)
+			output[c] = x[c] + (frac * (x[ch + c] - x[c]));
+		break;
+
+	case Quality::BUILTIN_HERMITE:
+		for (int c = 0; c < ch; c++)
+		{
+			const float xm1 = x[-ch + c];
+			const float x0  = x[c];
+			const float x1  = x[ch + c];
+			const float x2  = x[(2 * ch) + c];
+			const float c1  = 0.5f * (x1 - xm1);
+			const float c2  = xm1 - (2.5f * x0) + (2.0f * x1) - (0.5f * x2);
+			const float c3  = (0.5f * (x2 - xm1)) + (1.5f * (x0 - x1));
+			output[c]       = (((((c3 * frac) + c2) * frac) + c1) * frac) + x0;
+		}
+		break;
+
+	case Quality::BUILTIN_FIR:
+	{
+		const float* coeffs = m_fir + (std::lround(frac * FIR_PHASES) * FIR_TAPS);
+		const float* first  = x - (HISTORY * ch);
+#if defined(G_DSP_SSE2)
+		if (ch == 2)
+		{
+			/* Each vector holds two stereo frames, coefficients are duplicated
+			accordingly: [c0, c0, c1, c1], ... Left and right channels are
+			summed separately at the end. */
+
+			const __m128 k03 = _mm_loadu_ps(coeffs);
+			const __m128 k47 = _mm_loadu_ps(coeffs + 4);
+
+			__m128 acc = _mm_mul_ps(_mm_loadu_ps(first), _mm_unpacklo_ps(k03, k03));
+			acc        = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(first + 4), _mm_unpackhi_ps(k03, k03)));
+			acc        = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(first + 8), _mm_unpacklo_ps(k47, k47)));
+			acc        = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(first + 12), _mm_unpackhi_ps(k47, k47)));
+			acc        = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+
+			_mm_storel_pi(reinterpret_cast<__m64*>(output), acc);
+			break;
+		}
+#endif
+		for (int c = 0; c < ch; c++)
+		{
+			float sum = 0.0f;
+			for (int t = 0; t < FIR_TAPS; t++)
+				sum += coeffs[t] * first[(t * ch) + c];
+			output[c] = sum;
+		}
+		break;
+	}
+
+	default:
+		assert(false);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Resampler::updateHistory(const float* input, long used)
+{
+	float* history = m_history.data();
+
+	if (used >= HISTORY)
+	{
+		std::memcpy(history, input + ((used - HISTORY) * m_channels), HISTORY * m_channels * sizeof(float));
+		return;
+	}
+
+	/* Not enough new frames: shift old history, then append. */
+
+	const long keep = HISTORY - used;
+	std::memmove(history, history + (used * m_channels), keep * m_channels * sizeof(float));
+	std::memcpy(history + (keep * m_channels), input, used * m_channels * sizeof(float));
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Resampler::last()
 {
+	if (isBuiltin(m_quality))
+	{
+		std::fill(m_history.begin(), m_history.end(), 0.0f);
+		m_position = 0.0;
+		return;
+	}
 	src_reset(m_state);
 }
+
+/* -------------------------------------------------------------------------- */
+
+Resampler::Quality Resampler::getQuality() const
+{
+	return m_quality;
+}
 } // namespace giada::m
@@ -29,6 +29,7 @@
 
 #include <cstddef>
 #include <samplerate.h>
+#include <vector>
 
 namespace giada::m
 {
@@ -41,11 +42,21 @@ public:
 		SINC_MEDIUM     = 1,
 		SINC_FASTEST    = 2,
 		ZERO_ORDER_HOLD = 3,
-		LINEAR          = 4
+		LINEAR          = 4,
+		BUILTIN_LINEAR  = 5,
+		BUILTIN_HERMITE = 6,
+		BUILTIN_FIR     = 7
 	};
 
+	/* isBuiltin
+	True if 'q' is one of the built-in interpolators, i.e. not provided by
+	libsamplerate. Built-in interpolators are much cheaper and keep their state
+	across process() calls without any internal buffering. */
+
+	static bool isBuiltin(Quality q);
+
 	/* Result
-	A Result object is returned by the process() function below, containing the 
+	A Result object is returned by the process() function below, containing the
 	number of frames used from input and generated to output. */
 
 	struct Result
@@ -73,6 +84,8 @@ public:
 
 	void last();
 
+	Quality getQuality() const;
+
 private:
 	static long callback(void* self, float** audio);
 	long        callback(float** audio);
@@ -84,6 +97,37 @@ private:
 
 	static constexpr int CHUNK_LEN = 256;
 
+	/* HISTORY, LOOKAHEAD
+	Frames needed by built-in interpolators before and after the current read
+	position. Sized for the widest kernel, i.e. the 8-taps FIR. */
+
+	static constexpr int HISTORY   = 3;
+	static constexpr int LOOKAHEAD = 4;
+
+	/* processBuiltin
+	Same as process(), for built-in interpolators. */
+
+	Result processBuiltin(const float* input, long inputPos, long inputLength,
+	    float* output, long outputLength, float ratio);
+
+	/* gather
+	Copies the frames around frame 'i' of 'input' into m_window, taking them
+	from history before the beginning and using silence past the end. Returns a
+	pointer to frame 'i' in m_window. */
+
+	const float* gather(const float* input, long inputLength, long i);
+
+	/* interpolate
+	Computes one output frame from frame 'x' plus neighbours, at fractional
+	position 'frac'. */
+
+	void interpolate(const float* x, float frac, float* output) const;
+
+	/* updateHistory
+	Saves the HISTORY frames that come before frame 'used' of 'input'. */
+
+	void updateHistory(const float* input, long used);
+
 	SRC_STATE* m_state;
 	Quality    m_quality;
 	float*     m_input;       // Pointer to input data
@@ -91,6 +135,13 @@ private:
 	long       m_inputLength; // Total number of frames in input data
 	int        m_channels;    // Number of channels
 	long       m_usedFrames;  // How many frames have been read from input with a process() call
+
+	/* Built-in interpolators state. */
+
+	double             m_position; // Read position, relative to the next input chunk
+	std::vector<float> m_history;  // Last HISTORY frames of the previous chunk
+	std::vector<float> m_window;   // Scratch frames for gather()
+	const float*       m_fir;      // FIR coefficients table
 };
 } // namespace giada::m
 
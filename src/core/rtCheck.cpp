@@ -0,0 +1,259 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_RT_CHECK
+
+#include "core/rtCheck.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+
+/* glibc's own allocator entry points: the interceptors below forward to them 
+directly, as dlsym() itself may allocate memory. */
+
+extern "C"
+{
+	void* __libc_malloc(size_t);
+	void* __libc_calloc(size_t, size_t);
+	void* __libc_realloc(void*, size_t);
+	void* __libc_memalign(size_t, size_t);
+	void  __libc_free(void*);
+}
+
+namespace giada::m::rtCheck
+{
+namespace
+{
+constexpr unsigned MAX_REPORTS_ = 32;
+constexpr int      MAX_FRAMES_  = 32;
+
+/* depth_, reporting_
+Per-thread state. 'reporting_' is set while a violation is being reported, so
+that calls made by the reporter itself (backtrace() may allocate) are let 
+through. */
+
+thread_local int  depth_     = 0;
+thread_local bool reporting_ = false;
+
+std::atomic<unsigned> violations_ = 0;
+
+/* -------------------------------------------------------------------------- */
+
+void write_(const char* s)
+{
+	[[maybe_unused]] ssize_t res = ::write(STDERR_FILENO, s, std::strlen(s));
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Scope::Scope() { depth_++; }
+Scope::~Scope() { depth_--; }
+
+/* -------------------------------------------------------------------------- */
+
+void check(const char* what)
+{
+	if (depth_ == 0 || reporting_)
+		return;
+
+	reporting_ = true;
+
+	const unsigned count = violations_.fetch_add(1) + 1;
+	if (count <= MAX_REPORTS_)
+	{
+		write_("[rtCheck] ");
+		write_(what);
+		write_(" called on a real-time thread\n");
+
+		void*     frames[MAX_FRAMES_];
+		const int size = backtrace(frames, MAX_FRAMES_);
+		backtrace_symbols_fd(frames, size, STDERR_FILENO);
+
+		if (count == MAX_REPORTS_)
+			write_("[rtCheck] too many violations, reporting stopped\n");
+	}
+
+	reporting_ = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned countViolations()
+{
+	return violations_.load();
+}
+} // namespace giada::m::rtCheck
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+namespace
+{
+/* next_
+Returns the next definition of function 'name' (i.e. the libc one), looked up
+once and cached in 'f'. */
+
+template <typename F>
+F next_(std::atomic<F>& f, const char* name)
+{
+	F out = f.load(std::memory_order_relaxed);
+	if (out == nullptr)
+	{
+		out = reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+		f.store(out, std::memory_order_relaxed);
+	}
+	return out;
+}
+
+std::atomic<int (*)(pthread_mutex_t*)>                         mutexLock_    = nullptr;
+std::atomic<int (*)(pthread_rwlock_t*)>                        rwlockRdLock_ = nullptr;
+std::atomic<int (*)(pthread_rwlock_t*)>                        rwlockWrLock_ = nullptr;
+std::atomic<int (*)(pthread_cond_t*, pthread_mutex_t*)>        condWait_     = nullptr;
+std::atomic<int (*)(pthread_t, void**)>                        join_         = nullptr;
+std::atomic<int (*)(sem_t*)>                                   semWait_      = nullptr;
+std::atomic<int (*)(const struct timespec*, struct timespec*)> nanosleep_    = nullptr;
+std::atomic<int (*)(useconds_t)>                               usleep_       = nullptr;
+std::atomic<FILE* (*)(const char*, const char*)>               fopen_        = nullptr;
+} // namespace
+
+using giada::m::rtCheck::check;
+
+/* Interceptors. They replace the libc functions for the whole executable. */
+
+extern "C"
+{
+	/* Memory. */
+
+	void* malloc(size_t size) noexcept
+	{
+		check("malloc()");
+		return __libc_malloc(size);
+	}
+
+	void* calloc(size_t n, size_t size) noexcept
+	{
+		check("calloc()");
+		return __libc_calloc(n, size);
+	}
+
+	void* realloc(void* p, size_t size) noexcept
+	{
+		check("realloc()");
+		return __libc_realloc(p, size);
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) noexcept
+	{
+		check("aligned_alloc()");
+		return __libc_memalign(alignment, size);
+	}
+
+	int posix_memalign(void** p, size_t alignment, size_t size) noexcept
+	{
+		check("posix_memalign()");
+		*p = __libc_memalign(alignment, size);
+		return *p != nullptr ? 0 : ENOMEM;
+	}
+
+	void free(void* p) noexcept
+	{
+		if (p != nullptr)
+			check("free()");
+		__libc_free(p);
+	}
+
+	/* Locks. */
+
+	int pthread_mutex_lock(pthread_mutex_t* m) noexcept
+	{
+		check("pthread_mutex_lock()");
+		return next_(mutexLock_, "pthread_mutex_lock")(m);
+	}
+
+	int pthread_rwlock_rdlock(pthread_rwlock_t* l) noexcept
+	{
+		check("pthread_rwlock_rdlock()");
+		return next_(rwlockRdLock_, "pthread_rwlock_rdlock")(l);
+	}
+
+	int pthread_rwlock_wrlock(pthread_rwlock_t* l) noexcept
+	{
+		check("pthread_rwlock_wrlock()");
+		return next_(rwlockWrLock_, "pthread_rwlock_wrlock")(l);
+	}
+
+	/* Blocking calls. */
+
+	int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m)
+	{
+		check("pthread_cond_wait()");
+		return next_(condWait_, "pthread_cond_wait")(c, m);
+	}
+
+	int pthread_join(pthread_t t, void** res)
+	{
+		check("pthread_join()");
+		return next_(join_, "pthread_join")(t, res);
+	}
+
+	int sem_wait(sem_t* s)
+	{
+		check("sem_wait()");
+		return next_(semWait_, "sem_wait")(s);
+	}
+
+	int nanosleep(const struct timespec* req, struct timespec* rem)
+	{
+		check("nanosleep()");
+		return next_(nanosleep_, "nanosleep")(req, rem);
+	}
+
+	int usleep(useconds_t usec)
+	{
+		check("usleep()");
+		return next_(usleep_, "usleep")(usec);
+	}
+
+	FILE* fopen(const char* path, const char* mode)
+	{
+		check("fopen()");
+		return next_(fopen_, "fopen")(path, mode);
+	}
+}
+
+#endif // WITH_RT_CHECK
@@ -0,0 +1,79 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_RT_CHECK_H
+#define G_RT_CHECK_H
+
+/* giada::m::rtCheck
+Real-time safety checker, enabled by the WITH_RT_CHECK build option (Linux 
+only). Code running within a Scope must not allocate or free memory, lock 
+mutexes or make blocking calls: these are intercepted and reported on stderr,
+together with a stack trace. Without WITH_RT_CHECK all of this costs nothing. */
+
+namespace giada::m::rtCheck
+{
+#ifdef WITH_RT_CHECK
+
+/* Scope
+Marks the current thread as real-time until destroyed. Scopes can be nested. */
+
+class Scope
+{
+public:
+	Scope();
+	~Scope();
+
+	Scope(const Scope&) = delete;
+	Scope& operator=(const Scope&) = delete;
+};
+
+/* check
+Reports 'what' as a violation if called within a Scope. Used for non real-time
+safe code that can't be intercepted, e.g. model::get(). */
+
+void check(const char* what);
+
+/* countViolations
+Returns the number of violations detected so far, on any thread. */
+
+unsigned countViolations();
+
+#else
+
+class Scope
+{
+public:
+	Scope() {}
+};
+
+inline void     check(const char*) {}
+inline unsigned countViolations() { return 0; }
+
+#endif
+} // namespace giada::m::rtCheck
+
+#endif
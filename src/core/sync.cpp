@@ -28,7 +28,12 @@
 #include "core/conf.h"
 #include "core/kernelAudio.h"
 #include "core/kernelMidi.h"
+#include "core/midiClockFilter.h"
 #include "core/model/model.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
 
 namespace giada::m::sync
 {
@@ -43,9 +48,208 @@ int midiTCseconds_ = 0;
 int midiTCminutes_ = 0;
 int midiTChours_   = 0;
 
+/* clock*
+MIDI clock slave state, MIDI input thread only. 'clockTicks_' is the position
+of the last tick since the master started. 'clockBpm_' is the last tempo sent
+to the Event Dispatcher, 'clockNextBpm_' a different one waiting to be stable
+since 'clockNextSince_' (seconds) before being sent. */
+
+MidiClockFilter clockFilter_(G_MIDI_SYNC_BANDWIDTH);
+int             clockTicks_     = 0;
+bool            clockRunning_   = false;
+float           clockBpm_       = 0.0f;
+float           clockNextBpm_   = 0.0f;
+double          clockNextSince_ = -1.0;
+
+/* mtc*
+MTC slave state. Quarter frames (8 per timecode) are collected in 'mtcPieces_',
+'mtcMask_' tells which ones have been received so far. */
+
+int                 mtcPieces_[8] = {};
+int                 mtcMask_      = 0;
+std::atomic<bool>   mtcRunning_   = false;
+std::atomic<double> mtcLast_      = 0.0;
+
 #ifdef WITH_AUDIO_JACK
 JackTransport::State jackStatePrev_;
 #endif
+
+/* -------------------------------------------------------------------------- */
+
+/* pump_
+Sends a tempo or transport change to the Event Dispatcher: the model must not
+be touched from the MIDI input thread. */
+
+void pump_(eventDispatcher::EventType type, eventDispatcher::EventData data = {})
+{
+	eventDispatcher::pumpEvent({type, 0, 0, data});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* follow_
+Moves the playhead to 'frame' if it has drifted away from it. Small drifts are
+left to the tempo tracking. */
+
+void follow_(Frame frame)
+{
+	const model::Clock& c = model::get().clock;
+
+	if (c.framesInLoop <= 0)
+		return;
+
+	frame %= c.framesInLoop;
+
+	Frame drift = std::abs(c.state->currentFrame.load() - frame);
+	drift       = std::min(drift, c.framesInLoop - drift); // Across the loop end
+
+	if (drift > (G_MIDI_SYNC_MAX_DRIFT_MS * conf::conf.samplerate) / 1000)
+		pump_(eventDispatcher::EventType::MIDI_SYNC_RELOCATE, frame);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* followBpm_
+Sends tempo 'bpm' once it has stayed within tolerance for a while. Each change
+rescales recorded actions, so the jitter of a live master must not go through:
+rounding would slowly drift them apart. */
+
+void followBpm_(float bpm, double t)
+{
+	if (std::abs(bpm - clockBpm_) <= G_MIDI_SYNC_BPM_TOLERANCE)
+	{
+		clockNextSince_ = -1.0;
+		return;
+	}
+
+	if (clockNextSince_ < 0.0 || std::abs(bpm - clockNextBpm_) > G_MIDI_SYNC_BPM_TOLERANCE)
+	{
+		clockNextBpm_   = bpm;
+		clockNextSince_ = t;
+		return;
+	}
+
+	if (t - clockNextSince_ < G_MIDI_SYNC_BPM_SETTLE_MS / 1000.0)
+		return;
+
+	clockBpm_       = bpm;
+	clockNextSince_ = -1.0;
+	pump_(eventDispatcher::EventType::MIDI_SYNC_BPM, bpm);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void recvClock_(double t)
+{
+	clockFilter_.tick(t);
+
+	if (clockRunning_)
+		clockTicks_++;
+
+	if (!clockFilter_.isLocked())
+		return;
+
+	followBpm_(static_cast<float>(clockFilter_.getBpm()), t);
+
+	/* Phase correction on each beat. */
+
+	const model::Clock& c = model::get().clock;
+	if (clockRunning_ && clockTicks_ % G_MIDI_CLOCK_PPQN == 0)
+		follow_(((clockTicks_ / G_MIDI_CLOCK_PPQN) % c.beats) * c.framesInBeat);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void recvClockTransport_(int byte1, int byte2, int byte3)
+{
+	switch (byte1)
+	{
+	case MIDI_START: // The first tick after start is on beat 0
+		clockTicks_   = -1;
+		clockRunning_ = true;
+		pump_(eventDispatcher::EventType::MIDI_SYNC_RELOCATE, 0);
+		pump_(eventDispatcher::EventType::MIDI_SYNC_START);
+		break;
+
+	case MIDI_CONTINUE:
+		clockRunning_ = true;
+		pump_(eventDispatcher::EventType::MIDI_SYNC_START);
+		break;
+
+	case MIDI_STOP:
+		clockRunning_ = false;
+		pump_(eventDispatcher::EventType::MIDI_SYNC_STOP);
+		break;
+
+	case MIDI_POSITION_PTR: // Position in MIDI beats (16th notes, 6 ticks)
+	{
+		const int          beats = byte2 | (byte3 << 7);
+		const model::Clock& c    = model::get().clock;
+		clockTicks_              = beats * 6 - 1;
+		follow_(((beats % (c.beats * 4)) * c.framesInBeat) / 4);
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* recvQuarterFrame_
+Collects MTC quarter frames. A full timecode is available every 8 of them, 
+i.e. every 2 timecode frames. */
+
+void recvQuarterFrame_(int data, double t)
+{
+	const int piece = (data >> 4) & 0x07;
+
+	mtcPieces_[piece] = data & 0x0F;
+	mtcMask_ |= 1 << piece;
+	mtcLast_.store(t);
+
+	if (piece != 7 || mtcMask_ != 0xFF)
+		return;
+	mtcMask_ = 0;
+
+	/* Timecode types: 24, 25, 30 drop-frame and 30 fps. Drop-frame counts 
+	frames at 30 fps but runs at 29.97 fps in real time. */
+
+	static constexpr int    counts[] = {24, 25, 30, 30};
+	static constexpr double rates[]  = {24.0, 25.0, 30000.0 / 1001.0, 30.0};
+
+	const int    type    = (mtcPieces_[7] >> 1) & 0x03;
+	const int    frames  = mtcPieces_[0] | (mtcPieces_[1] << 4);
+	const int    seconds = mtcPieces_[2] | (mtcPieces_[3] << 4);
+	const int    minutes = mtcPieces_[4] | (mtcPieces_[5] << 4);
+	const int    hours   = mtcPieces_[6] | ((mtcPieces_[7] & 0x01) << 4);
+	const int    mins    = hours * 60 + minutes;
+	const double fps     = rates[type];
+
+	/* Timecode to frame number. Drop-frame skips numbers 0 and 1 at the start
+	of each minute, except every tenth minute. */
+
+	long number = (mins * 60L + seconds) * counts[type] + frames;
+	if (type == 2)
+		number -= 2 * (mins - mins / 10);
+
+	if (!mtcRunning_.load())
+	{
+		mtcRunning_.store(true);
+		pump_(eventDispatcher::EventType::MIDI_SYNC_START);
+	}
+
+	const Frame framesInLoop = model::get().clock.framesInLoop;
+	if (framesInLoop <= 0)
+		return;
+
+	/* The timecode refers to the first quarter frame, sent two frames ago. */
+
+	const double time = (number + 2) / fps;
+
+	follow_(static_cast<Frame>(std::fmod(time * conf::conf.samplerate, framesInLoop)));
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -57,6 +261,11 @@ std::function<void(float)> onJackChangeBpm = nullptr;
 std::function<void()>      onJackStart     = nullptr;
 std::function<void()>      onJackStop      = nullptr;
 
+std::function<void()>      onMidiStart     = nullptr;
+std::function<void()>      onMidiStop      = nullptr;
+std::function<void(float)> onMidiChangeBpm = nullptr;
+std::function<void(Frame)> onMidiRelocate  = nullptr;
+
 /* -------------------------------------------------------------------------- */
 
 void init(int sampleRate, float midiTCfps)
@@ -77,8 +286,6 @@ void sendMIDIsync()
 
 	int currentFrame = c.state->currentFrame.load();
 
-	/* TODO - only Master (_M) is implemented so far. */
-
 	if (conf::conf.midiSync == MIDI_SYNC_CLOCK_M)
 	{
 		if (currentFrame % (c.framesInBeat / 24) == 0)
@@ -192,6 +399,80 @@ void sendMIDIstop()
 
 /* -------------------------------------------------------------------------- */
 
+bool isMIDIsync(int b)
+{
+	return b == MIDI_CLOCK || b == MIDI_START || b == MIDI_CONTINUE ||
+	       b == MIDI_STOP || b == MIDI_POSITION_PTR || b == MIDI_MTC_QUARTER;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void recvMIDIsync(int byte1, int byte2, int byte3, double t)
+{
+	if (conf::conf.midiSync == MIDI_SYNC_CLOCK_S)
+	{
+		if (byte1 == MIDI_CLOCK)
+			recvClock_(t);
+		else
+			recvClockTransport_(byte1, byte2, byte3);
+	}
+	else if (conf::conf.midiSync == MIDI_SYNC_MTC_S && byte1 == MIDI_MTC_QUARTER)
+		recvQuarterFrame_(byte2, t);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void react(const eventDispatcher::EventBuffer& events)
+{
+	assert(onMidiStart != nullptr);
+	assert(onMidiStop != nullptr);
+	assert(onMidiChangeBpm != nullptr);
+	assert(onMidiRelocate != nullptr);
+
+	for (const eventDispatcher::Event& e : events)
+	{
+		switch (e.type)
+		{
+		case eventDispatcher::EventType::MIDI_SYNC_START:
+			onMidiStart();
+			break;
+
+		case eventDispatcher::EventType::MIDI_SYNC_STOP:
+			onMidiStop();
+			break;
+
+		case eventDispatcher::EventType::MIDI_SYNC_BPM:
+			onMidiChangeBpm(std::get<float>(e.data));
+			break;
+
+		case eventDispatcher::EventType::MIDI_SYNC_RELOCATE:
+			onMidiRelocate(std::get<int>(e.data));
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void update()
+{
+	if (!mtcRunning_.load())
+		return;
+
+	const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	if (now - mtcLast_.load() > G_MIDI_SYNC_MTC_TIMEOUT_MS / 1000.0)
+	{
+		mtcRunning_.store(false);
+		onMidiStop();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 #ifdef WITH_AUDIO_JACK
 
 void recvJackSync(const JackTransport::State& state)
@@ -30,6 +30,7 @@
 #ifdef WITH_AUDIO_JACK
 #include "core/jackTransport.h"
 #endif
+#include "core/eventDispatcher.h"
 #include "types.h"
 #include <functional>
 
@@ -54,6 +55,39 @@ void sendMIDIrewind();
 void sendMIDIstart();
 void sendMIDIstop();
 
+/* isMIDIsync
+Tells whether the status byte 'b' belongs to a MIDI clock or MTC message. */
+
+bool isMIDIsync(int b);
+
+/* recvMIDIsync
+Receives a MIDI clock or MTC message, received at time 't' (seconds, steady
+clock). Does nothing if not in slave mode. Called by Kernel MIDI. Resulting 
+tempo and transport changes are queued to the Event Dispatcher, see react(). */
+
+void recvMIDIsync(int byte1, int byte2, int byte3, double t);
+
+/* react
+Applies tempo and transport changes queued by recvMIDIsync(), by calling the 
+onMidi[...] callbacks below. Called by the Event Dispatcher. */
+
+void react(const eventDispatcher::EventBuffer& events);
+
+/* update
+Stops the sequencer if the MTC master went silent. Called periodically by the
+Event Dispatcher. */
+
+void update();
+
+/* onMidi[...]
+Callbacks called when something happens on the MIDI master, in slave mode. 
+Always called by the Event Dispatcher thread. */
+
+extern std::function<void()>      onMidiStart;
+extern std::function<void()>      onMidiStop;
+extern std::function<void(float)> onMidiChangeBpm;
+extern std::function<void(Frame)> onMidiRelocate;
+
 #ifdef WITH_AUDIO_JACK
 
 /* recvJackSync
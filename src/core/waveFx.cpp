@@ -26,6 +26,7 @@
 
 #include "waveFx.h"
 #include "const.h"
+#include "dsp.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/log.h"
 #include "wave.h"
@@ -35,48 +36,16 @@
 
 namespace giada::m::wfx
 {
-namespace
-{
-void fadeFrame_(Wave& w, int i, float val)
-{
-	for (int j = 0; j < w.getBuffer().countChannels(); j++)
-		w.getBuffer()[i][j] *= val;
-}
-
-/* -------------------------------------------------------------------------- */
-
-float getPeak_(const Wave& w, int a, int b)
-{
-	float peak = 0.0f;
-	float abs  = 0.0f;
-	for (int i = a; i < b; i++)
-	{
-		for (int j = 0; j < w.getBuffer().countChannels(); j++) // Find highest value in any channel
-			abs = fabs(w.getBuffer()[i][j]);
-		if (abs > peak)
-			peak = abs;
-	}
-	return peak;
-}
-} // namespace
-
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------- */
-
 constexpr int SMOOTH_SIZE = 32;
 
 void normalize(Wave& w, int a, int b)
 {
-	float peak = getPeak_(w, a, b);
+	const int   channels = w.getBuffer().countChannels();
+	const float peak     = dsp::getPeak(w.getBuffer()[a], (b - a) * channels);
 	if (peak == 0.0f || peak > 1.0f)
 		return;
 
-	for (int i = a; i < b; i++)
-	{
-		for (int j = 0; j < w.getBuffer().countChannels(); j++)
-			w.getBuffer()[i][j] = w.getBuffer()[i][j] * (1.0f / peak);
-	}
+	dsp::applyGain(w.getBuffer()[a], (b - a) * channels, 1.0f / peak);
 	w.setEdited(true);
 }
 
@@ -90,9 +59,7 @@ int monoToStereo(Wave& w)
 	mcl::AudioBuffer newData;
 	newData.alloc(w.getBuffer().countFrames(), G_MAX_IO_CHANS);
 
-	for (int i = 0; i < newData.countFrames(); i++)
-		for (int j = 0; j < newData.countChannels(); j++)
-			newData[i][j] = w.getBuffer()[i][0];
+	dsp::spread(w.getBuffer()[0], newData[0], newData.countFrames(), newData.countChannels());
 
 	w.replaceData(std::move(newData));
 
@@ -105,9 +72,7 @@ void silence(Wave& w, int a, int b)
 {
 	u::log::print("[wfx::silence] silencing from %d to %d\n", a, b);
 
-	for (int i = a; i < b; i++)
-		for (int j = 0; j < w.getBuffer().countChannels(); j++)
-			w.getBuffer()[i][j] = 0.0f;
+	dsp::fill(w.getBuffer()[a], (b - a) * w.getBuffer().countChannels(), 0.0f);
 	w.setEdited(true);
 }
 
@@ -130,15 +95,10 @@ void cut(Wave& w, int a, int b)
 
 	u::log::print("[wfx::cut] cutting from %d to %d\n", a, b);
 
-	for (int i = 0, k = 0; i < w.getBuffer().countFrames(); i++)
-	{
-		if (i < a || i >= b)
-		{
-			for (int j = 0; j < w.getBuffer().countChannels(); j++)
-				newData[k][j] = w.getBuffer()[i][j];
-			k++;
-		}
-	}
+	const int channels = w.getBuffer().countChannels();
+
+	dsp::copy(w.getBuffer()[0], newData[0], a * channels);
+	dsp::copy(w.getBuffer()[0] + (b * channels), newData[0] + (a * channels), (w.getBuffer().countFrames() - b) * channels);
 
 	w.replaceData(std::move(newData));
 	w.setEdited(true);
@@ -160,9 +120,7 @@ void trim(Wave& w, Frame a, Frame b)
 
 	u::log::print("[wfx::trim] trimming from %d to %d (area = %d)\n", a, b, b - a);
 
-	for (int i = 0; i < newData.countFrames(); i++)
-		for (int j = 0; j < newData.countChannels(); j++)
-			newData[i][j] = w.getBuffer()[i + a][j];
+	dsp::copy(w.getBuffer()[a], newData[0], newSize * newData.countChannels());
 
 	w.replaceData(std::move(newData));
 	w.setEdited(true);
@@ -194,15 +152,15 @@ void fade(Wave& w, int a, int b, Fade type)
 {
 	u::log::print("[wfx::fade] fade from %d to %d (range = %d)\n", a, b, b - a);
 
-	float m = 0.0f;
-	float d = 1.0f / (float)(b - a);
+	/* Range is inclusive: gain goes from 0.0 on frame 'a' to 1.0 on frame 'b'
+	when fading in, the other way around when fading out. */
+
+	const float d = 1.0f / (float)(b - a);
 
 	if (type == Fade::IN)
-		for (int i = a; i <= b; i++, m += d)
-			fadeFrame_(w, i, m);
+		dsp::applyRamp(w.getBuffer()[a], b - a + 1, w.getBuffer().countChannels(), 0.0f, d);
 	else
-		for (int i = b; i >= a; i--, m += d)
-			fadeFrame_(w, i, m);
+		dsp::applyRamp(w.getBuffer()[a], b - a + 1, w.getBuffer().countChannels(), d * (b - a), -d);
 
 	w.setEdited(true);
 }
@@ -211,7 +169,7 @@ void fade(Wave& w, int a, int b, Fade type)
 
 void smooth(Wave& w, int a, int b)
 {
-	/* Do nothing if fade edges (both of SMOOTH_SIZE samples) are > than selected 
+	/* Do nothing if fade edges (both of SMOOTH_SIZE samples) are > than selected
 	portion of wave. SMOOTH_SIZE*2 to count both edges. */
 
 	if (SMOOTH_SIZE * 2 > (b - a))
@@ -242,11 +200,10 @@ void shift(Wave& w, Frame offset)
 
 void reverse(Wave& w, Frame a, Frame b)
 {
-	/* https://stackoverflow.com/questions/33201528/reversing-an-array-of-structures-in-c */
-	float* begin = w.getBuffer()[0] + (a * w.getBuffer().countChannels());
-	float* end   = w.getBuffer()[0] + (b * w.getBuffer().countChannels());
+	/* Reverse frames, not samples: channels within each frame must keep their
+	order, otherwise left and right would be swapped. */
 
-	std::reverse(begin, end);
+	dsp::reverse(w.getBuffer()[a], b - a, w.getBuffer().countChannels());
 
 	w.setEdited(true);
 }
@@ -27,16 +27,25 @@
 #include "waveManager.h"
 #include "const.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include "dsp.h"
 #include "idManager.h"
 #include "model/model.h"
 #include "patch.h"
+#include "resampler.h"
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "wave.h"
-#include "waveFx.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <samplerate.h>
 #include <sndfile.h>
+#include <thread>
+#include <vector>
 
 namespace giada::m::waveManager
 {
@@ -44,6 +53,54 @@ namespace
 {
 IdManager waveId_;
 
+/* BLOCK_FRAMES, BLOCKS
+Size in frames of each block read from file and number of blocks in flight
+between the decoder thread and the converter. Extra memory needed to import a
+file doesn't depend on its length. */
+
+constexpr Frame BLOCK_FRAMES = 16384;
+constexpr int   BLOCKS       = 3;
+
+/* Block
+A chunk of interleaved audio data read from file. An empty Block marks the end
+of the stream. */
+
+struct Block
+{
+	std::vector<float> data;
+	Frame              frames = 0;
+};
+
+/* BlockQueue
+Blocking queue for passing Blocks between the decoder and the converter. */
+
+class BlockQueue
+{
+public:
+	void push(Block* b)
+	{
+		{
+			std::scoped_lock lock(m_mutex);
+			m_blocks.push_back(b);
+		}
+		m_cond.notify_one();
+	}
+
+	Block* pop()
+	{
+		std::unique_lock lock(m_mutex);
+		m_cond.wait(lock, [this] { return !m_blocks.empty(); });
+		Block* b = m_blocks.front();
+		m_blocks.pop_front();
+		return b;
+	}
+
+private:
+	std::mutex              m_mutex;
+	std::condition_variable m_cond;
+	std::deque<Block*>      m_blocks;
+};
+
 /* -------------------------------------------------------------------------- */
 
 int getBits_(const SF_INFO& header)
@@ -64,6 +121,170 @@ int getBits_(const SF_INFO& header)
 		return 64;
 	return 0;
 }
+
+/* -------------------------------------------------------------------------- */
+
+/* getSrcQuality_
+Built-in interpolators are meant for real-time pitching only: fall back to the
+fastest sinc converter for offline samplerate conversion. */
+
+int getSrcQuality_(int quality)
+{
+	if (Resampler::isBuiltin(static_cast<Resampler::Quality>(quality)))
+		return static_cast<int>(Resampler::Quality::SINC_FASTEST);
+	return quality;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* write_
+Writes 'frames' frames of interleaved stereo data to 'dest' starting at
+'offset', through the samplerate converter 'src' if any. Set 'last' on the
+final call to flush the converter. Returns the number of frames written or -1
+on error. */
+
+Frame write_(SRC_STATE* src, const float* in, Frame frames, bool last, double ratio,
+    mcl::AudioBuffer& dest, Frame offset)
+{
+	if (src == nullptr)
+	{
+		const Frame count = std::min(frames, dest.countFrames() - offset);
+		dsp::copy(in, dest[offset], count * G_MAX_IO_CHANS);
+		return count;
+	}
+
+	SRC_DATA data;
+	data.data_in      = in;
+	data.input_frames = frames;
+	data.src_ratio    = ratio;
+	data.end_of_input = last ? 1 : 0;
+
+	Frame written = 0;
+	while (offset + written < dest.countFrames())
+	{
+		data.data_out      = dest[offset + written];
+		data.output_frames = dest.countFrames() - offset - written;
+
+		if (int err = src_process(src, &data); err != 0)
+		{
+			u::log::print("[waveManager::write_] resampling error: %s\n", src_strerror(err));
+			return -1;
+		}
+
+		data.data_in += data.input_frames_used * G_MAX_IO_CHANS;
+		data.input_frames -= data.input_frames_used;
+		written += data.output_frames_gen;
+
+		if (data.input_frames_used == 0 && data.output_frames_gen == 0)
+			break;
+		if (data.input_frames == 0 && !last)
+			break;
+	}
+	return written;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* read_
+Streams audio from 'file' into the preallocated stereo buffer 'dest', converting
+mono to stereo and the sample rate by 'ratio' on the fly. Decoding runs in a
+separate thread, so that it overlaps with the conversion. */
+
+int read_(SNDFILE* file, const SF_INFO& header, mcl::AudioBuffer& dest, double ratio,
+    int quality)
+{
+	/* Fast path: nothing to convert, read straight into the destination. */
+
+	if (ratio == 1.0 && header.channels == G_MAX_IO_CHANS)
+	{
+		if (sf_readf_float(file, dest[0], dest.countFrames()) != dest.countFrames())
+			u::log::print("[waveManager::read_] warning: incomplete read!\n");
+		return G_RES_OK;
+	}
+
+	SRC_STATE* src = nullptr;
+	if (ratio != 1.0)
+	{
+		int err;
+		src = src_new(getSrcQuality_(quality), G_MAX_IO_CHANS, &err);
+		if (src == nullptr)
+		{
+			u::log::print("[waveManager::read_] unable to init resampler: %s\n", src_strerror(err));
+			return G_RES_ERR_PROCESSING;
+		}
+	}
+
+	std::array<Block, BLOCKS> blocks;
+	BlockQueue                empty;
+	BlockQueue                full;
+	std::atomic<bool>         stop = false;
+	Frame                     decoded = 0;
+
+	for (Block& b : blocks)
+	{
+		b.data.resize(BLOCK_FRAMES * header.channels);
+		empty.push(&b);
+	}
+
+	std::thread decoder([&]() {
+		while (true)
+		{
+			Block* b  = empty.pop();
+			b->frames = stop.load() ? 0 : static_cast<Frame>(sf_readf_float(file, b->data.data(), BLOCK_FRAMES));
+			decoded += b->frames;
+			full.push(b);
+			if (b->frames == 0)
+				return;
+		}
+	});
+
+	std::vector<float> stereo(header.channels == 1 ? BLOCK_FRAMES * G_MAX_IO_CHANS : 0);
+	Frame              written = 0;
+
+	while (true)
+	{
+		Block*     b    = full.pop();
+		const bool last = b->frames == 0;
+
+		if (!stop.load())
+		{
+			const float* in = b->data.data();
+			if (header.channels == 1)
+			{
+				dsp::spread(in, stereo.data(), b->frames, G_MAX_IO_CHANS);
+				in = stereo.data();
+			}
+
+			const Frame count = write_(src, in, b->frames, last, ratio, dest, written);
+			if (count < 0)
+				stop.store(true);
+			else
+				written += count;
+		}
+
+		empty.push(b);
+		if (last)
+			break;
+	}
+
+	decoder.join();
+
+	if (src != nullptr)
+		src_delete(src);
+
+	if (stop.load())
+		return G_RES_ERR_PROCESSING;
+
+	if (decoded != header.frames)
+		u::log::print("[waveManager::read_] warning: incomplete read!\n");
+
+	/* The converter might produce a few frames less than expected. */
+
+	if (written < dest.countFrames())
+		dest.clear(written);
+
+	return G_RES_OK;
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -103,26 +324,27 @@ Result createFromFile(const std::string& path, ID id, int samplerate, int qualit
 		return {G_RES_ERR_WRONG_DATA};
 	}
 
+	/* Decoding, mono to stereo and sample rate conversion happen in a single
+	streaming pass, straight into the final buffer. */
+
+	const double ratio  = samplerate / static_cast<double>(header.samplerate);
+	const Frame  frames = ratio == 1.0 ? header.frames : static_cast<Frame>(std::ceil(header.frames * ratio));
+
+	if (ratio != 1.0)
+		u::log::print("[waveManager::create] input rate (%d) != required rate (%d), conversion needed\n",
+		    header.samplerate, samplerate);
+
 	waveId_.set(id);
 
 	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.generate(id));
-	wave->alloc(header.frames, header.channels, header.samplerate, getBits_(header), path);
+	wave->alloc(frames, G_MAX_IO_CHANS, samplerate, getBits_(header), path);
 
-	if (sf_readf_float(fileIn, wave->getBuffer()[0], header.frames) != header.frames)
-		u::log::print("[waveManager::create] warning: incomplete read!\n");
+	const int res = read_(fileIn, header, wave->getBuffer(), ratio, quality);
 
 	sf_close(fileIn);
 
-	if (header.channels == 1 && !wfx::monoToStereo(*wave))
-		return {G_RES_ERR_PROCESSING};
-
-	if (wave->getRate() != samplerate)
-	{
-		u::log::print("[waveManager::create] input rate (%d) != required rate (%d), conversion needed\n",
-		    wave->getRate(), samplerate);
-		if (resample(*wave.get(), quality, samplerate) != G_RES_OK)
-			return {G_RES_ERR_PROCESSING};
-	}
+	if (res != G_RES_OK)
+		return {res};
 
 	u::log::print("[waveManager::create] new Wave created, %d frames\n", wave->getBuffer().countFrames());
 
@@ -163,6 +385,43 @@ std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b)
 
 /* -------------------------------------------------------------------------- */
 
+std::unique_ptr<Wave> createPitched(const Wave& src, float pitch, int quality)
+{
+	const mcl::AudioBuffer& in       = src.getBuffer();
+	const int               channels = in.countChannels();
+	const Frame             frames   = static_cast<Frame>(std::ceil(in.countFrames() / pitch));
+
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(/*id=*/0);
+	wave->alloc(frames, channels, src.getRate(), src.getBits(), src.getPath());
+	wave->setLogical(true);
+
+	/* Same resampler used for live pitching, so that the rendered audio lines
+	up with the live one when crossfading between the two. */
+
+	Resampler         resampler(static_cast<Resampler::Quality>(quality), channels);
+	mcl::AudioBuffer& out       = wave->getBuffer();
+	Frame             used      = 0;
+	Frame             generated = 0;
+
+	while (generated < frames)
+	{
+		Resampler::Result res = resampler.process(in[0], used, in.countFrames(),
+		    out[generated], frames - generated, pitch);
+		if (res.generated == 0)
+			break;
+		used += res.used;
+		generated += res.generated;
+	}
+	out.clear(generated);
+
+	u::log::print("[waveManager::createPitched] new Wave created, pitch=%f, %d frames\n",
+	    pitch, frames);
+
+	return wave;
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::unique_ptr<Wave> deserializeWave(const patch::Wave& w, int samplerate, int quality)
 {
 	return createFromFile(w.path, w.id, samplerate, quality).wave;
@@ -184,6 +443,8 @@ Wave* hydrateWave(ID waveId)
 
 int resample(Wave& w, int quality, int samplerate)
 {
+	quality = getSrcQuality_(quality);
+
 	float ratio         = samplerate / (float)w.getRate();
 	int   newSizeFrames = static_cast<int>(ceil(w.getBuffer().countFrames() * ratio));
 
@@ -69,6 +69,13 @@ Creates a new Wave from an existing one, copying the data in range a - b. */
 
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b);
 
+/* createPitched
+Creates a new Wave with the content of 'src' rendered at 'pitch' with the
+resampler 'quality'. The result is a derived Wave that doesn't belong to the
+model, so it has no ID. Safe to call from any thread. */
+
+std::unique_ptr<Wave> createPitched(const Wave& src, float pitch, int quality);
+
 /* (de)serializeWave
 Creates a new Wave given the patch raw data and vice versa. */
 
@@ -43,10 +43,12 @@ Worker::~Worker()
 
 /* -------------------------------------------------------------------------- */
 
-void Worker::start(std::function<void()> f, int sleep)
+void Worker::start(std::function<void()> f, int sleep, std::function<void()> onStart)
 {
 	m_running.store(true);
-	m_thread = std::thread([this, f, sleep]() {
+	m_thread = std::thread([this, f, sleep, onStart]() {
+		if (onStart)
+			onStart();
 		while (m_running.load() == true)
 		{
 			f();
@@ -39,7 +39,12 @@ public:
 	Worker();
 	~Worker();
 
-	void start(std::function<void()> f, int sleep);
+	/* start
+	Runs 'f' in a loop on a new thread, sleeping 'sleep' milliseconds in 
+	between. 'onStart', if any, runs once on the new thread before the loop, 
+	e.g. to set up its scheduling. */
+
+	void start(std::function<void()> f, int sleep, std::function<void()> onStart = nullptr);
 	void stop();
 
   private:
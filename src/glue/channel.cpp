@@ -128,6 +128,10 @@ Data::Data(const m::channel::Data& c)
 , pan(c.pan)
 , key(c.key)
 , hasActions(c.hasActions)
+, outputId(c.outputId)
+, sendId(c.sendId)
+, sendLevel(c.sendLevel)
+, sendPre(c.sendPre)
 , m_channel(c)
 {
 	if (c.type == ChannelType::SAMPLE)
@@ -281,4 +285,18 @@ void setName(ID channelId, const std::string& name)
 {
 	m::mh::renameChannel(channelId, name);
 }
+
+/* -------------------------------------------------------------------------- */
+
+void setOutput(ID channelId, ID busId)
+{
+	m::mh::setOutput(channelId, busId);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setSend(ID channelId, ID busId, float level, bool pre)
+{
+	m::mh::setSend(channelId, busId, level, pre);
+}
 } // namespace giada::c::channel
@@ -97,6 +97,10 @@ struct Data
 	float       pan;
 	int         key;
 	bool        hasActions;
+	ID          outputId;
+	ID          sendId;
+	float       sendLevel;
+	bool        sendPre;
 
 	std::optional<SampleData> sample;
 	std::optional<MidiData>   midi;
@@ -159,6 +163,13 @@ void setName(ID channelId, const std::string& name);
 void setHeight(ID channelId, Pixel p);
 
 void setSamplePlayerMode(ID channelId, SamplePlayerMode m);
+
+/* setOutput, setSend
+Routing to group buses. See mixerHandler::setOutput() and
+mixerHandler::setSend(). */
+
+void setOutput(ID channelId, ID busId);
+void setSend(ID channelId, ID busId, float level, bool pre);
 } // namespace giada::c::channel
 
 #endif
@@ -146,6 +146,7 @@ AudioData getAudioData()
 	audioData.limitOutput     = m::conf::conf.limitOutput;
 	audioData.recTriggerLevel = m::conf::conf.recTriggerLevel;
 	audioData.resampleQuality = m::conf::conf.rsmpQuality;
+	audioData.pitchCache      = m::conf::conf.pitchCache;
 	audioData.outputDevice    = getAudioDeviceData_(DeviceType::OUTPUT,
         m::conf::conf.soundDeviceOut, m::conf::conf.channelsOutCount,
         m::conf::conf.channelsOutStart);
@@ -169,6 +170,7 @@ void save(const AudioData& data)
 	m::conf::conf.channelsInStart  = data.inputDevice.channelsStart;
 	m::conf::conf.limitOutput      = data.limitOutput;
 	m::conf::conf.rsmpQuality      = data.resampleQuality;
+	m::conf::conf.pitchCache       = data.pitchCache;
 	m::conf::conf.buffersize       = data.bufferSize;
 	m::conf::conf.recTriggerLevel  = data.recTriggerLevel;
 	m::conf::conf.samplerate       = data.sampleRate;
@@ -80,6 +80,7 @@ struct AudioData
 	bool            limitOutput;
 	float           recTriggerLevel;
 	int             resampleQuality;
+	bool            pitchCache;
 };
 
 /* getAudioData
@@ -63,15 +63,9 @@ namespace
 {
 void pushEvent_(m::eventDispatcher::Event e, Thread t)
 {
-	bool res = true;
-	if (t == Thread::MAIN)
-		res = m::eventDispatcher::UIevents.push(e);
-	else if (t == Thread::MIDI)
-		res = m::eventDispatcher::MidiEvents.push(e);
-	else
-		assert(false);
-
-	if (!res)
+	assert(t == Thread::MAIN || t == Thread::MIDI);
+
+	if (!m::eventDispatcher::pumpEvent(e))
 		G_DEBUG("[events] Queue full!\n");
 }
 } // namespace
@@ -80,11 +74,9 @@ void pushEvent_(m::eventDispatcher::Event e, Thread t)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void pressChannel(ID channelId, int velocity, Thread t)
+void pressChannel(ID channelId, int velocity, Thread t, Frame delta)
 {
-	m::MidiEvent e;
-	e.setVelocity(velocity);
-	pushEvent_({m::eventDispatcher::EventType::KEY_PRESS, 0, channelId, velocity}, t);
+	pushEvent_({m::eventDispatcher::EventType::KEY_PRESS, delta, channelId, velocity}, t);
 }
 
 void releaseChannel(ID channelId, Thread t)
@@ -169,9 +161,9 @@ void killReadActionsChannel(ID channelId, Thread t)
 
 /* -------------------------------------------------------------------------- */
 
-void sendMidiToChannel(ID channelId, m::MidiEvent e, Thread t)
+void sendMidiToChannel(ID channelId, m::MidiEvent e, Thread t, Frame frame)
 {
-	pushEvent_({m::eventDispatcher::EventType::MIDI, 0, channelId, m::Action{0, channelId, 0, e}}, t);
+	pushEvent_({m::eventDispatcher::EventType::MIDI, e.getDelta(), channelId, m::Action{0, channelId, frame, e}}, t);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -259,8 +251,8 @@ void toggleInputRecording()
 #ifdef WITH_VST
 void setPluginParameter(ID pluginId, int paramIndex, float value, bool gui)
 {
-	m::pluginHost::setPluginParameter(pluginId, paramIndex, value);
-	c::plugin::updateWindow(pluginId, gui);
+	m::pluginHost::setPluginParameter(pluginId, paramIndex, value, gui ? Thread::MAIN : Thread::MIDI);
+	c::plugin::updateWindow(pluginId, paramIndex, value, gui);
 }
 #endif
 } // namespace giada::c::events
@@ -43,7 +43,7 @@ namespace giada::c::events
 /* Channel*
 Channel-related events. */
 
-void pressChannel(ID channelId, int velocity, Thread t);
+void pressChannel(ID channelId, int velocity, Thread t, Frame delta = 0);
 void releaseChannel(ID channelId, Thread t);
 void killChannel(ID channelId, Thread t);
 void setChannelVolume(ID channelId, float v, Thread t);
@@ -54,7 +54,7 @@ void toggleSoloChannel(ID channelId, Thread t);
 void toggleArmChannel(ID channelId, Thread t);
 void toggleReadActionsChannel(ID channelId, Thread t);
 void killReadActionsChannel(ID channelId, Thread t);
-void sendMidiToChannel(ID channelId, m::MidiEvent e, Thread t);
+void sendMidiToChannel(ID channelId, m::MidiEvent e, Thread t, Frame frame = -1);
 
 /* Main*
 Master I/O, transport and other engine-related events. */
@@ -32,6 +32,7 @@
 #include "core/mixer.h"
 #include "core/model/model.h"
 #include "core/plugins/pluginHost.h"
+#include "core/plugins/pluginLoader.h"
 #include "core/plugins/pluginManager.h"
 #include "gui/dialogs/browser/browserDir.h"
 #include "gui/dialogs/config.h"
@@ -48,6 +49,34 @@ extern giada::v::gdMainWindow* G_MainWin;
 
 namespace giada::c::plugin
 {
+namespace
+{
+/* getWindow_
+Returns the editor-less window of plug-in 'pluginId', if open. */
+
+v::gdPluginWindow* getWindow_(ID pluginId)
+{
+	m::Plugin* p = m::model::find<m::Plugin>(pluginId);
+
+	assert(p != nullptr);
+
+	if (p->hasEditor())
+		return nullptr;
+
+	/* Get the parent window first: the plug-in list. Then, if it exists, get
+    the child window - the actual pluginWindow. */
+
+	v::gdPluginList* parent = static_cast<v::gdPluginList*>(u::gui::getSubwindow(G_MainWin, WID_FX_LIST));
+	if (parent == nullptr)
+		return nullptr;
+	return static_cast<v::gdPluginWindow*>(u::gui::getSubwindow(parent, pluginId + 1));
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 Param::Param(const m::Plugin& p, int index, ID channelId)
 : index(index)
 , pluginId(p.id)
@@ -59,6 +88,19 @@ Param::Param(const m::Plugin& p, int index, ID channelId)
 {
 }
 
+/* -------------------------------------------------------------------------- */
+
+Param::Param(const m::Plugin& p, int index, ID channelId, float value)
+: index(index)
+, pluginId(p.id)
+, channelId(channelId)
+, name(p.getParameterName(index))
+, text(p.getParameterText(index, value))
+, label(p.getParameterLabel(index))
+, value(value)
+{
+}
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
@@ -69,6 +111,7 @@ Plugin::Plugin(m::Plugin& p, ID channelId)
 , valid(p.valid)
 , hasEditor(p.hasEditor())
 , isBypassed(p.isBypassed())
+, isLoading(p.isLoading())
 , name(p.getName())
 , uniqueId(p.getUniqueId())
 , currentProgram(p.getCurrentProgram())
@@ -131,37 +174,46 @@ Param getParam(int index, const m::Plugin& plugin, ID channelId)
 
 void updateWindow(ID pluginId, bool gui)
 {
-	m::Plugin* p = m::model::find<m::Plugin>(pluginId);
-
-	assert(p != nullptr);
-
-	if (p->hasEditor())
+	v::gdPluginWindow* child = getWindow_(pluginId);
+	if (child == nullptr)
 		return;
 
-	/* Get the parent window first: the plug-in list. Then, if it exists, get
-    the child window - the actual pluginWindow. */
+	if (!gui)
+		Fl::lock();
+	child->updateParameters(!gui);
+	if (!gui)
+		Fl::unlock();
+}
 
-	v::gdPluginList* parent = static_cast<v::gdPluginList*>(u::gui::getSubwindow(G_MainWin, WID_FX_LIST));
-	if (parent == nullptr)
-		return;
-	v::gdPluginWindow* child = static_cast<v::gdPluginWindow*>(u::gui::getSubwindow(parent, pluginId + 1));
+/* -------------------------------------------------------------------------- */
+
+void updateWindow(ID pluginId, int index, float value, bool gui)
+{
+	v::gdPluginWindow* child = getWindow_(pluginId);
 	if (child == nullptr)
 		return;
 
 	if (!gui)
 		Fl::lock();
-	child->updateParameters(!gui);
+	child->updateParameter(index, value, !gui);
 	if (!gui)
 		Fl::unlock();
 }
 
 /* -------------------------------------------------------------------------- */
 
+Frame getLatency()
+{
+	return m::model::get().mixer.state->latency.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void addPlugin(int pluginListIndex, ID channelId)
 {
 	if (pluginListIndex >= m::pluginManager::countAvailablePlugins())
 		return;
-	std::unique_ptr<m::Plugin> p = m::pluginManager::makePlugin(pluginListIndex);
+	std::unique_ptr<m::Plugin> p = m::pluginLoader::load(pluginListIndex);
 	if (p != nullptr)
 		m::pluginHost::addPlugin(std::move(p), channelId);
 }
@@ -58,6 +58,7 @@ struct Param
 {
 	Param() = default;
 	Param(const m::Plugin&, int index, ID channelId);
+	Param(const m::Plugin&, int index, ID channelId, float value);
 
 	int         index;
 	ID          pluginId;
@@ -82,6 +83,7 @@ struct Plugin
 	bool        valid;
 	bool        hasEditor;
 	bool        isBypassed;
+	bool        isLoading;
 	std::string name;
 	std::string uniqueId;
 	int         currentProgram;
@@ -115,6 +117,19 @@ editor. */
 
 void updateWindow(ID pluginId, bool gui);
 
+/* updateWindow (2)
+Same as above, for parameter 'index' only, set to 'value'. Used for parameter 
+changes still waiting to be applied by the audio thread: the plug-in would 
+report the old value. */
+
+void updateWindow(ID pluginId, int index, float value, bool gui);
+
+/* getLatency
+Returns the latency added by plug-ins, delay compensation included, in 
+frames. */
+
+Frame getLatency();
+
 void addPlugin(int pluginListIndex, ID channelId);
 void swapPlugins(const m::Plugin& p1, const m::Plugin& p2, ID channelId);
 void freePlugin(const m::Plugin& plugin, ID channelId);
@@ -29,6 +29,7 @@
 #include "core/const.h"
 #include "core/mixerHandler.h"
 #include "core/model/model.h"
+#include "core/pieceTable.h"
 #include "core/wave.h"
 #include "core/waveManager.h"
 #include "glue/events.h"
@@ -50,6 +51,11 @@
 #include "utils/log.h"
 #include <FL/Fl.H>
 #include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
 extern giada::v::gdMainWindow* G_MainWin;
 
@@ -74,15 +80,73 @@ m::Wave& getWave_(ID channelId)
 
 /* -------------------------------------------------------------------------- */
 
-/* waveBuffer
-A Wave used during cut/copy/paste operations. */
+/* Render
+A job for the render thread: materializes a snapshot of the piece table into a
+new audio buffer for Wave 'waveId'. */
 
-std::unique_ptr<m::Wave> waveBuffer_;
+struct Render
+{
+	int                   generation;
+	ID                    waveId;
+	m::PieceTable::Pieces pieces;
+	int                   channels;
+	mcl::AudioBuffer      buffer;
+};
+
+/* pieceTable_
+Non-destructive edit model of the Wave currently being edited. Edits are
+applied here first, then the Wave is materialized by the render thread. */
+
+std::unique_ptr<m::PieceTable> pieceTable_;
+ID                             pieceTableWaveId_ = 0;
+
+/* clipboard_
+Pieces used during cut/copy/paste operations. */
+
+std::optional<m::PieceTable::Pieces> clipboard_;
+
+std::thread             renderThread_;
+std::mutex              renderMutex_;
+std::condition_variable renderCond_;
+std::optional<Render>   renderJob_;  // Waiting to be rendered
+std::optional<Render>   renderDone_; // Waiting to be applied to the Wave
+bool                    renderQuit_ = false;
+int                     generation_ = 0;
+
+/* onRender_
+Actions to perform on the main thread once the last edit has been applied to
+the Wave, e.g. adjusting begin/end points to the new Wave size. */
+
+std::vector<std::function<void()>> onRender_;
 
 Frame previewTracker_ = 0;
 
 /* -------------------------------------------------------------------------- */
 
+/* setBeginEnd_
+Same as setBeginEnd() below, without rebuilding the Sample Editor window. */
+
+void setBeginEnd_(ID channelId, Frame b, Frame e)
+{
+	m::channel::Data& c = getChannel_(channelId);
+
+	b = std::clamp(b, 0, c.samplePlayer->getWaveSize() - 1);
+	e = std::clamp(e, 1, c.samplePlayer->getWaveSize() - 1);
+	if (b >= e)
+		b = e - 1;
+	else if (e < b)
+		e = b + 1;
+
+	if (c.state->tracker.load() < b)
+		c.state->tracker.store(b);
+
+	getSamplePlayer_(channelId).begin = b;
+	getSamplePlayer_(channelId).end   = e;
+	m::model::swap(m::model::SwapType::SOFT);
+}
+
+/* -------------------------------------------------------------------------- */
+
 /* resetBeginEnd_
 Resets begin/end points to 0/max. */
 
@@ -90,7 +154,111 @@ void resetBeginEnd_(ID channelId)
 {
 	Frame begin = getSamplePlayer_(channelId).begin;
 	Frame end   = getSamplePlayer_(channelId).getWaveSize();
-	setBeginEnd(channelId, begin, end);
+	setBeginEnd_(channelId, begin, end);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getPieceTable_
+Returns the piece table for the Wave in channel 'channelId'. A new one is
+created if the Wave has changed since the last edit. */
+
+m::PieceTable& getPieceTable_(ID channelId)
+{
+	const m::Wave& wave = getWave_(channelId);
+
+	if (pieceTable_ == nullptr || pieceTableWaveId_ != wave.id)
+	{
+		pieceTable_       = std::make_unique<m::PieceTable>(wave.getBuffer());
+		pieceTableWaveId_ = wave.id;
+	}
+	return *pieceTable_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* applyRender_
+Replaces the Wave data with the last rendered buffer, if any. Stale buffers,
+i.e. older than the last edit, are discarded. Main thread only. */
+
+void applyRender_(bool rebuild)
+{
+	std::optional<Render> render;
+	{
+		std::scoped_lock lock(renderMutex_);
+		render.swap(renderDone_);
+	}
+
+	if (!render || render->generation != generation_)
+		return;
+
+	/* The Wave might have been deleted or replaced in the meantime. */
+
+	m::Wave* wave = m::model::find<m::Wave>(render->waveId);
+	if (wave == nullptr)
+	{
+		onRender_.clear();
+		return;
+	}
+
+	{
+		m::model::DataLock lock;
+		wave->replaceData(std::move(render->buffer));
+		wave->setEdited(true);
+		for (m::channel::Data& ch : m::model::get().channels)
+			if (ch.samplePlayer && ch.samplePlayer->getWave() == wave)
+				ch.samplePlayer->waveReader.cache = nullptr; // Stale pitched render
+		for (std::function<void()>& f : onRender_)
+			f();
+		onRender_.clear();
+	}
+
+	if (rebuild)
+		u::gui::rebuildSubWindow(WID_SAMPLE_EDITOR);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void renderLoop_()
+{
+	std::unique_lock lock(renderMutex_);
+	while (true)
+	{
+		renderCond_.wait(lock, [] { return renderJob_ || renderQuit_; });
+		if (!renderJob_)
+			return;
+
+		Render render = std::move(*renderJob_);
+		renderJob_.reset();
+
+		lock.unlock();
+		render.buffer = m::PieceTable::render(render.pieces, render.channels);
+		lock.lock();
+
+		renderDone_ = std::move(render);
+		Fl::awake([](void*) { applyRender_(/*rebuild=*/true); }, nullptr);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* render_
+Schedules the materialization of the current piece table in background.
+Function 'f', if any, is called on the main thread once the Wave has been
+updated. */
+
+void render_(std::function<void()> f = nullptr)
+{
+	if (f != nullptr)
+		onRender_.push_back(f);
+
+	std::scoped_lock lock(renderMutex_);
+
+	renderJob_ = Render{++generation_, pieceTableWaveId_, pieceTable_->getPieces(), pieceTable_->countChannels(), {}};
+
+	if (!renderThread_.joinable())
+		renderThread_ = std::thread(renderLoop_);
+	renderCond_.notify_one();
 }
 } // namespace
 
@@ -104,6 +272,7 @@ Data::Data(const m::channel::Data& c)
 , volume(c.volume)
 , pan(c.pan)
 , pitch(c.samplePlayer->pitch)
+, resampleQuality(static_cast<int>(c.state->resampler->getQuality()))
 , begin(c.samplePlayer->begin)
 , end(c.samplePlayer->end)
 , shift(c.samplePlayer->shift)
@@ -170,21 +339,7 @@ v::gdSampleEditor* getSampleEditorWindow()
 
 void setBeginEnd(ID channelId, Frame b, Frame e)
 {
-	m::channel::Data& c = getChannel_(channelId);
-
-	b = std::clamp(b, 0, c.samplePlayer->getWaveSize() - 1);
-	e = std::clamp(e, 1, c.samplePlayer->getWaveSize() - 1);
-	if (b >= e)
-		b = e - 1;
-	else if (e < b)
-		e = b + 1;
-
-	if (c.state->tracker.load() < b)
-		c.state->tracker.store(b);
-
-	getSamplePlayer_(channelId).begin = b;
-	getSamplePlayer_(channelId).end   = e;
-	m::model::swap(m::model::SwapType::SOFT);
+	setBeginEnd_(channelId, b, e);
 
 	/* TODO waveform widget is dumb and wants a rebuild. Refactoring needed! */
 	getSampleEditorWindow()->rebuild();
@@ -195,16 +350,15 @@ void setBeginEnd(ID channelId, Frame b, Frame e)
 void cut(ID channelId, Frame a, Frame b)
 {
 	copy(channelId, a, b);
-	m::model::DataLock lock;
-	m::wfx::cut(getWave_(channelId), a, b);
-	resetBeginEnd_(channelId);
+	getPieceTable_(channelId).cut(a, b);
+	render_([channelId]() { resetBeginEnd_(channelId); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void copy(ID channelId, Frame a, Frame b)
 {
-	waveBuffer_ = m::waveManager::createFromWave(getWave_(channelId), a, b);
+	clipboard_ = getPieceTable_(channelId).copy(a, b);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -217,90 +371,125 @@ void paste(ID channelId, Frame a)
 		return;
 	}
 
-	/* Get the existing wave in channel. */
-
-	m::Wave& wave = getWave_(channelId);
-
-	/* Temporary disable wave reading in channel. From now on, the audio thread
-	won't be reading any wave, so editing it is safe.  */
-
-	m::model::DataLock lock;
-
-	/* Paste copied data to destination wave. */
-
-	m::wfx::paste(*waveBuffer_, wave, a);
+	getPieceTable_(channelId).paste(*clipboard_, a);
 
-	/* Pass the old wave that contains the pasted data to channel. */
+	/* Once the Wave is ready, shift begin/end points to keep the previous
+	position. */
 
-	m::samplePlayer::setWave(getChannel_(channelId), &wave, 1.0f);
+	Frame delta = 0;
+	for (const m::PieceTable::Piece& p : *clipboard_)
+		delta += p.length;
 
-	/* In the meantime, shift begin/end points to keep the previous position. */
+	render_([channelId, a, delta]() {
+		Frame begin = getSamplePlayer_(channelId).begin;
+		Frame end   = getSamplePlayer_(channelId).end;
 
-	int   delta = waveBuffer_->getBuffer().countFrames();
-	Frame begin = getSamplePlayer_(channelId).begin;
-	Frame end   = getSamplePlayer_(channelId).end;
-
-	if (a < begin && a < end)
-		setBeginEnd(channelId, begin + delta, end + delta);
-	else if (a < end)
-		setBeginEnd(channelId, begin, end + delta);
-
-	getSampleEditorWindow()->rebuild();
+		if (a < begin && a < end)
+			setBeginEnd_(channelId, begin + delta, end + delta);
+		else if (a < end)
+			setBeginEnd_(channelId, begin, end + delta);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void silence(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::silence(getWave_(channelId), a, b);
+	getPieceTable_(channelId).silence(a, b);
+	render_();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void fade(ID channelId, int a, int b, m::wfx::Fade type)
 {
-	m::model::DataLock lock;
-	m::wfx::fade(getWave_(channelId), a, b, type);
+	getPieceTable_(channelId).fade(a, b, type);
+	render_();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void smoothEdges(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::smooth(getWave_(channelId), a, b);
+	getPieceTable_(channelId).smooth(a, b);
+	render_();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void reverse(ID channelId, Frame a, Frame b)
 {
-	m::model::DataLock lock;
-	m::wfx::reverse(getWave_(channelId), a, b);
+	getPieceTable_(channelId).reverse(a, b);
+	render_();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void normalize(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::normalize(getWave_(channelId), a, b);
+	getPieceTable_(channelId).normalize(a, b);
+	render_();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void trim(ID channelId, int a, int b)
 {
-	m::model::DataLock lock;
-	m::wfx::trim(getWave_(channelId), a, b);
-	resetBeginEnd_(channelId);
+	getPieceTable_(channelId).trim(a, b);
+	render_([channelId]() { resetBeginEnd_(channelId); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void undo(ID channelId)
+{
+	if (getPieceTable_(channelId).undo())
+		render_([channelId]() { resetBeginEnd_(channelId); });
+}
+
+void redo(ID channelId)
+{
+	if (getPieceTable_(channelId).redo())
+		render_([channelId]() { resetBeginEnd_(channelId); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool canUndo(ID channelId)
+{
+	return pieceTable_ != nullptr && pieceTableWaveId_ == getWave_(channelId).id && pieceTable_->canUndo();
+}
+
+bool canRedo(ID channelId)
+{
+	return pieceTable_ != nullptr && pieceTableWaveId_ == getWave_(channelId).id && pieceTable_->canRedo();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void flushEdits()
+{
+	if (renderThread_.joinable())
+	{
+		{
+			std::scoped_lock lock(renderMutex_);
+			renderQuit_ = true;
+		}
+		renderCond_.notify_one();
+		renderThread_.join();
+		renderQuit_ = false;
+	}
+
+	applyRender_(/*rebuild=*/false);
+
+	pieceTable_.reset();
+	pieceTableWaveId_ = 0;
 }
 
 /* -------------------------------------------------------------------------- */
 
 /* TODO - this arcane logic of keeping previewTracker_ will go away as soon as
-the One-shot pause mode is implemented: 
+the One-shot pause mode is implemented:
 	https://github.com/monocasual/giada/issues/88 */
 
 void playPreview(bool loop)
@@ -351,7 +540,7 @@ void toNewChannel(ID channelId, Frame a, Frame b)
 
 bool isWaveBufferFull()
 {
-	return waveBuffer_ != nullptr;
+	return clipboard_.has_value();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -372,15 +561,24 @@ void reload(ID channelId)
 
 /* -------------------------------------------------------------------------- */
 
-void shift(ID channelId, Frame offset)
+void setResampleQuality(ID channelId, int quality)
 {
-	namespace mm = m::model;
+	/* Resampler is not thread-safe: replace it while the audio thread is not
+	rendering channels. */
+
+	m::model::DataLock lock;
+	getChannel_(channelId).state->resampler = m::Resampler(static_cast<m::Resampler::Quality>(quality), G_MAX_IO_CHANS);
+}
 
+/* -------------------------------------------------------------------------- */
+
+void shift(ID channelId, Frame offset)
+{
 	Frame shift = getSamplePlayer_(channelId).shift;
 
-	mm::DataLock lock();
-	m::wfx::shift(getWave_(channelId), offset - shift);
+	getPieceTable_(channelId).shift(offset - shift);
 	getSamplePlayer_(channelId).shift = offset;
+	render_();
 
 	getSampleEditorWindow()->shiftTool->update(offset);
 }
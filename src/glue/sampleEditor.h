@@ -60,6 +60,7 @@ struct Data
 	float       volume;
 	float       pan;
 	float       pitch;
+	int         resampleQuality;
 	Frame       begin;
 	Frame       end;
 	Frame       shift;
@@ -101,6 +102,27 @@ void smoothEdges(ID channelId, Frame a, Frame b);
 void shift(ID channelId, Frame offset);
 void reload(ID channelId);
 
+/* setResampleQuality
+Changes the resampler used by the channel when pitch != 1.0. 'quality' is one
+of m::Resampler::Quality values. */
+
+void setResampleQuality(ID channelId, int quality);
+
+/* undo, redo
+Edits are non-destructive: they can be undone and redone until the Sample
+Editor is closed. */
+
+void undo(ID channelId);
+void redo(ID channelId);
+bool canUndo(ID channelId);
+bool canRedo(ID channelId);
+
+/* flushEdits
+Waits for pending edits to be applied to the Wave, then drops the undo history.
+Call this when the Sample Editor gets closed. */
+
+void flushEdits();
+
 bool isWaveBufferFull();
 
 void playPreview(bool loop);
@@ -99,12 +99,16 @@ bool savePatch_(const std::string& path, const std::string& name)
 {
 	m::patch::init();
 	m::patch::patch.name = name;
-	m::model::store(m::patch::patch);
+	m::model::store(m::patch::patch, u::fs::dirname(path));
 	v::model::store(m::patch::patch);
 
 	if (!m::patch::write(path))
 		return false;
 
+#ifdef WITH_VST
+	m::pluginManager::removeUnusedStates(u::fs::dirname(path), m::patch::patch.plugins);
+#endif
+
 	u::gui::updateMainWinLabel(name);
 	m::conf::conf.patchPath = u::fs::getUpDir(u::fs::getUpDir(path));
 	u::log::print("[savePatch] patch saved as %s\n", path);
@@ -0,0 +1,104 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "channelRouting.h"
+#include "core/const.h"
+#include "glue/channel.h"
+#include "gui/elems/basics/button.h"
+#include "gui/elems/basics/check.h"
+#include "gui/elems/basics/choice.h"
+#include "gui/elems/basics/slider.h"
+#include "utils/gui.h"
+#include <string>
+
+namespace giada::v
+{
+gdChannelRouting::gdChannelRouting(const c::channel::Data& d)
+: gdWindow(u::gui::centerWindowX(300), u::gui::centerWindowY(136), 300, 136, "Routing")
+, m_channelId(d.id)
+{
+	set_modal();
+
+	const int lw = 70; // Labels width
+	const int cx = G_GUI_OUTER_MARGIN + lw;
+	const int cw = w() - cx - G_GUI_OUTER_MARGIN;
+
+	m_output    = new geChoice(cx, G_GUI_OUTER_MARGIN, cw, G_GUI_UNIT, "Output");
+	m_send      = new geChoice(cx, m_output->y() + m_output->h() + G_GUI_INNER_MARGIN, cw, G_GUI_UNIT, "Send");
+	m_sendLevel = new geSlider(cx, m_send->y() + m_send->h() + G_GUI_INNER_MARGIN, cw, G_GUI_UNIT, "Send level");
+	m_sendPre   = new geCheck(cx, m_sendLevel->y() + m_sendLevel->h() + G_GUI_INNER_MARGIN, cw, G_GUI_UNIT, "Pre-fader");
+	m_ok        = new geButton(w() - 70 - G_GUI_OUTER_MARGIN, m_sendPre->y() + m_sendPre->h() + G_GUI_OUTER_MARGIN, 70, G_GUI_UNIT, "Ok");
+	m_cancel    = new geButton(m_ok->x() - 70 - G_GUI_OUTER_MARGIN, m_ok->y(), 70, G_GUI_UNIT, "Cancel");
+	end();
+
+	m_output->addItem("Master out", 0);
+	m_send->addItem("None", 0);
+	for (const c::channel::Data& ch : c::channel::getChannels())
+	{
+		if (ch.type != ChannelType::GROUP)
+			continue;
+		const std::string name = ch.name.empty() ? "Group " + std::to_string(ch.id) : ch.name;
+		m_output->addItem(name, ch.id);
+		m_send->addItem(name, ch.id);
+	}
+	m_output->showItem(d.outputId);
+	m_send->showItem(d.sendId);
+
+	m_sendLevel->value(d.sendLevel);
+	m_sendPre->value(d.sendPre);
+
+	m_ok->shortcut(FL_Enter);
+	m_ok->callback(cb_update, (void*)this);
+
+	m_cancel->callback(cb_cancel, (void*)this);
+
+	u::gui::setFavicon(this);
+	setId(WID_ROUTING);
+	show();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void gdChannelRouting::cb_update(Fl_Widget* /*w*/, void* p) { ((gdChannelRouting*)p)->cb_update(); }
+void gdChannelRouting::cb_cancel(Fl_Widget* /*w*/, void* p) { ((gdChannelRouting*)p)->cb_cancel(); }
+
+/* -------------------------------------------------------------------------- */
+
+void gdChannelRouting::cb_cancel()
+{
+	do_callback();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void gdChannelRouting::cb_update()
+{
+	c::channel::setOutput(m_channelId, m_output->getSelectedId());
+	c::channel::setSend(m_channelId, m_send->getSelectedId(), m_sendLevel->value(), m_sendPre->value());
+	do_callback();
+}
+} // namespace giada::v
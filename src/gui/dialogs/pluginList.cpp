@@ -48,7 +48,7 @@ extern giada::v::gdMainWindow* G_MainWin;
 namespace giada::v
 {
 gdPluginList::gdPluginList(ID channelId)
-: gdWindow(m::conf::conf.pluginListX, m::conf::conf.pluginListY, 468, 204)
+: gdWindow(m::conf::conf.pluginListX, m::conf::conf.pluginListY, 592, 204)
 , m_channelId(channelId)
 {
 	end();
@@ -85,14 +85,12 @@ void gdPluginList::rebuild()
 	m_plugins = c::plugin::getPlugins(m_channelId);
 
 	if (m_plugins.channelId == m::mixer::MASTER_OUT_CHANNEL_ID)
-		label("Master Out Plug-ins");
+		m_title = "Master Out Plug-ins";
 	else if (m_plugins.channelId == m::mixer::MASTER_IN_CHANNEL_ID)
-		label("Master In Plug-ins");
+		m_title = "Master In Plug-ins";
 	else
-	{
-		std::string l = "Channel " + u::string::iToString(m_plugins.channelId) + " Plug-ins";
-		copy_label(l.c_str());
-	}
+		m_title = "Channel " + u::string::iToString(m_plugins.channelId) + " Plug-ins";
+	updateTitle();
 
 	/* Clear the previous list. */
 
@@ -109,6 +107,32 @@ void gdPluginList::rebuild()
 
 /* -------------------------------------------------------------------------- */
 
+void gdPluginList::refresh()
+{
+	/* The last child is the 'add new plugin' button. */
+
+	for (int i = 0; i < list->countChildren() - 1; i++)
+		static_cast<gePluginElement*>(list->child(i))->refresh();
+
+	updateTitle();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void gdPluginList::updateTitle()
+{
+	std::string l = m_title;
+
+	const Frame latency = c::plugin::getLatency();
+	if (latency > 0)
+		l += " - latency " + u::string::iToString(latency) + " frames";
+
+	if (label() == nullptr || l != label())
+		copy_label(l.c_str());
+}
+
+/* -------------------------------------------------------------------------- */
+
 void gdPluginList::cb_addPlugin()
 {
 	int wx = m::conf::conf.pluginChooserX;
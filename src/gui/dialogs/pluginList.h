@@ -31,6 +31,7 @@
 
 #include "glue/plugin.h"
 #include "window.h"
+#include <string>
 
 class geButton;
 
@@ -45,6 +46,7 @@ public:
 	~gdPluginList();
 
 	void rebuild() override;
+	void refresh() override;
 
 	const gePluginElement& getNextElement(const gePluginElement& curr) const;
 	const gePluginElement& getPrevElement(const gePluginElement& curr) const;
@@ -53,11 +55,17 @@ private:
 	static void cb_addPlugin(Fl_Widget* /*w*/, void* p);
 	void        cb_addPlugin();
 
+	/* updateTitle
+	Shows the total plug-in latency next to the window title. */
+
+	void updateTitle();
+
 	geButton*       addPlugin;
 	geLiquidScroll* list;
 
 	ID                 m_channelId;
 	c::plugin::Plugins m_plugins;
+	std::string        m_title;
 };
 } // namespace giada::v
 
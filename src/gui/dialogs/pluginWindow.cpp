@@ -75,6 +75,13 @@ void gdPluginWindow::updateParameters(bool changeSlider)
 	for (int index : m_plugin.paramIndexes)
 		static_cast<v::gePluginParameter*>(m_list->child(index))->update(c::plugin::getParam(index, m_plugin.getPluginRef(), m_plugin.channelId), changeSlider);
 }
+
+/* -------------------------------------------------------------------------- */
+
+void gdPluginWindow::updateParameter(int index, float value, bool changeSlider)
+{
+	static_cast<v::gePluginParameter*>(m_list->child(index))->update(c::plugin::Param(m_plugin.getPluginRef(), index, m_plugin.channelId, value), changeSlider);
+}
 } // namespace giada::v
 
 #endif // #ifdef WITH_VST
@@ -52,6 +52,12 @@ public:
 
 	void updateParameters(bool changeSlider = false);
 
+	/* updateParameter
+	Shows 'value' for parameter 'index', regardless of the current value in the
+	plug-in. */
+
+	void updateParameter(int index, float value, bool changeSlider = false);
+
 private:
 	const c::plugin::Plugin& m_plugin;
 
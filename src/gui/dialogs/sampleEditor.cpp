@@ -103,6 +103,7 @@ gdSampleEditor::~gdSampleEditor()
 
 	c::sampleEditor::stopPreview();
 	c::sampleEditor::cleanupPreview();
+	c::sampleEditor::flushEdits();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -126,7 +126,8 @@ geTabAudio::geTabAudio(int X, int Y, int W, int H)
 	channelsIn      = new geChannelMenu(x() + 114, y() + 149, 55, 20, "Input channels", m_data.inputDevice);
 	recTriggerLevel = new geInput(x() + 309, y() + 149, 55, 20, "Rec threshold (dB)");
 	rsmpQuality     = new geChoice(x() + 114, y() + 177, 250, 20, "Resampling");
-	new geBox(x(), rsmpQuality->y() + rsmpQuality->h() + 8, w(), 92, "Restart Giada for the changes to take effect.");
+	pitchCache      = new geCheck(x() + 114, y() + 205, 250, 20, "Pre-render pitched samples");
+	new geBox(x(), pitchCache->y() + pitchCache->h() + 8, w(), 64, "Restart Giada for the changes to take effect.");
 	end();
 
 	labelsize(G_GUI_FONT_SIZE_BASE);
@@ -180,9 +181,16 @@ geTabAudio::geTabAudio(int X, int Y, int W, int H)
 	rsmpQuality->addItem("Sinc basic quality (medium)", 2);
 	rsmpQuality->addItem("Zero Order Hold (fast)", 3);
 	rsmpQuality->addItem("Linear (very fast)", 4);
+	rsmpQuality->addItem("Built-in linear (fastest)", 5);
+	rsmpQuality->addItem("Built-in cubic Hermite (very fast)", 6);
+	rsmpQuality->addItem("Built-in 8-taps FIR (fast)", 7);
 	rsmpQuality->showItem(m_data.resampleQuality);
 	rsmpQuality->onChange = [this](ID id) { m_data.resampleQuality = id; };
 
+	pitchCache->copy_tooltip("Play pitched samples from a copy rendered in background");
+	pitchCache->value(m_data.pitchCache);
+	pitchCache->onChange = [this](bool v) { m_data.pitchCache = v; };
+
 	recTriggerLevel->value(u::string::fToString(m_data.recTriggerLevel, 1).c_str());
 	recTriggerLevel->onChange = [this](const std::string& s) { m_data.recTriggerLevel = std::stof(s); };
 
@@ -251,6 +259,7 @@ void geTabAudio::deactivateAll()
 	channelsIn->deactivate();
 	recTriggerLevel->deactivate();
 	rsmpQuality->deactivate();
+	pitchCache->deactivate();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -263,6 +272,7 @@ void geTabAudio::activateAll()
 	channelsOut->activate();
 	samplerate->activate();
 	rsmpQuality->activate();
+	pitchCache->activate();
 	if (m_data.inputDevice.index != -1)
 	{
 		sounddevIn->activate();
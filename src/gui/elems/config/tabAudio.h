@@ -75,6 +75,7 @@ public:
 	geChannelMenu* channelsIn;
 	geInput*       recTriggerLevel;
 	geChoice*      rsmpQuality;
+	geCheck*       pitchCache;
 
 private:
 	void invalidate();
@@ -65,12 +65,18 @@ geTabMidi::geTabMidi(int X, int Y, int W, int H)
 	sync->add("(disabled)");
 	sync->add("MIDI Clock (master)");
 	sync->add("MTC (master)");
+	sync->add("MIDI Clock (slave)");
+	sync->add("MTC (slave)");
 	if (m::conf::conf.midiSync == MIDI_SYNC_NONE)
 		sync->value(0);
 	else if (m::conf::conf.midiSync == MIDI_SYNC_CLOCK_M)
 		sync->value(1);
 	else if (m::conf::conf.midiSync == MIDI_SYNC_MTC_M)
 		sync->value(2);
+	else if (m::conf::conf.midiSync == MIDI_SYNC_CLOCK_S)
+		sync->value(3);
+	else if (m::conf::conf.midiSync == MIDI_SYNC_MTC_S)
+		sync->value(4);
 
 	systemInitValue = system->value();
 }
@@ -170,6 +176,10 @@ void geTabMidi::save()
 		m::conf::conf.midiSync = MIDI_SYNC_CLOCK_M;
 	else if (sync->value() == 2)
 		m::conf::conf.midiSync = MIDI_SYNC_MTC_M;
+	else if (sync->value() == 3)
+		m::conf::conf.midiSync = MIDI_SYNC_CLOCK_S;
+	else if (sync->value() == 4)
+		m::conf::conf.midiSync = MIDI_SYNC_MTC_S;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -56,8 +56,9 @@ geTabPlugins::geTabPlugins(int X, int Y, int W, int H)
 {
 	m_browse     = new geButton(x() + w() - G_GUI_UNIT, y() + 9, G_GUI_UNIT, G_GUI_UNIT, "", zoomInOff_xpm, zoomInOn_xpm);
 	m_folderPath = new geInput(m_browse->x() - 258, y() + 9, 250, G_GUI_UNIT);
-	m_scanButton = new geButton(x() + w() - 150, m_folderPath->y() + m_folderPath->h() + 8, 150, G_GUI_UNIT);
-	m_info       = new geBox(x(), m_scanButton->y() + m_scanButton->h() + 8, w(), 240);
+	m_scanButton  = new geButton(x() + w() - 150, m_folderPath->y() + m_folderPath->h() + 8, 150, G_GUI_UNIT);
+	m_autoSuspend = new geCheck(m_folderPath->x(), m_scanButton->y() + m_scanButton->h() + 8, 250, 20, "Suspend silent plug-ins");
+	m_info        = new geBox(x(), m_autoSuspend->y() + m_autoSuspend->h() + 8, w(), 212);
 
 	end();
 
@@ -74,6 +75,9 @@ geTabPlugins::geTabPlugins(int X, int Y, int W, int H)
 
 	m_scanButton->callback(cb_scan, (void*)this);
 
+	m_autoSuspend->copy_tooltip("Stop processing plug-ins when their input and output are silent");
+	m_autoSuspend->value(m::conf::conf.pluginAutoSuspend);
+
 	refreshCount();
 }
 
@@ -121,7 +125,8 @@ void geTabPlugins::cb_scan()
 
 void geTabPlugins::save()
 {
-	m::conf::conf.pluginPath = m_folderPath->value();
+	m::conf::conf.pluginPath        = m_folderPath->value();
+	m::conf::conf.pluginAutoSuspend = m_autoSuspend->value();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -34,6 +34,7 @@
 class geInput;
 class geButton;
 class geBox;
+class geCheck;
 
 namespace giada
 {
@@ -58,6 +59,7 @@ public:
 	geInput*  m_folderPath;
 	geButton* m_browse;
 	geButton* m_scanButton;
+	geCheck*  m_autoSuspend;
 	geBox*    m_info;
 };
 } // namespace v
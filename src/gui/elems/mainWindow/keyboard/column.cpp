@@ -30,6 +30,7 @@
 #include "gui/dialogs/warnings.h"
 #include "gui/elems/basics/boxtypes.h"
 #include "gui/elems/basics/resizerBar.h"
+#include "groupChannel.h"
 #include "keyboard.h"
 #include "midiChannel.h"
 #include "sampleChannel.h"
@@ -72,6 +73,8 @@ geChannel* geColumn::addChannel(c::channel::Data d)
 
 	if (d.type == ChannelType::SAMPLE)
 		gch = new geSampleChannel(x(), last->y() + last->h() + G_GUI_INNER_MARGIN, w(), d.height, d);
+	else if (d.type == ChannelType::GROUP)
+		gch = new geGroupChannel(x(), last->y() + last->h() + G_GUI_INNER_MARGIN, w(), d.height, d);
 	else
 		gch = new geMidiChannel(x(), last->y() + last->h() + G_GUI_INNER_MARGIN, w(), d.height, d);
 
@@ -118,11 +121,12 @@ void geColumn::cb_addChannel()
 	Fl_Menu_Item menu[] = {
 	    {"Add Sample channel"},
 	    {"Add MIDI channel"},
+	    {"Add Group bus"},
 	    {"Remove"},
 	    {0}};
 
 	if (countChannels() > 0)
-		menu[2].deactivate();
+		menu[3].deactivate();
 
 	Fl_Menu_Button b(0, 0, 100, 50);
 	b.box(G_CUSTOM_BORDER_BOX);
@@ -138,6 +142,8 @@ void geColumn::cb_addChannel()
 		c::channel::addChannel(id, ChannelType::SAMPLE);
 	else if (strcmp(m->label(), "Add MIDI channel") == 0)
 		c::channel::addChannel(id, ChannelType::MIDI);
+	else if (strcmp(m->label(), "Add Group bus") == 0)
+		c::channel::addChannel(id, ChannelType::GROUP);
 	else
 		static_cast<geKeyboard*>(parent())->deleteColumn(id);
 }
@@ -0,0 +1,157 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "groupChannel.h"
+#include "channelButton.h"
+#include "core/const.h"
+#include "core/graphics.h"
+#include "glue/channel.h"
+#include "gui/dialogs/channelNameInput.h"
+#include "gui/dialogs/mainWindow.h"
+#include "gui/elems/basics/boxtypes.h"
+#include "gui/elems/basics/button.h"
+#include "gui/elems/basics/dial.h"
+#include "gui/elems/basics/statusButton.h"
+#include "utils/gui.h"
+#include <FL/Fl_Menu_Button.H>
+
+extern giada::v::gdMainWindow* G_MainWin;
+
+namespace giada::v
+{
+namespace
+{
+enum class Menu
+{
+	RENAME_CHANNEL = 0,
+	DELETE_CHANNEL
+};
+
+/* -------------------------------------------------------------------------- */
+
+void menuCallback(Fl_Widget* w, void* v)
+{
+	const geGroupChannel*   gch  = static_cast<geGroupChannel*>(w);
+	const c::channel::Data& data = gch->getData();
+
+	switch ((Menu)(intptr_t)v)
+	{
+	case Menu::RENAME_CHANNEL:
+		u::gui::openSubWindow(G_MainWin, new gdChannelNameInput(data), WID_SAMPLE_NAME);
+		break;
+	case Menu::DELETE_CHANNEL:
+		c::channel::deleteChannel(data.id);
+		break;
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+geGroupChannel::geGroupChannel(int X, int Y, int W, int H, c::channel::Data d)
+: geChannel(X, Y, W, H, d)
+{
+	/* The main button comes first: packWidgets() lays out children starting
+	from the first one. */
+
+	mainButton = new geChannelButton(x(), y(), w(), H, m_channel);
+	playButton = new geStatusButton(x(), y(), G_GUI_UNIT, G_GUI_UNIT, channelStop_xpm, channelPlay_xpm);
+	arm        = new geButton(x(), y(), G_GUI_UNIT, G_GUI_UNIT, "", armOff_xpm, armOn_xpm);
+	mute       = new geStatusButton(x(), y(), G_GUI_UNIT, G_GUI_UNIT, muteOff_xpm, muteOn_xpm);
+	solo       = new geStatusButton(x(), y(), G_GUI_UNIT, G_GUI_UNIT, soloOff_xpm, soloOn_xpm);
+#ifdef WITH_VST
+	fx = new geStatusButton(x(), y(), G_GUI_UNIT, G_GUI_UNIT, fxOff_xpm, fxOn_xpm);
+#endif
+	vol = new geDial(x(), y(), G_GUI_UNIT, G_GUI_UNIT);
+
+	end();
+
+	resizable(mainButton);
+
+	mainButton->copy_label(m_channel.name.empty() ? "-- Group --" : m_channel.name.c_str());
+	mainButton->callback(cb_openMenu, (void*)this);
+
+	playButton->hide();
+	arm->hide();
+	solo->hide();
+
+	mute->copy_tooltip("Mute");
+	mute->type(FL_TOGGLE_BUTTON);
+	mute->callback(cb_mute, (void*)this);
+
+#ifdef WITH_VST
+	fx->copy_tooltip("Plug-ins");
+	fx->setStatus(m_channel.plugins.size() > 0);
+	fx->callback(cb_openFxWindow, (void*)this);
+#endif
+
+	vol->copy_tooltip("Volume");
+	vol->value(m_channel.volume);
+	vol->callback(cb_changeVol, (void*)this);
+
+	size(w(), h()); // Force responsiveness
+}
+
+/* -------------------------------------------------------------------------- */
+
+void geGroupChannel::cb_openMenu(Fl_Widget* /*w*/, void* p) { ((geGroupChannel*)p)->cb_openMenu(); }
+
+/* -------------------------------------------------------------------------- */
+
+void geGroupChannel::cb_openMenu()
+{
+	Fl_Menu_Item rclick_menu[] = {
+	    {"Rename", 0, menuCallback, (void*)Menu::RENAME_CHANNEL},
+	    {"Delete", 0, menuCallback, (void*)Menu::DELETE_CHANNEL},
+	    {0}};
+
+	Fl_Menu_Button b(0, 0, 100, 50);
+	b.box(G_CUSTOM_BORDER_BOX);
+	b.textsize(G_GUI_FONT_SIZE_BASE);
+	b.textcolor(G_COLOR_LIGHT_2);
+	b.color(G_COLOR_GREY_2);
+
+	const Fl_Menu_Item* m = rclick_menu->popup(Fl::event_x(), Fl::event_y(), 0, 0, &b);
+	if (m != nullptr)
+		m->do_callback(this, m->user_data());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void geGroupChannel::resize(int X, int Y, int W, int H)
+{
+	geChannel::resize(X, Y, W, H);
+
+#ifdef WITH_VST
+	fx->hide();
+	if (w() > BREAK_FX)
+		fx->show();
+#endif
+
+	packWidgets();
+}
+} // namespace giada::v
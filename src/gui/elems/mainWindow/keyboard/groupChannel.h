@@ -0,0 +1,53 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef GE_GROUP_CHANNEL_H
+#define GE_GROUP_CHANNEL_H
+
+#include "channel.h"
+
+namespace giada::v
+{
+/* geGroupChannel
+A group bus: no content on its own, just the channels routed or sent to it,
+processed through its plug-in stack. Play, arm and solo buttons are there for
+geChannel's sake, but always hidden. */
+
+class geGroupChannel : public geChannel
+{
+public:
+	geGroupChannel(int x, int y, int w, int h, c::channel::Data d);
+
+	void resize(int x, int y, int w, int h) override;
+
+private:
+	static void cb_openMenu(Fl_Widget* /*w*/, void* p);
+	void        cb_openMenu();
+};
+} // namespace giada::v
+
+#endif
@@ -36,6 +36,7 @@
 #include "glue/recorder.h"
 #include "gui/dialogs/actionEditor/midiActionEditor.h"
 #include "gui/dialogs/channelNameInput.h"
+#include "gui/dialogs/channelRouting.h"
 #include "gui/dialogs/keyGrabber.h"
 #include "gui/dialogs/mainWindow.h"
 #include "gui/dialogs/midiIO/midiInputChannel.h"
@@ -70,6 +71,7 @@ enum class Menu
 	SETUP_KEYBOARD_INPUT,
 	SETUP_MIDI_INPUT,
 	SETUP_MIDI_OUTPUT,
+	SETUP_ROUTING,
 	RENAME_CHANNEL,
 	CLONE_CHANNEL,
 	DELETE_CHANNEL
@@ -102,6 +104,9 @@ void menuCallback(Fl_Widget* w, void* v)
 	case Menu::SETUP_MIDI_OUTPUT:
 		u::gui::openSubWindow(G_MainWin, new gdMidiOutputMidiCh(data.id), WID_MIDI_OUTPUT);
 		break;
+	case Menu::SETUP_ROUTING:
+		u::gui::openSubWindow(G_MainWin, new gdChannelRouting(data), WID_ROUTING);
+		break;
 	case Menu::CLONE_CHANNEL:
 		c::channel::cloneChannel(data.id);
 		break;
@@ -205,6 +210,7 @@ void geMidiChannel::cb_openMenu()
 	    {"Setup keyboard input...", 0, menuCallback, (void*)Menu::SETUP_KEYBOARD_INPUT},
 	    {"Setup MIDI input...", 0, menuCallback, (void*)Menu::SETUP_MIDI_INPUT},
 	    {"Setup MIDI output...", 0, menuCallback, (void*)Menu::SETUP_MIDI_OUTPUT},
+	    {"Routing...", 0, menuCallback, (void*)Menu::SETUP_ROUTING},
 	    {"Rename", 0, menuCallback, (void*)Menu::RENAME_CHANNEL},
 	    {"Clone", 0, menuCallback, (void*)Menu::CLONE_CHANNEL},
 	    {"Delete", 0, menuCallback, (void*)Menu::DELETE_CHANNEL},
@@ -47,6 +47,7 @@
 #include "gui/dialogs/browser/browserLoad.h"
 #include "gui/dialogs/browser/browserSave.h"
 #include "gui/dialogs/channelNameInput.h"
+#include "gui/dialogs/channelRouting.h"
 #include "gui/dialogs/keyGrabber.h"
 #include "gui/dialogs/mainWindow.h"
 #include "gui/dialogs/midiIO/midiInputChannel.h"
@@ -80,6 +81,7 @@ enum class Menu
 	SETUP_KEYBOARD_INPUT,
 	SETUP_MIDI_INPUT,
 	SETUP_MIDI_OUTPUT,
+	SETUP_ROUTING,
 	EDIT_SAMPLE,
 	EDIT_ACTIONS,
 	CLEAR_ACTIONS,
@@ -144,6 +146,11 @@ void menuCallback(Fl_Widget* w, void* v)
 		    WID_MIDI_OUTPUT);
 		break;
 	}
+	case Menu::SETUP_ROUTING:
+	{
+		u::gui::openSubWindow(G_MainWin, new gdChannelRouting(data), WID_ROUTING);
+		break;
+	}
 	case Menu::EDIT_SAMPLE:
 	{
 		u::gui::openSubWindow(G_MainWin, new gdSampleEditor(data.id),
@@ -308,6 +315,7 @@ void geSampleChannel::cb_openMenu()
 	    {"Setup keyboard input...", 0, menuCallback, (void*)Menu::SETUP_KEYBOARD_INPUT},
 	    {"Setup MIDI input...", 0, menuCallback, (void*)Menu::SETUP_MIDI_INPUT},
 	    {"Setup MIDI output...", 0, menuCallback, (void*)Menu::SETUP_MIDI_OUTPUT},
+	    {"Routing...", 0, menuCallback, (void*)Menu::SETUP_ROUTING},
 	    {"Edit sample...", 0, menuCallback, (void*)Menu::EDIT_SAMPLE},
 	    {"Edit actions...", 0, menuCallback, (void*)Menu::EDIT_ACTIONS},
 	    {"Clear actions", 0, menuCallback, (void*)Menu::CLEAR_ACTIONS, FL_SUBMENU},
@@ -39,7 +39,9 @@
 #include "gui/elems/basics/choice.h"
 #include "utils/gui.h"
 #include "utils/log.h"
+#include "utils/string.h"
 #include <cassert>
+#include <cmath>
 #include <string>
 
 namespace giada
@@ -50,6 +52,7 @@ gePluginElement::gePluginElement(int x, int y, c::plugin::Plugin data)
 : gePack(x, y, Direction::HORIZONTAL)
 , button(0, 0, 196, G_GUI_UNIT)
 , program(0, 0, 132, G_GUI_UNIT)
+, meter(0, 0, 120, G_GUI_UNIT)
 , bypass(0, 0, G_GUI_UNIT, G_GUI_UNIT)
 , shiftUp(0, 0, G_GUI_UNIT, G_GUI_UNIT, "", fxShiftUpOff_xpm, fxShiftUpOn_xpm)
 , shiftDown(0, 0, G_GUI_UNIT, G_GUI_UNIT, "", fxShiftDownOff_xpm, fxShiftDownOn_xpm)
@@ -58,6 +61,7 @@ gePluginElement::gePluginElement(int x, int y, c::plugin::Plugin data)
 {
 	add(&button);
 	add(&program);
+	add(&meter);
 	add(&bypass);
 	add(&shiftUp);
 	add(&shiftDown);
@@ -69,7 +73,10 @@ gePluginElement::gePluginElement(int x, int y, c::plugin::Plugin data)
 
 	if (!m_plugin.valid)
 	{
-		button.copy_label(m_plugin.uniqueId.c_str());
+		if (m_plugin.isLoading)
+			button.copy_label((m_plugin.uniqueId + " (loading...)").c_str());
+		else
+			button.copy_label(m_plugin.uniqueId.c_str());
 		button.deactivate();
 		bypass.deactivate();
 		shiftUp.deactivate();
@@ -99,6 +106,8 @@ gePluginElement::gePluginElement(int x, int y, c::plugin::Plugin data)
 
 	shiftUp.callback(cb_shiftUp, (void*)this);
 	shiftDown.callback(cb_shiftDown, (void*)this);
+
+	refresh();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -115,6 +124,44 @@ const m::Plugin& gePluginElement::getPluginRef() const
 
 /* -------------------------------------------------------------------------- */
 
+void gePluginElement::refresh()
+{
+	if (!m_plugin.valid)
+		return;
+
+	const m::Plugin&       plugin = getPluginRef();
+	const m::Plugin::Stats stats  = plugin.getStats();
+
+	/* Average and peak load, in percentage of the block duration, followed by 
+	the reported latency if any. */
+
+	std::string l;
+	if (plugin.isBypassed())
+		l = "-";
+	else if (stats.idle)
+		l = "idle";
+	else
+		l = u::string::iToString(std::lround(stats.avgLoad * 100.0f)) + "% / " +
+		    u::string::iToString(std::lround(stats.peakLoad * 100.0f)) + "%";
+	if (stats.latency > 0)
+		l += " | " + u::string::iToString(stats.latency);
+
+	std::string t = "CPU (average / peak): " +
+	                u::string::fToString(stats.avgTime, 1) + " / " +
+	                u::string::fToString(stats.peakTime, 1) + " us\n" +
+	                "Latency: " + u::string::iToString(stats.latency) + " frames";
+
+	/* Touch the widget only when something changed: this runs at GUI refresh 
+	rate. */
+
+	if (meter.label() == nullptr || l != meter.label())
+		meter.copy_label(l.c_str());
+	if (meter.tooltip() == nullptr || t != meter.tooltip())
+		meter.copy_tooltip(t.c_str());
+}
+
+/* -------------------------------------------------------------------------- */
+
 void gePluginElement::cb_removePlugin(Fl_Widget* /*w*/, void* p) { ((gePluginElement*)p)->cb_removePlugin(); }
 void gePluginElement::cb_openPluginWindow(Fl_Widget* /*w*/, void* p) { ((gePluginElement*)p)->cb_openPluginWindow(); }
 void gePluginElement::cb_setBypass(Fl_Widget* /*w*/, void* p) { ((gePluginElement*)p)->cb_setBypass(); }
@@ -30,6 +30,7 @@
 #define GE_PLUGIN_ELEMENT_H
 
 #include "glue/plugin.h"
+#include "gui/elems/basics/box.h"
 #include "gui/elems/basics/button.h"
 #include "gui/elems/basics/choice.h"
 #include "gui/elems/basics/pack.h"
@@ -46,8 +47,14 @@ public:
 	ID               getPluginId() const;
 	const m::Plugin& getPluginRef() const;
 
+	/* refresh
+	Updates the CPU and latency meter. */
+
+	void refresh();
+
 	geButton button;
 	geChoice program;
+	geBox    meter;
 	geButton bypass;
 	geButton shiftUp;
 	geButton shiftDown;
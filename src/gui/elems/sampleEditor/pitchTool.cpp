@@ -31,6 +31,7 @@
 #include "core/graphics.h"
 #include "core/model/model.h"
 #include "glue/events.h"
+#include "glue/sampleEditor.h"
 #include "gui/dialogs/sampleEditor.h"
 #include "gui/elems/basics/box.h"
 #include "gui/elems/basics/button.h"
@@ -55,6 +56,7 @@ gePitchTool::gePitchTool(const c::sampleEditor::Data& d, int x, int y)
 , m_pitchHalf(0, 0, G_GUI_UNIT, G_GUI_UNIT, "", divideOff_xpm, divideOn_xpm)
 , m_pitchDouble(0, 0, G_GUI_UNIT, G_GUI_UNIT, "", multiplyOff_xpm, multiplyOn_xpm)
 , m_pitchReset(0, 0, 70, G_GUI_UNIT, "Reset")
+, m_resampling(0, 0, 130, G_GUI_UNIT)
 {
 	add(&m_label);
 	add(&m_dial);
@@ -64,6 +66,7 @@ gePitchTool::gePitchTool(const c::sampleEditor::Data& d, int x, int y)
 	add(&m_pitchHalf);
 	add(&m_pitchDouble);
 	add(&m_pitchReset);
+	add(&m_resampling);
 
 	m_dial.range(0.01f, 4.0f);
 	m_dial.callback(cb_setPitch, (void*)this);
@@ -79,6 +82,18 @@ gePitchTool::gePitchTool(const c::sampleEditor::Data& d, int x, int y)
 	m_pitchDouble.callback(cb_setPitchDouble, (void*)this);
 	m_pitchReset.callback(cb_resetPitch, (void*)this);
 
+	m_resampling.addItem("Sinc best", 0);
+	m_resampling.addItem("Sinc medium", 1);
+	m_resampling.addItem("Sinc basic", 2);
+	m_resampling.addItem("Zero Order Hold", 3);
+	m_resampling.addItem("Linear", 4);
+	m_resampling.addItem("Built-in linear", 5);
+	m_resampling.addItem("Built-in Hermite", 6);
+	m_resampling.addItem("Built-in FIR", 7);
+	m_resampling.onChange = [this](ID id) {
+		c::sampleEditor::setResampleQuality(m_data->channelId, id);
+	};
+
 	rebuild(d);
 }
 
@@ -88,6 +103,7 @@ void gePitchTool::rebuild(const c::sampleEditor::Data& d)
 {
 	m_data = &d;
 	update(m_data->pitch, /*isDial=*/false);
+	m_resampling.showItem(m_data->resampleQuality);
 }
 
 /* -------------------------------------------------------------------------- */
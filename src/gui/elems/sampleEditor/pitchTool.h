@@ -29,6 +29,7 @@
 
 #include "gui/elems/basics/box.h"
 #include "gui/elems/basics/button.h"
+#include "gui/elems/basics/choice.h"
 #include "gui/elems/basics/dial.h"
 #include "gui/elems/basics/input.h"
 #include "gui/elems/basics/pack.h"
@@ -73,6 +74,7 @@ public:
 	geButton m_pitchHalf;
 	geButton m_pitchDouble;
 	geButton m_pitchReset;
+	geChoice m_resampling;
 };
 } // namespace giada::v
 
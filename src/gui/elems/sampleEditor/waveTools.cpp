@@ -55,7 +55,9 @@ enum class Menu
 	FADE_OUT,
 	SMOOTH_EDGES,
 	SET_BEGIN_END,
-	TO_NEW_CHANNEL
+	TO_NEW_CHANNEL,
+	UNDO,
+	REDO
 };
 
 /* -------------------------------------------------------------------------- */
@@ -108,6 +110,12 @@ void menuCallback_(Fl_Widget* w, void* v)
 	case Menu::TO_NEW_CHANNEL:
 		c::sampleEditor::toNewChannel(channelId, a, b);
 		break;
+	case Menu::UNDO:
+		c::sampleEditor::undo(channelId);
+		break;
+	case Menu::REDO:
+		c::sampleEditor::redo(channelId);
+		break;
 	}
 }
 } // namespace
@@ -209,6 +217,8 @@ void geWaveTools::openMenu()
 	    {"Smooth edges", 0, menuCallback_, (void*)Menu::SMOOTH_EDGES, 0, 0, 0, 0, 0},
 	    {"Set begin/end here", 0, menuCallback_, (void*)Menu::SET_BEGIN_END, 0, 0, 0, 0, 0},
 	    {"Copy to new channel", 0, menuCallback_, (void*)Menu::TO_NEW_CHANNEL, 0, 0, 0, 0, 0},
+	    {"Undo", 0, menuCallback_, (void*)Menu::UNDO, 0, 0, 0, 0, 0},
+	    {"Redo", 0, menuCallback_, (void*)Menu::REDO, 0, 0, 0, 0, 0},
 	    {0}};
 
 	if (!waveform->isSelected())
@@ -226,6 +236,11 @@ void geWaveTools::openMenu()
 		menu[(int)Menu::TO_NEW_CHANNEL].deactivate();
 	}
 
+	if (!c::sampleEditor::canUndo(m_data->channelId))
+		menu[(int)Menu::UNDO].deactivate();
+	if (!c::sampleEditor::canRedo(m_data->channelId))
+		menu[(int)Menu::REDO].deactivate();
+
 	Fl_Menu_Button b(0, 0, 100, 50);
 	b.box(G_CUSTOM_BORDER_BOX);
 	b.textsize(G_GUI_FONT_SIZE_BASE);
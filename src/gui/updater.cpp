@@ -27,6 +27,8 @@
 #include "updater.h"
 #include "core/const.h"
 #include "core/model/model.h"
+#include "core/pitchCache.h"
+#include "core/plugins/pluginLoader.h"
 #include "utils/gui.h"
 #include <FL/Fl.H>
 
@@ -53,6 +55,14 @@ void init()
 
 void update(void* /*p*/)
 {
+	/* Pitch cache snapshots Waves, so it must run here alongside Sample Editor
+	edits, not on the Event Dispatcher thread. Plug-ins are created by JUCE on
+	the main thread too. */
+
+	m::pitchCache::update();
+#ifdef WITH_VST
+	m::pluginLoader::update();
+#endif
 	u::gui::refresh();
 	Fl::add_timeout(G_GUI_REFRESH_RATE, update, nullptr);
 }
@@ -24,16 +24,32 @@
  *
  * -------------------------------------------------------------------------- */
 
+#include "core/const.h"
 #include "core/init.h"
 #include "gui/dialogs/mainWindow.h"
 #include <FL/Fl.H>
+#include <cstring>
+#ifdef WITH_VST
+#include "core/plugins/pluginScanner.h"
+#endif
 #ifdef WITH_TESTS
 #define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "tests/midiReceiver.cpp"
+#include "tests/midiStream.cpp"
+#include "tests/delayLine.cpp"
+#include "tests/midiClockFilter.cpp"
+#include "tests/midiLights.cpp"
+#include "tests/mpmcQueue.cpp"
+#include "tests/pieceTable.cpp"
 #include "tests/recorder.cpp"
+#include "tests/rtCheck.cpp"
+#include "tests/resampler.cpp"
 #include "tests/utils.cpp"
 #include "tests/wave.cpp"
 #include "tests/waveFx.cpp"
 #include "tests/waveManager.cpp"
+#include "tests/waveReader.cpp"
 #include <catch2/catch.hpp>
 #include <string>
 #include <vector>
@@ -49,6 +65,14 @@ int main(int argc, char** argv)
 		return Catch::Session().run(args.size() - 1, &args[1]);
 #endif
 
+#ifdef WITH_VST
+	/* Plug-in scan helper mode: probe a single plug-in file and quit. See
+	pluginScanner. */
+
+	if (argc == 5 && strcmp(argv[1], G_PLUGIN_SCAN_ARG) == 0)
+		return giada::m::pluginScanner::runHelper(argv[2], argv[3], argv[4]);
+#endif
+
 	giada::m::init::startup(argc, argv);
 
 	Fl::lock(); // Enable multithreading in FLTK
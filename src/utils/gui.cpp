@@ -100,6 +100,10 @@ void refresh()
 
 	refreshSubWindow(WID_SAMPLE_EDITOR);
 	refreshSubWindow(WID_ACTION_EDITOR);
+
+	/* Refresh plug-in CPU meters. */
+
+	refreshSubWindow(WID_FX_LIST);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -27,33 +27,177 @@
  * -------------------------------------------------------------------------- */
 
 #include "log.h"
+#include "core/mpmcQueue.h"
+#include "core/worker.h"
+#include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <vector>
 
 namespace giada::u::log
 {
+namespace
+{
+/* Message_
+A formatted message waiting to be written. */
+
+struct Message_
+{
+	char text[G_LOG_MESSAGE_SIZE];
+};
+
+/* Filter_
+Max level for messages of a subsystem. */
+
+struct Filter_
+{
+	std::string subsystem;
+	Level       level;
+};
+
+m::MpmcQueue<Message_, G_LOG_QUEUE_SIZE> queue_;
+Worker                                   writer_;
+
+/* filters_, defaultLevel_
+Set at startup, read-only afterwards. */
+
+std::vector<Filter_> filters_;
+#ifdef G_DEBUG_MODE
+Level defaultLevel_ = Level::DBG;
+#else
+Level defaultLevel_ = Level::INFO;
+#endif
+
+/* mode_, f_, stat_
+Output settings. 'mode_' is read by any thread calling print(), the others are
+owned by the writer thread once started. */
+
+std::atomic<int> mode_ = LOG_MODE_STDOUT;
+FILE*            f_    = nullptr;
+bool             stat_ = false;
+
+/* -------------------------------------------------------------------------- */
+
+FILE* getOutput_()
+{
+	return mode_.load() == LOG_MODE_FILE && stat_ ? f_ : stdout;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* write_
+Writes all pending messages. Called periodically by the writer thread. */
+
+void write_()
+{
+	FILE* out = getOutput_();
+
+	if (const std::size_t dropped = queue_.takeDropped(); dropped > 0)
+		std::fprintf(out, "[log] queue full, %zu messages dropped\n", dropped);
+
+	if (queue_.popAll([out](const Message_& m) { std::fputs(m.text, out); }) > 0)
+		std::fflush(out);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int init(int m)
 {
-	mode = m;
-	stat = true;
-	if (mode == LOG_MODE_FILE)
+	mode_.store(m);
+	stat_ = true;
+	if (m == LOG_MODE_FILE)
 	{
 		std::string fpath = fs::getHomePath() + G_SLASH + "giada.log";
-		f                 = std::fopen(fpath.c_str(), "a");
-		if (!f)
-		{
-			stat = false;
-			return 0;
-		}
+		f_                = std::fopen(fpath.c_str(), "a");
+		if (!f_)
+			stat_ = false;
 	}
-	return 1;
+	writer_.stop();
+	writer_.start(write_, /*sleep=*/G_LOG_RATE_MS);
+	return stat_ ? 1 : 0;
 }
 
 /* -------------------------------------------------------------------------- */
 
 void close()
 {
-	if (mode == LOG_MODE_FILE)
-		std::fclose(f);
+	writer_.stop();
+	write_();
+	if (mode_.load() == LOG_MODE_FILE && stat_)
+		std::fclose(f_);
+	f_    = nullptr;
+	stat_ = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setLevel(const std::string& subsystem, Level l)
+{
+	if (subsystem.empty())
+	{
+		defaultLevel_ = l;
+		return;
+	}
+	for (Filter_& f : filters_)
+		if (f.subsystem == subsystem)
+		{
+			f.level = l;
+			return;
+		}
+	filters_.push_back({subsystem, l});
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool setLevel(const std::string& subsystem, const std::string& level)
+{
+	if (level == "error")
+		setLevel(subsystem, Level::ERR);
+	else if (level == "warning")
+		setLevel(subsystem, Level::WARN);
+	else if (level == "info")
+		setLevel(subsystem, Level::INFO);
+	else if (level == "debug")
+		setLevel(subsystem, Level::DBG);
+	else
+		return false;
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool isEnabled(const char* format, Level l)
+{
+	if (mode_.load() == LOG_MODE_MUTE)
+		return false;
+
+	/* The longest matching subsystem wins, e.g. "pluginHost::logStats" over
+	"pluginHost". */
+
+	Level       max    = defaultLevel_;
+	std::size_t maxLen = 0;
+	if (format[0] == '[')
+		for (const Filter_& f : filters_)
+			if (f.subsystem.size() > maxLen && std::strncmp(format + 1, f.subsystem.c_str(), f.subsystem.size()) == 0)
+			{
+				max    = f.level;
+				maxLen = f.subsystem.size();
+			}
+
+	return l <= max;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void push(const char* text)
+{
+	Message_ m;
+	std::strncpy(m.text, text, G_LOG_MESSAGE_SIZE - 1);
+	m.text[G_LOG_MESSAGE_SIZE - 1] = '\0';
+	queue_.push(m);
 }
 } // namespace giada::u::log
@@ -38,18 +38,55 @@
 
 namespace giada::u::log
 {
-inline FILE* f;
-inline int   mode;
-inline bool  stat;
+/* Level
+Severity of a message. Messages above the level set for their subsystem are
+discarded, see setLevel(). Names are abbreviated on purpose: ERROR is a macro
+in Windows headers (wingdi.h). */
+
+enum class Level
+{
+	ERR = 0,
+	WARN,
+	INFO,
+	DBG
+};
 
 /* init
 Initializes logger. Mode defines where to write the output: LOG_MODE_STDOUT,
-LOG_MODE_FILE and LOG_MODE_MUTE. */
+LOG_MODE_FILE and LOG_MODE_MUTE. Starts the writer thread. */
 
 int init(int mode);
 
+/* close
+Writes pending messages, stops the writer thread and closes the log file. */
+
 void close();
 
+/* setLevel
+Sets the max level for 'subsystem', i.e. for messages whose format string starts
+with "[subsystem" (e.g. "KM" for "[KM] ..."). An empty subsystem sets the 
+default level. Not thread safe: call it at startup. */
+
+void setLevel(const std::string& subsystem, Level l);
+
+/* setLevel (2)
+Same as above, with level given by name: "error", "warning", "info" or "debug".
+Returns false if the name is unknown. */
+
+bool setLevel(const std::string& subsystem, const std::string& level);
+
+/* isEnabled
+Tells whether a message with format 'format' and level 'l' will be logged. */
+
+bool isEnabled(const char* format, Level l);
+
+/* push
+Queues an already formatted message for the writer thread. Lock-free: if the 
+queue is full the message is dropped, and the writer thread reports how many 
+were lost. */
+
+void push(const char* text);
+
 /* string_to_c_str
 Internal utility function for string transformation. Uses forwarding references
 (&&) to avoid useless string copy. */
@@ -70,24 +107,29 @@ static constexpr auto string_to_c_str = [](auto&& s) {
 
 /* print
 A variadic printf-like logging function. Any `std::string` argument will be 
-automatically transformed into a C-string. */
+automatically transformed into a C-string. The message is formatted on the 
+stack and written later by the writer thread, so it's safe to call from any 
+thread. Messages longer than G_LOG_MESSAGE_SIZE are truncated, keeping the 
+trailing newline. */
 
 template <typename... Args>
-static void print(const char* format, Args&&... args)
+static void print(Level l, const char* format, Args&&... args)
 {
-	if (mode == LOG_MODE_MUTE)
+	if (!isEnabled(format, l))
 		return;
 
-	if (mode == LOG_MODE_FILE && stat == true)
-	{
-		// Replace any std::string in the arguments by its C-string
-		std::fprintf(f, format, string_to_c_str(std::forward<Args>(args))...);
-#ifdef _WIN32
-		fflush(f);
-#endif
-	}
-	else
-		std::printf(format, string_to_c_str(std::forward<Args>(args))...);
+	char text[G_LOG_MESSAGE_SIZE];
+	// Replace any std::string in the arguments by its C-string
+	const int len = std::snprintf(text, sizeof(text), format, string_to_c_str(std::forward<Args>(args))...);
+	if (len >= static_cast<int>(sizeof(text)))
+		text[sizeof(text) - 2] = '\n';
+	push(text);
+}
+
+template <typename... Args>
+static void print(const char* format, Args&&... args)
+{
+	print(Level::INFO, format, std::forward<Args>(args)...);
 }
 } // namespace giada::u::log
 
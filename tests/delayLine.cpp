@@ -0,0 +1,121 @@
+#include "../src/core/delayLine.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("DelayLine")
+{
+	using namespace giada::m;
+
+	static const int MAX_DELAY = 16;
+	static const int FRAMES    = 8;
+	static const int CHANNELS  = 2;
+
+	DelayLine        delayLine(MAX_DELAY, CHANNELS);
+	mcl::AudioBuffer buffer(FRAMES, CHANNELS);
+
+	/* fill_
+	Fills the buffer with a ramp starting from 'start', different on each 
+	channel. */
+
+	auto fill_ = [&buffer](int start) {
+		for (int i = 0; i < FRAMES; i++)
+			for (int j = 0; j < CHANNELS; j++)
+				buffer[i][j] = static_cast<float>((start + i + 1) * (j + 1));
+	};
+
+	SECTION("Test zero delay")
+	{
+		fill_(0);
+		delayLine.process(buffer, 0);
+
+		for (int i = 0; i < FRAMES; i++)
+			REQUIRE(buffer[i][0] == static_cast<float>(i + 1));
+	}
+
+	SECTION("Test delay across blocks")
+	{
+		static const int DELAY = 3;
+
+		fill_(0);
+		delayLine.process(buffer, DELAY);
+
+		for (int i = 0; i < DELAY; i++)
+			REQUIRE(buffer[i][0] == 0.0f);
+		for (int i = DELAY; i < FRAMES; i++)
+		{
+			REQUIRE(buffer[i][0] == static_cast<float>(i - DELAY + 1));
+			REQUIRE(buffer[i][1] == static_cast<float>((i - DELAY + 1) * 2));
+		}
+
+		fill_(FRAMES);
+		delayLine.process(buffer, DELAY);
+
+		for (int i = 0; i < FRAMES; i++)
+			REQUIRE(buffer[i][0] == static_cast<float>(FRAMES + i - DELAY + 1));
+	}
+
+	SECTION("Test delay longer than a block")
+	{
+		static const int DELAY = FRAMES + 2;
+
+		fill_(0);
+		delayLine.process(buffer, DELAY);
+		for (int i = 0; i < FRAMES; i++)
+			REQUIRE(buffer[i][0] == 0.0f);
+
+		fill_(FRAMES);
+		delayLine.process(buffer, DELAY);
+		REQUIRE(buffer[0][0] == 0.0f);
+		REQUIRE(buffer[1][0] == 0.0f);
+		REQUIRE(buffer[2][0] == 1.0f);
+	}
+
+	SECTION("Test longer delay keeps pending audio")
+	{
+		fill_(0);
+		delayLine.process(buffer, 2);
+		fill_(FRAMES);
+		delayLine.process(buffer, 4);
+
+		/* Two frames of silence, then the two frames still pending from the
+		first block, then the new block. */
+
+		REQUIRE(buffer[0][0] == 0.0f);
+		REQUIRE(buffer[1][0] == 0.0f);
+		REQUIRE(buffer[2][0] == 7.0f);
+		REQUIRE(buffer[3][0] == 8.0f);
+		for (int i = 4; i < FRAMES; i++)
+			REQUIRE(buffer[i][0] == static_cast<float>(FRAMES + i - 4 + 1));
+	}
+
+	SECTION("Test shorter delay skips frames")
+	{
+		fill_(0);
+		delayLine.process(buffer, 4);
+		fill_(FRAMES);
+		delayLine.process(buffer, 2);
+
+		REQUIRE(buffer[0][0] == 7.0f);
+		REQUIRE(buffer[1][0] == 8.0f);
+		for (int i = 2; i < FRAMES; i++)
+			REQUIRE(buffer[i][0] == static_cast<float>(FRAMES + i - 2 + 1));
+	}
+
+	SECTION("Test delay from zero plays silence first")
+	{
+		fill_(0);
+		delayLine.process(buffer, 4);
+		fill_(FRAMES);
+		delayLine.process(buffer, 0);
+		fill_(2 * FRAMES);
+		delayLine.process(buffer, 2);
+
+		REQUIRE(buffer[0][0] == 0.0f);
+		REQUIRE(buffer[1][0] == 0.0f);
+		REQUIRE(buffer[2][0] == static_cast<float>(2 * FRAMES + 1));
+	}
+
+	SECTION("Test max delay")
+	{
+		REQUIRE(delayLine.getMaxDelay() == MAX_DELAY);
+	}
+}
@@ -0,0 +1,87 @@
+#include "../src/core/midiClockFilter.h"
+#include "../src/core/const.h"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+
+TEST_CASE("MidiClockFilter")
+{
+	using namespace giada::m;
+
+	static const double JITTER = 0.001; // +/- 1 ms, typical of USB MIDI
+	static const int    BEATS  = 32;
+
+	MidiClockFilter filter(G_MIDI_SYNC_BANDWIDTH);
+	std::mt19937    rng(1234); // Fixed seed, repeatable streams
+
+	double time = 10.0;
+	double t    = 0.0; // Ideal time of the next tick, without jitter
+
+	/* feed_
+	Feeds a jittery clock stream at 'bpm' for 'beats' beats. Returns the number
+	of ticks needed to lock (-1 if never locked) and the worst tempo estimate 
+	error over the last 8 beats. */
+
+	auto feed_ = [&](double bpm, int beats, int& lockTicks, double& maxError) {
+		std::uniform_real_distribution<double> jitter(-JITTER, JITTER);
+
+		const int    ticks  = beats * G_MIDI_CLOCK_PPQN;
+		const double period = 60.0 / (bpm * G_MIDI_CLOCK_PPQN);
+
+		lockTicks = -1;
+		maxError  = 0.0;
+		for (int i = 0; i < ticks; i++)
+		{
+			filter.tick(time + t + jitter(rng));
+			t += period;
+			if (lockTicks == -1 && filter.isLocked())
+				lockTicks = i + 1;
+			if (i >= ticks - 8 * G_MIDI_CLOCK_PPQN)
+				maxError = std::max(maxError, std::abs(filter.getBpm() - bpm));
+		}
+	};
+
+	int    lockTicks;
+	double maxError;
+
+	SECTION("Test lock on a jittery stream")
+	{
+		feed_(120.0, BEATS, lockTicks, maxError);
+
+		REQUIRE(lockTicks != -1);
+		REQUIRE(lockTicks <= 4 * G_MIDI_CLOCK_PPQN);
+		REQUIRE(maxError < 0.25);
+	}
+
+	SECTION("Test tempo change")
+	{
+		feed_(120.0, BEATS, lockTicks, maxError);
+		feed_(130.0, BEATS, lockTicks, maxError);
+
+		REQUIRE(filter.isLocked());
+		REQUIRE(maxError < 0.25);
+	}
+
+	SECTION("Test restart after a gap")
+	{
+		feed_(120.0, BEATS, lockTicks, maxError);
+		t += 2.0; // Master stopped for a while
+		filter.tick(time + t);
+
+		REQUIRE_FALSE(filter.isLocked());
+
+		feed_(90.0, BEATS, lockTicks, maxError);
+
+		REQUIRE(lockTicks != -1);
+		REQUIRE(maxError < 0.25);
+	}
+
+	SECTION("Test reset")
+	{
+		feed_(120.0, BEATS, lockTicks, maxError);
+		filter.reset();
+
+		REQUIRE_FALSE(filter.isLocked());
+		REQUIRE(filter.getBpm() == 0.0);
+	}
+}
@@ -0,0 +1,89 @@
+#include "../src/core/midiLights.h"
+#include "../src/core/kernelMidi.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+TEST_CASE("MidiLights")
+{
+	using namespace giada::m;
+
+	const uint32_t NOTE_ON  = kernelMidi::getIValue(0x90, 0x24, 0x7F);
+	const uint32_t NOTE_OFF = kernelMidi::getIValue(0x80, 0x24, 0x00);
+
+	MidiLights            lights;
+	std::vector<uint32_t> out;
+
+	SECTION("Test dedupe")
+	{
+		lights.set(NOTE_ON);
+		lights.set(NOTE_ON);
+		lights.collect(out, 16);
+
+		REQUIRE(out == std::vector<uint32_t>{NOTE_ON});
+
+		out.clear();
+		lights.set(NOTE_ON);
+		lights.collect(out, 16);
+
+		REQUIRE(out.empty());
+	}
+
+	SECTION("Test last request wins")
+	{
+		lights.set(NOTE_ON);
+		lights.set(NOTE_OFF);
+		lights.collect(out, 16);
+
+		REQUIRE(out == std::vector<uint32_t>{NOTE_OFF});
+	}
+
+	SECTION("Test on-off-on with different status bytes")
+	{
+		for (uint32_t msg : {NOTE_ON, NOTE_OFF, NOTE_ON})
+		{
+			lights.set(msg);
+			lights.collect(out, 16);
+		}
+
+		REQUIRE(out == std::vector<uint32_t>{NOTE_ON, NOTE_OFF, NOTE_ON});
+	}
+
+	SECTION("Test channels and notes are separate controllers")
+	{
+		lights.set(NOTE_ON);
+		lights.set(kernelMidi::getIValue(0x91, 0x24, 0x7F));
+		lights.set(kernelMidi::getIValue(0x90, 0x25, 0x7F));
+		lights.collect(out, 16);
+
+		REQUIRE(out.size() == 3);
+	}
+
+	SECTION("Test budget")
+	{
+		for (int note = 0; note < 10; note++)
+			lights.set(kernelMidi::getIValue(0x90, note, 0x7F));
+
+		lights.collect(out, 4);
+		REQUIRE(out.size() == 4);
+
+		lights.collect(out, 0);
+		REQUIRE(out.size() == 4);
+
+		lights.collect(out, 16);
+		REQUIRE(out.size() == 10);
+
+		std::sort(out.begin(), out.end());
+		REQUIRE(std::adjacent_find(out.begin(), out.end()) == out.end());
+	}
+
+	SECTION("Test clear")
+	{
+		lights.set(NOTE_ON);
+		lights.collect(out, 16);
+		lights.clear();
+		lights.set(NOTE_ON);
+		lights.collect(out, 16);
+
+		REQUIRE(out == std::vector<uint32_t>{NOTE_ON, NOTE_ON});
+	}
+}
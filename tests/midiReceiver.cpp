@@ -0,0 +1,68 @@
+#ifdef WITH_VST
+
+#include "../src/core/channels/midiReceiver.h"
+#include "../src/core/channels/channel.h"
+#include "../src/core/const.h"
+#include "../src/core/midiEvent.h"
+#include "../src/core/rtCheck.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("midiReceiver")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int BUFFERSIZE = 256;
+	static const int EVENTS     = 16;
+
+	channel::State  state;
+	channel::Buffer buffer(BUFFERSIZE);
+	channel::Data   ch(ChannelType::MIDI, /*id=*/1, /*columnId=*/0, state, buffer);
+
+	for (int i = 0; i < EVENTS; i++)
+		buffer.midiQueue.push(MidiEvent(MidiEvent::NOTE_ON, 60 + i, 127, /*delta=*/i));
+
+	SECTION("Test queued events reach the plug-in buffer")
+	{
+		midiReceiver::fillBuffer(ch);
+
+		REQUIRE(buffer.midi.getNumEvents() == EVENTS);
+
+		int i = 0;
+		for (const juce::MidiMessageMetadata m : buffer.midi)
+		{
+			const juce::MidiMessage msg = m.getMessage();
+			REQUIRE(msg.isNoteOn());
+			REQUIRE(msg.getNoteNumber() == 60 + i);
+			REQUIRE(m.samplePosition == i);
+			i++;
+		}
+	}
+
+#ifdef WITH_RT_CHECK
+
+	/* Allocations are detected by the real-time safety checker: a 
+	rtCheck::Scope wraps the audio thread path, just like the audio callback 
+	does. */
+
+	SECTION("Test allocation-free rendering")
+	{
+		const unsigned violations = rtCheck::countViolations();
+		{
+			rtCheck::Scope scope;
+			midiReceiver::render(ch);
+		}
+
+		REQUIRE(rtCheck::countViolations() == violations);
+		REQUIRE(buffer.midi.isEmpty());
+	}
+
+#endif // WITH_RT_CHECK
+
+	SECTION("Test MIDI buffer preallocation")
+	{
+		REQUIRE(buffer.midi.data.getNumAllocated() >= G_DEFAULT_VST_MIDIBUFFER_SIZE);
+	}
+}
+
+#endif // WITH_VST
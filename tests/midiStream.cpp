@@ -0,0 +1,127 @@
+#include "../src/core/midiStream.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("MidiStream")
+{
+	using namespace giada::m;
+
+	static const int CAPACITY = 8;
+	static const int CC       = 0xB0;
+
+	MidiStream stream(CAPACITY);
+
+	SECTION("Test push")
+	{
+		for (int i = 0; i < CAPACITY; i++)
+			REQUIRE(stream.push(MidiEvent(MidiEvent::NOTE_ON, 60 + i, 127, i)));
+
+		REQUIRE(stream.size() == CAPACITY);
+		REQUIRE(stream.begin()->getNote() == 60);
+	}
+
+	SECTION("Test drop when full")
+	{
+		for (int i = 0; i < CAPACITY; i++)
+			stream.push(MidiEvent(MidiEvent::NOTE_ON, 60 + i, 127, i));
+
+		REQUIRE_FALSE(stream.push(MidiEvent(MidiEvent::NOTE_ON, 80, 127, 0)));
+		REQUIRE(stream.size() == CAPACITY);
+
+		MidiStream::Stats s = stream.takeStats();
+		REQUIRE(s.dropped == 1);
+		REQUIRE(s.coalesced == 0);
+		REQUIRE(stream.takeStats().dropped == 0);
+	}
+
+	SECTION("Test CC coalescing before dropping notes")
+	{
+		/* Half notes, half CC sweep on controller 1. */
+
+		for (int i = 0; i < CAPACITY / 2; i++)
+			stream.push(MidiEvent(MidiEvent::NOTE_ON, 60 + i, 127, i));
+		for (int i = 0; i < CAPACITY / 2; i++)
+			stream.push(MidiEvent(CC, 1, i, i));
+
+		REQUIRE(stream.push(MidiEvent(MidiEvent::NOTE_ON, 80, 127, 0)));
+
+		/* All notes survive, the sweep collapses into its last value. */
+
+		int notes = 0;
+		int ccs   = 0;
+		for (const MidiEvent& e : stream)
+		{
+			if (e.getStatus() == MidiEvent::NOTE_ON)
+				notes++;
+			else
+			{
+				ccs++;
+				REQUIRE(e.getVelocity() == CAPACITY / 2 - 1);
+			}
+		}
+		REQUIRE(notes == CAPACITY / 2 + 1);
+		REQUIRE(ccs == 1);
+
+		MidiStream::Stats s = stream.takeStats();
+		REQUIRE(s.dropped == 0);
+		REQUIRE(s.coalesced == CAPACITY / 2 - 1);
+	}
+
+	SECTION("Test different controllers are kept")
+	{
+		for (int i = 0; i < CAPACITY; i++)
+			stream.push(MidiEvent(CC, i, 64, 0));
+
+		REQUIRE_FALSE(stream.push(MidiEvent(CC, 0, 0, 0)));
+		REQUIRE(stream.takeStats().coalesced == 0);
+	}
+
+	SECTION("Test coalescing keeps order")
+	{
+		/* Two interleaved sweeps on controllers 1 and 2, plus two notes. */
+
+		for (int i = 0; i < 3; i++)
+		{
+			stream.push(MidiEvent(CC, 1, i, i));
+			stream.push(MidiEvent(CC, 2, i, i));
+		}
+		stream.push(MidiEvent(MidiEvent::NOTE_ON, 60, 127, 6));
+		stream.push(MidiEvent(MidiEvent::NOTE_ON, 61, 127, 7));
+
+		REQUIRE(stream.push(MidiEvent(MidiEvent::NOTE_ON, 62, 127, 7)));
+		REQUIRE(stream.size() == 5);
+
+		std::vector<MidiEvent> events(stream.begin(), stream.end());
+		REQUIRE(events[0].getNote() == 1);
+		REQUIRE(events[0].getVelocity() == 2);
+		REQUIRE(events[1].getNote() == 2);
+		REQUIRE(events[1].getVelocity() == 2);
+		REQUIRE(events[2].getNote() == 60);
+		REQUIRE(events[3].getNote() == 61);
+		REQUIRE(events[4].getNote() == 62);
+		REQUIRE(stream.takeStats().coalesced == 4);
+	}
+
+	SECTION("Test coalescing after clear")
+	{
+		for (int i = 0; i < CAPACITY; i++)
+			stream.push(MidiEvent(CC, i, 64, 0));
+		REQUIRE_FALSE(stream.push(MidiEvent(CC, 0, 0, 0)));
+
+		stream.clear();
+
+		for (int i = 0; i < CAPACITY; i++)
+			stream.push(MidiEvent(CC, 0, i, i));
+		REQUIRE(stream.push(MidiEvent(CC, 0, 0, 0)));
+		REQUIRE(stream.size() == 2);
+	}
+
+	SECTION("Test clear")
+	{
+		stream.push(MidiEvent(MidiEvent::NOTE_ON, 60, 127, 0));
+		stream.clear();
+
+		REQUIRE(stream.size() == 0);
+		REQUIRE(stream.getCapacity() == CAPACITY);
+	}
+}
@@ -0,0 +1,92 @@
+#include "../src/core/mpmcQueue.h"
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MpmcQueue")
+{
+	using namespace giada::m;
+
+	static const int SIZE = 64;
+
+	MpmcQueue<int, SIZE> queue;
+
+	SECTION("Test push and pop")
+	{
+		int item;
+
+		REQUIRE_FALSE(queue.pop(item));
+		REQUIRE(queue.push(1));
+		REQUIRE(queue.push(2));
+		REQUIRE(queue.pop(item));
+		REQUIRE(item == 1);
+		REQUIRE(queue.pop(item));
+		REQUIRE(item == 2);
+		REQUIRE_FALSE(queue.pop(item));
+	}
+
+	SECTION("Test full queue")
+	{
+		for (int i = 0; i < SIZE; i++)
+			REQUIRE(queue.push(i));
+
+		REQUIRE_FALSE(queue.push(SIZE));
+		REQUIRE_FALSE(queue.push(SIZE));
+		REQUIRE(queue.takeDropped() == 2);
+		REQUIRE(queue.takeDropped() == 0);
+
+		int item;
+		REQUIRE(queue.pop(item));
+		REQUIRE(queue.push(SIZE));
+	}
+
+	SECTION("Test batch pop")
+	{
+		for (int i = 0; i < 10; i++)
+			queue.push(i);
+
+		int sum = 0;
+		REQUIRE(queue.popAll([&sum](int i) { sum += i; }, /*max=*/5) == 5);
+		REQUIRE(sum == 0 + 1 + 2 + 3 + 4);
+		REQUIRE(queue.popAll([&sum](int i) { sum += i; }) == 5);
+		REQUIRE(sum == 45);
+	}
+
+	SECTION("Test multiple producers")
+	{
+		static const int PRODUCERS = 4;
+		static const int ITEMS     = 10000; // Per producer
+
+		std::vector<std::thread> producers;
+		for (int p = 0; p < PRODUCERS; p++)
+			producers.emplace_back([&queue, p]() {
+				for (int i = 0; i < ITEMS; i++)
+					while (!queue.push(p * ITEMS + i))
+						std::this_thread::yield();
+			});
+
+		/* Each item must come out exactly once, and items from the same producer
+		in order. */
+
+		std::vector<int> last(PRODUCERS, -1);
+		std::vector<int> counts(PRODUCERS, 0);
+		bool             ordered = true;
+		int              popped  = 0;
+		while (popped < PRODUCERS * ITEMS)
+		{
+			popped += queue.popAll([&](int item) {
+				const int p = item / ITEMS;
+				ordered     = ordered && item % ITEMS > last[p];
+				last[p]     = item % ITEMS;
+				counts[p]++;
+			});
+		}
+
+		for (std::thread& t : producers)
+			t.join();
+
+		REQUIRE(ordered);
+		for (int c : counts)
+			REQUIRE(c == ITEMS);
+	}
+}
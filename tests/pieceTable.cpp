@@ -0,0 +1,148 @@
+#include "../src/core/pieceTable.h"
+#include "../src/core/types.h"
+#include "../src/core/wave.h"
+#include "../src/core/waveFx.h"
+#include <catch2/catch.hpp>
+
+using namespace giada;
+using namespace giada::m;
+
+TEST_CASE("PieceTable")
+{
+	static const int SAMPLE_RATE = 44100;
+	static const int BUFFER_SIZE = 4000;
+	static const int BIT_DEPTH   = 32;
+
+	Wave wave(0);
+	wave.alloc(BUFFER_SIZE, 2, SAMPLE_RATE, BIT_DEPTH, "path/to/sample.wav");
+
+	for (int i = 0; i < BUFFER_SIZE; i++)
+	{
+		wave.getBuffer()[i][0] = i / (float)BUFFER_SIZE;
+		wave.getBuffer()[i][1] = -i / (float)BUFFER_SIZE;
+	}
+
+	PieceTable table(wave.getBuffer());
+
+	/* Each edit is done both on the piece table and destructively on the wave
+	with wfx: rendered results must match. */
+
+	auto requireSameAsWave = [&wave](const PieceTable& t) {
+		mcl::AudioBuffer out = PieceTable::render(t.getPieces(), t.countChannels());
+
+		REQUIRE(out.countFrames() == wave.getBuffer().countFrames());
+		for (int i = 0; i < out.countFrames(); i++)
+			for (int j = 0; j < out.countChannels(); j++)
+				REQUIRE(out[i][j] == Approx(wave.getBuffer()[i][j]).margin(0.0001f));
+	};
+
+	SECTION("test init")
+	{
+		REQUIRE(table.countFrames() == BUFFER_SIZE);
+		REQUIRE(table.countChannels() == 2);
+		REQUIRE(table.canUndo() == false);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test cut")
+	{
+		table.cut(47, 210);
+		wfx::cut(wave, 47, 210);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test trim")
+	{
+		table.trim(47, 210);
+		wfx::trim(wave, 47, 210);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test silence")
+	{
+		table.silence(20, 57);
+		wfx::silence(wave, 20, 57);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test normalize")
+	{
+		table.normalize(0, 100);
+		wfx::normalize(wave, 0, 100);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test fade")
+	{
+		table.fade(47, 500, wfx::Fade::IN);
+		table.fade(300, 800, wfx::Fade::OUT);
+		wfx::fade(wave, 47, 500, wfx::Fade::IN);
+		wfx::fade(wave, 300, 800, wfx::Fade::OUT);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test reverse")
+	{
+		table.reverse(10, 211);
+		table.reverse(100, 500);
+		wfx::reverse(wave, 10, 211);
+		wfx::reverse(wave, 100, 500);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test fade on reversed range")
+	{
+		table.fade(100, 300, wfx::Fade::IN);
+		table.reverse(50, 250);
+		wfx::fade(wave, 100, 300, wfx::Fade::IN);
+		wfx::reverse(wave, 50, 250);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test shift")
+	{
+		table.shift(123);
+		wfx::shift(wave, 123);
+		requireSameAsWave(table);
+	}
+
+	SECTION("test copy/paste")
+	{
+		Wave clip(1);
+		clip.alloc(163, 2, SAMPLE_RATE, BIT_DEPTH, "");
+		for (int i = 0; i < 163; i++)
+			for (int j = 0; j < 2; j++)
+				clip.getBuffer()[i][j] = wave.getBuffer()[i + 47][j];
+
+		table.paste(table.copy(47, 210), 1000);
+		wfx::paste(clip, wave, 1000);
+
+		REQUIRE(table.countFrames() == BUFFER_SIZE + 163);
+		REQUIRE(wave.getBuffer().countFrames() == BUFFER_SIZE + 163);
+
+		mcl::AudioBuffer out = PieceTable::render(table.getPieces(), table.countChannels());
+		for (int i = 0; i < 163; i++)
+			REQUIRE(out[1000 + i][0] == clip.getBuffer()[i][0]);
+	}
+
+	SECTION("test undo/redo")
+	{
+		table.cut(47, 210);
+		table.silence(0, 10);
+
+		REQUIRE(table.canUndo());
+		REQUIRE(table.undo());
+		REQUIRE(table.undo());
+		REQUIRE(table.undo() == false);
+		requireSameAsWave(table);
+
+		REQUIRE(table.redo());
+		REQUIRE(table.countFrames() == BUFFER_SIZE - 163);
+		REQUIRE(table.canRedo());
+
+		/* A new edit drops the redo history. */
+
+		table.trim(0, 100);
+		REQUIRE(table.canRedo() == false);
+	}
+}
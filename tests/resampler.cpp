@@ -0,0 +1,155 @@
+#include "../src/core/resampler.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace giada::m;
+
+namespace
+{
+constexpr int   RSMP_CHANNELS    = 2;
+constexpr int   RSMP_SAMPLE_RATE = 44100;
+constexpr float RSMP_FREQUENCY   = 440.0f;
+
+std::vector<float> makeSine_(int frames)
+{
+	const float pi = std::acos(-1.0f);
+
+	std::vector<float> out(frames * RSMP_CHANNELS);
+	for (int i = 0; i < frames; i++)
+		for (int j = 0; j < RSMP_CHANNELS; j++)
+			out[(i * RSMP_CHANNELS) + j] = std::sin(2 * pi * RSMP_FREQUENCY * i / RSMP_SAMPLE_RATE);
+	return out;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("Resampler")
+{
+	static const int FRAMES = 4096;
+
+	const std::vector<float> input = makeSine_(FRAMES);
+
+	auto quality = GENERATE(
+	    Resampler::Quality::BUILTIN_LINEAR,
+	    Resampler::Quality::BUILTIN_HERMITE,
+	    Resampler::Quality::BUILTIN_FIR);
+
+	Resampler resampler(quality, RSMP_CHANNELS);
+
+	SECTION("test used/generated frames")
+	{
+		std::vector<float> output(FRAMES * 4 * RSMP_CHANNELS);
+
+		Resampler::Result res = resampler.process(const_cast<float*>(input.data()),
+		    0, FRAMES, output.data(), FRAMES * 4, 2.0f);
+
+		REQUIRE(res.used == FRAMES);
+		REQUIRE(res.generated == FRAMES / 2);
+	}
+
+	SECTION("test pitched sine")
+	{
+		/* A sine read at double speed is a sine at double frequency. Skip the 
+		first frames, where interpolators still use empty history. */
+
+		const float pi    = std::acos(-1.0f);
+		const float ratio = 2.0f;
+
+		std::vector<float> output(FRAMES * RSMP_CHANNELS);
+		Resampler::Result  res = resampler.process(const_cast<float*>(input.data()),
+		    0, FRAMES, output.data(), FRAMES, ratio);
+
+		for (int i = 4; i < res.generated - 4; i++)
+		{
+			float expected = std::sin(2 * pi * RSMP_FREQUENCY * i * ratio / RSMP_SAMPLE_RATE);
+			REQUIRE(output[i * RSMP_CHANNELS] == Approx(expected).margin(0.01f));
+			REQUIRE(output[(i * RSMP_CHANNELS) + 1] == Approx(expected).margin(0.01f));
+		}
+	}
+
+	SECTION("test state across chunks")
+	{
+		/* Processing in small chunks must yield the same output of a single
+		process() call. */
+
+		const float ratio = 0.73f;
+
+		Resampler          oneShot(quality, RSMP_CHANNELS);
+		std::vector<float> expected(FRAMES * 2 * RSMP_CHANNELS);
+		Resampler::Result  total = oneShot.process(const_cast<float*>(input.data()),
+		    0, FRAMES, expected.data(), FRAMES * 2, ratio);
+
+		std::vector<float> output(FRAMES * 2 * RSMP_CHANNELS);
+		long               used      = 0;
+		long               generated = 0;
+		while (generated < total.generated)
+		{
+			Resampler::Result res = resampler.process(const_cast<float*>(input.data()),
+			    used, FRAMES, output.data() + (generated * RSMP_CHANNELS), 64, ratio);
+			used += res.used;
+			generated += res.generated;
+		}
+
+		REQUIRE(generated == total.generated);
+		REQUIRE(used == total.used);
+		for (int i = 0; i < generated * RSMP_CHANNELS; i++)
+			REQUIRE(output[i] == Approx(expected[i]).margin(0.00001f));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Voices-per-core benchmark: how many pitched stereo voices a single core can
+resample in real time, for each quality. Run it with 
+'giada --run-tests [.benchmark]'. */
+
+TEST_CASE("Resampler voices-per-core benchmark", "[.benchmark]")
+{
+	static const int   BUFFER_SIZE = 512;
+	static const int   SECONDS     = 10;
+	static const int   FRAMES      = RSMP_SAMPLE_RATE * SECONDS;
+	static const float PITCH       = 1.33f;
+
+	const std::vector<float> input = makeSine_(FRAMES);
+	std::vector<float>       output(BUFFER_SIZE * RSMP_CHANNELS);
+
+	const std::vector<std::pair<Resampler::Quality, const char*>> qualities = {
+	    {Resampler::Quality::SINC_BEST, "Sinc best"},
+	    {Resampler::Quality::SINC_MEDIUM, "Sinc medium"},
+	    {Resampler::Quality::SINC_FASTEST, "Sinc fastest"},
+	    {Resampler::Quality::LINEAR, "libsamplerate linear"},
+	    {Resampler::Quality::BUILTIN_LINEAR, "Built-in linear"},
+	    {Resampler::Quality::BUILTIN_HERMITE, "Built-in Hermite"},
+	    {Resampler::Quality::BUILTIN_FIR, "Built-in FIR"}};
+
+	for (const auto& [quality, name] : qualities)
+	{
+		Resampler resampler(quality, RSMP_CHANNELS);
+
+		/* Render SECONDS of output audio, one buffer at a time, as the audio
+		thread would do. */
+
+		long rendered = 0;
+		long tracker  = 0;
+		auto start    = std::chrono::steady_clock::now();
+		while (rendered < FRAMES)
+		{
+			Resampler::Result res = resampler.process(const_cast<float*>(input.data()),
+			    tracker, FRAMES, output.data(), BUFFER_SIZE, PITCH);
+			tracker += res.used;
+			rendered += BUFFER_SIZE;
+			if (tracker >= FRAMES)
+			{
+				resampler.last();
+				tracker = 0;
+			}
+		}
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::printf("%-24s %10.1f voices per core\n", name, SECONDS / elapsed);
+	}
+}
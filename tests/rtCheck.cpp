@@ -0,0 +1,63 @@
+#ifdef WITH_RT_CHECK
+
+#include "../src/core/rtCheck.h"
+#include "../src/core/delayLine.h"
+#include "../src/core/midiStream.h"
+#include "../src/core/mpmcQueue.h"
+#include "../src/core/queue.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+/* No audio device here: real-time code paths are driven directly, within a 
+rtCheck::Scope just like the audio callback does. Catch's macros may allocate,
+so they stay out of scopes. */
+
+TEST_CASE("rtCheck")
+{
+	using namespace giada::m;
+
+	const unsigned violations = rtCheck::countViolations();
+
+	SECTION("Test violation detection")
+	{
+		std::vector<int> v;
+		{
+			rtCheck::Scope scope;
+			v.push_back(1);
+		}
+		REQUIRE(rtCheck::countViolations() > violations);
+	}
+
+	SECTION("Test no violations outside scopes")
+	{
+		std::vector<int> v(16);
+		v.push_back(1);
+
+		REQUIRE(rtCheck::countViolations() == violations);
+	}
+
+	SECTION("Test real-time safe containers")
+	{
+		Queue<int, 16>     queue;
+		MpmcQueue<int, 16> mpmcQueue;
+		MidiStream         stream(16);
+		DelayLine          delayLine(64, 2);
+		mcl::AudioBuffer   buffer(32, 2);
+		{
+			rtCheck::Scope scope;
+
+			int item;
+			queue.push(1);
+			queue.pop(item);
+			mpmcQueue.push(1);
+			mpmcQueue.popAll([](int) {});
+			for (int i = 0; i < 32; i++)
+				stream.push(MidiEvent(0xB0, 1, i, i));
+			stream.clear();
+			delayLine.process(buffer, 16);
+		}
+		REQUIRE(rtCheck::countViolations() == violations);
+	}
+}
+
+#endif // WITH_RT_CHECK
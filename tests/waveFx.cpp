@@ -1,9 +1,13 @@
 #include "../src/core/waveFx.h"
 #include "../src/core/const.h"
+#include "../src/core/dsp.h"
 #include "../src/core/types.h"
 #include "../src/core/wave.h"
 #include <catch2/catch.hpp>
+#include <cmath>
 #include <memory>
+#include <random>
+#include <vector>
 
 using namespace giada;
 using namespace giada::m;
@@ -20,6 +24,16 @@ TEST_CASE("waveFx")
 	waveMono.alloc(BUFFER_SIZE, 1, SAMPLE_RATE, BIT_DEPTH, "path/to/sample-mono.wav");
 	waveStereo.alloc(BUFFER_SIZE, 2, SAMPLE_RATE, BIT_DEPTH, "path/to/sample-stereo.wav");
 
+	/* Fill stereo wave with a ramp on the left channel and its negated copy on
+	the right one, so that frame and channel order can be checked. */
+
+	for (int i = 0; i < BUFFER_SIZE; i++)
+	{
+		waveMono.getBuffer()[i][0]   = i / (float)BUFFER_SIZE;
+		waveStereo.getBuffer()[i][0] = i / (float)BUFFER_SIZE;
+		waveStereo.getBuffer()[i][1] = -i / (float)BUFFER_SIZE;
+	}
+
 	SECTION("test mono->stereo conversion")
 	{
 		int prevSize = waveMono.getBuffer().countFrames();
@@ -28,6 +42,12 @@ TEST_CASE("waveFx")
 		REQUIRE(waveMono.getBuffer().countFrames() == prevSize); // size does not change, channels do
 		REQUIRE(waveMono.getBuffer().countChannels() == 2);
 
+		for (int i = 0; i < waveMono.getBuffer().countFrames(); i++)
+		{
+			REQUIRE(waveMono.getBuffer()[i][0] == i / (float)BUFFER_SIZE);
+			REQUIRE(waveMono.getBuffer()[i][1] == i / (float)BUFFER_SIZE);
+		}
+
 		SECTION("test mono->stereo conversion for already stereo wave")
 		{
 			/* Should do nothing. */
@@ -60,6 +80,9 @@ TEST_CASE("waveFx")
 		wfx::cut(waveStereo, a, b);
 
 		REQUIRE(waveStereo.getBuffer().countFrames() == prevSize - range);
+		REQUIRE(waveStereo.getBuffer()[a - 1][0] == (a - 1) / (float)BUFFER_SIZE);
+		REQUIRE(waveStereo.getBuffer()[a][0] == b / (float)BUFFER_SIZE);
+		REQUIRE(waveStereo.getBuffer()[a][1] == -b / (float)BUFFER_SIZE);
 	}
 
 	SECTION("test trim")
@@ -71,6 +94,37 @@ TEST_CASE("waveFx")
 		wfx::trim(waveStereo, a, b);
 
 		REQUIRE(waveStereo.getBuffer().countFrames() == area);
+		REQUIRE(waveStereo.getBuffer()[0][0] == a / (float)BUFFER_SIZE);
+		REQUIRE(waveStereo.getBuffer()[area - 1][1] == -(b - 1) / (float)BUFFER_SIZE);
+	}
+
+	SECTION("test normalize")
+	{
+		/* Peak lives in the right channel only: it must be taken into account
+		anyway. */
+
+		waveStereo.getBuffer()[10][1] = -0.5f;
+
+		wfx::normalize(waveStereo, 0, 20);
+
+		REQUIRE(waveStereo.getBuffer()[10][1] == Approx(-1.0f));
+		REQUIRE(waveStereo.getBuffer()[10][0] == Approx(20.0f / BUFFER_SIZE));
+	}
+
+	SECTION("test reverse")
+	{
+		int a = 10;
+		int b = 211;
+
+		wfx::reverse(waveStereo, a, b);
+
+		for (int i = a; i < b; i++)
+		{
+			REQUIRE(waveStereo.getBuffer()[i][0] == (b - 1 - i + a) / (float)BUFFER_SIZE);
+			REQUIRE(waveStereo.getBuffer()[i][1] == -(b - 1 - i + a) / (float)BUFFER_SIZE);
+		}
+		REQUIRE(waveStereo.getBuffer()[a - 1][0] == (a - 1) / (float)BUFFER_SIZE);
+		REQUIRE(waveStereo.getBuffer()[b][0] == b / (float)BUFFER_SIZE);
 	}
 
 	SECTION("test fade")
@@ -100,3 +154,153 @@ TEST_CASE("waveFx")
 		REQUIRE(waveStereo.getBuffer()[b][1] == 0.0f);
 	}
 }
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("dsp")
+{
+	/* Large enough to be processed in parallel, odd-sized to exercise the
+	scalar tail of SIMD loops. */
+
+	static const int FRAMES   = dsp::PARALLEL_THRESHOLD + 13;
+	static const int CHANNELS = 2;
+	static const int SIZE     = FRAMES * CHANNELS;
+
+	std::mt19937                          gen(1);
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+	std::vector<float> data(SIZE);
+	for (float& f : data)
+		f = dist(gen);
+	std::vector<float> ref = data;
+
+	SECTION("test getPeak")
+	{
+		data[SIZE - 1] = -1.5f;
+
+		float peak = 0.0f;
+		for (float f : data)
+			peak = std::max(peak, std::fabs(f));
+
+		REQUIRE(dsp::getPeak(data.data(), SIZE) == peak);
+	}
+
+	SECTION("test applyGain")
+	{
+		dsp::applyGain(data.data(), SIZE, 0.3f);
+		for (int i = 0; i < SIZE; i++)
+			REQUIRE(data[i] == ref[i] * 0.3f);
+	}
+
+	SECTION("test clamp")
+	{
+		dsp::applyGain(data.data(), SIZE, 2.0f);
+		dsp::clamp(data.data(), SIZE, -1.0f, 1.0f);
+		for (int i = 0; i < SIZE; i++)
+			REQUIRE(data[i] == std::max(-1.0f, std::min(ref[i] * 2.0f, 1.0f)));
+	}
+
+	SECTION("test fill")
+	{
+		dsp::fill(data.data(), SIZE, 0.0f);
+		for (int i = 0; i < SIZE; i++)
+			REQUIRE(data[i] == 0.0f);
+	}
+
+	SECTION("test applyRamp")
+	{
+		const float step = 1.0f / FRAMES;
+
+		dsp::applyRamp(data.data(), FRAMES, CHANNELS, 0.0f, step);
+		for (int i = 0; i < FRAMES; i++)
+			for (int j = 0; j < CHANNELS; j++)
+				REQUIRE(data[(i * CHANNELS) + j] == Approx(ref[(i * CHANNELS) + j] * (step * i)).margin(0.00001f));
+	}
+
+	SECTION("test reverse")
+	{
+		dsp::reverse(data.data(), FRAMES, CHANNELS);
+		for (int i = 0; i < FRAMES; i++)
+			for (int j = 0; j < CHANNELS; j++)
+				REQUIRE(data[(i * CHANNELS) + j] == ref[((FRAMES - 1 - i) * CHANNELS) + j]);
+	}
+
+	SECTION("test spread")
+	{
+		std::vector<float> mono(data.begin(), data.begin() + FRAMES);
+
+		dsp::spread(mono.data(), data.data(), FRAMES, CHANNELS);
+		for (int i = 0; i < FRAMES; i++)
+			for (int j = 0; j < CHANNELS; j++)
+				REQUIRE(data[(i * CHANNELS) + j] == mono[i]);
+	}
+
+	SECTION("test deinterleave/interleave")
+	{
+		std::vector<float> left(FRAMES), right(FRAMES);
+		float*             planar[CHANNELS] = {left.data(), right.data()};
+
+		dsp::deinterleave(data.data(), planar, FRAMES, CHANNELS);
+		for (int i = 0; i < FRAMES; i++)
+			for (int j = 0; j < CHANNELS; j++)
+				REQUIRE(planar[j][i] == ref[(i * CHANNELS) + j]);
+
+		std::fill(data.begin(), data.end(), 0.0f);
+
+		dsp::interleave(planar, data.data(), FRAMES, CHANNELS);
+		REQUIRE(data == ref);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Benchmarks are hidden: run them with 'giada --run-tests [.benchmark]'. */
+
+TEST_CASE("dsp benchmark", "[.benchmark]")
+{
+	static const int FRAMES   = 44100 * 60 * 5; // 5 minutes
+	static const int CHANNELS = 2;
+	static const int SIZE     = FRAMES * CHANNELS;
+
+	std::vector<float> data(SIZE, 0.5f);
+
+	BENCHMARK("scalar applyGain")
+	{
+		for (int i = 0; i < SIZE; i++)
+			data[i] *= 0.999f;
+		return data[0];
+	};
+
+	BENCHMARK("dsp::applyGain")
+	{
+		dsp::applyGain(data.data(), SIZE, 0.999f);
+		return data[0];
+	};
+
+	BENCHMARK("scalar getPeak")
+	{
+		float peak = 0.0f;
+		for (int i = 0; i < SIZE; i++)
+			peak = std::max(peak, std::fabs(data[i]));
+		return peak;
+	};
+
+	BENCHMARK("dsp::getPeak")
+	{
+		return dsp::getPeak(data.data(), SIZE);
+	};
+
+	BENCHMARK("scalar reverse")
+	{
+		for (int i = 0; i < FRAMES / 2; i++)
+			for (int j = 0; j < CHANNELS; j++)
+				std::swap(data[(i * CHANNELS) + j], data[((FRAMES - 1 - i) * CHANNELS) + j]);
+		return data[0];
+	};
+
+	BENCHMARK("dsp::reverse")
+	{
+		dsp::reverse(data.data(), FRAMES, CHANNELS);
+		return data[0];
+	};
+}
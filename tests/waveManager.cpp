@@ -1,9 +1,13 @@
 #include "../src/core/waveManager.h"
 #include "../src/core/const.h"
 #include "../src/core/wave.h"
+#include <algorithm>
 #include <catch2/catch.hpp>
+#include <cmath>
 #include <memory>
 #include <samplerate.h>
+#include <sndfile.h>
+#include <vector>
 
 using std::string;
 using namespace giada::m;
@@ -29,6 +33,74 @@ TEST_CASE("waveManager")
 		REQUIRE(res.wave->isEdited() == false);
 	}
 
+	SECTION("test creation with resampling")
+	{
+		waveManager::Result ref = waveManager::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE, /*quality=*/SRC_LINEAR);
+		waveManager::Result res = waveManager::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE * 2, /*quality=*/SRC_LINEAR);
+
+		REQUIRE(res.status == G_RES_OK);
+		REQUIRE(res.wave->getRate() == G_SAMPLE_RATE * 2);
+		REQUIRE(res.wave->getBuffer().countFrames() == ref.wave->getBuffer().countFrames() * 2);
+		REQUIRE(res.wave->getBuffer().countChannels() == G_CHANNELS);
+		REQUIRE(res.wave->isLogical() == false);
+		REQUIRE(res.wave->isEdited() == false);
+	}
+
+	SECTION("test streaming resampling against one-shot conversion")
+	{
+		/* test.wav is mono, so this goes through the mono to stereo conversion
+		as well. The reference is the whole file converted at once by 
+		src_simple(), as the loader did before streaming. */
+
+		static const int RATE = 48000;
+
+		SF_INFO  info = {};
+		SNDFILE* file = sf_open(TEST_RESOURCES_DIR "test.wav", SFM_READ, &info);
+
+		REQUIRE(file != nullptr);
+		REQUIRE(info.channels == 1);
+
+		std::vector<float> mono(info.frames);
+		sf_readf_float(file, mono.data(), info.frames);
+		sf_close(file);
+
+		std::vector<float> stereo(info.frames * G_CHANNELS);
+		for (sf_count_t i = 0; i < info.frames; i++)
+			stereo[i * G_CHANNELS] = stereo[i * G_CHANNELS + 1] = mono[i];
+
+		const double       ratio = RATE / static_cast<double>(info.samplerate);
+		const long         size  = static_cast<long>(std::ceil(info.frames * ratio));
+		std::vector<float> expected(size * G_CHANNELS);
+
+		SRC_DATA data      = {};
+		data.data_in       = stereo.data();
+		data.input_frames  = info.frames;
+		data.data_out      = expected.data();
+		data.output_frames = size;
+		data.src_ratio     = ratio;
+
+		REQUIRE(src_simple(&data, SRC_LINEAR, G_CHANNELS) == 0);
+
+		waveManager::Result res = waveManager::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/RATE, /*quality=*/SRC_LINEAR);
+
+		REQUIRE(res.status == G_RES_OK);
+
+		const mcl::AudioBuffer& buffer = res.wave->getBuffer();
+		const long              frames = std::min<long>(buffer.countFrames(), data.output_frames_gen);
+
+		REQUIRE(std::abs(buffer.countFrames() - data.output_frames_gen) <= 1);
+
+		float maxError = 0.0f;
+		for (long i = 0; i < frames; i++)
+			for (int j = 0; j < G_CHANNELS; j++)
+				maxError = std::max(maxError, std::abs(buffer[i][j] - expected[i * G_CHANNELS + j]));
+
+		REQUIRE(maxError < 0.0001f);
+	}
+
 	SECTION("test recording")
 	{
 		std::unique_ptr<Wave> wave = waveManager::createEmpty(G_BUFFER_SIZE,
@@ -0,0 +1,121 @@
+#include "../src/core/channels/waveReader.h"
+#include "../src/core/resampler.h"
+#include "../src/core/wave.h"
+#include "../src/core/waveManager.h"
+#include <catch2/catch.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace giada::m;
+
+TEST_CASE("WaveReader")
+{
+	static const int FRAMES     = 4096;
+	static const int CHANNELS   = 2;
+	static const int BUFFERSIZE = 256;
+
+	Wave wave(/*id=*/1);
+	wave.alloc(FRAMES, CHANNELS, 44100, 32, "test.wav");
+	for (int i = 0; i < FRAMES; i++)
+		for (int j = 0; j < CHANNELS; j++)
+			wave.getBuffer()[i][j] = i / static_cast<float>(FRAMES);
+
+	Resampler              resampler(Resampler::Quality::BUILTIN_LINEAR, CHANNELS);
+	WaveReader::CacheState cacheState;
+	WaveReader             reader(&resampler, &cacheState);
+	reader.wave = &wave;
+
+	mcl::AudioBuffer out(BUFFERSIZE, CHANNELS);
+
+	/* play
+	Reads the whole Wave at 'pitch' block by block, returning all generated
+	frames of the left channel. The callback runs before each block. */
+
+	auto play = [&](float pitch, std::function<void(int)> f = nullptr) {
+		std::vector<float> res;
+		int                tracker = 0;
+		for (int block = 0; tracker < FRAMES; block++)
+		{
+			if (f)
+				f(block);
+			out.clear();
+			WaveReader::Result r = reader.fill(out, tracker, FRAMES, 0, pitch);
+			REQUIRE(r.used >= 0);
+			tracker += r.used;
+			for (int i = 0; i < r.generated; i++)
+				res.push_back(out[i][0]);
+			if (r.generated == 0)
+				break;
+		}
+		REQUIRE(tracker == FRAMES);
+		return res;
+	};
+
+	SECTION("Test pitched render")
+	{
+		std::unique_ptr<Wave> cache = waveManager::createPitched(wave, 2.0f,
+		    static_cast<int>(Resampler::Quality::BUILTIN_LINEAR));
+
+		REQUIRE(cache->getBuffer().countFrames() == FRAMES / 2);
+		REQUIRE(cache->getBuffer().countChannels() == CHANNELS);
+		REQUIRE(cache->getRate() == wave.getRate());
+		REQUIRE(cache->isLogical());
+
+		for (int i = 0; i < FRAMES / 2; i++)
+			REQUIRE(cache->getBuffer()[i][0] == Approx(wave.getBuffer()[i * 2][0]));
+	}
+
+	SECTION("Test cached playback")
+	{
+		auto pitch = GENERATE(2.0f, 0.5f, 0.75f);
+
+		std::unique_ptr<Wave> cache = waveManager::createPitched(wave, pitch,
+		    static_cast<int>(Resampler::Quality::BUILTIN_LINEAR));
+
+		reader.cache      = cache.get();
+		reader.cachePitch = pitch;
+
+		/* Blocks must be seamless: the whole output is the cache itself. */
+
+		std::vector<float> res = play(pitch);
+
+		REQUIRE(res.size() <= static_cast<size_t>(cache->getBuffer().countFrames()));
+		REQUIRE(res.size() >= static_cast<size_t>(cache->getBuffer().countFrames() - 1));
+		for (size_t i = 0; i < res.size(); i++)
+			REQUIRE(res[i] == Approx(cache->getBuffer()[i][0]).margin(0.0001));
+	}
+
+	SECTION("Test cache ignored if pitch differs")
+	{
+		std::unique_ptr<Wave> cache = waveManager::createPitched(wave, 2.0f,
+		    static_cast<int>(Resampler::Quality::BUILTIN_LINEAR));
+
+		reader.cache      = cache.get();
+		reader.cachePitch = 2.0f;
+
+		std::vector<float> res = play(4.0f);
+
+		REQUIRE(res.size() == FRAMES / 4);
+		for (size_t i = 0; i < res.size(); i++)
+			REQUIRE(res[i] == Approx(wave.getBuffer()[i * 4][0]));
+	}
+
+	SECTION("Test switch between live and cached playback")
+	{
+		std::unique_ptr<Wave> cache = waveManager::createPitched(wave, 2.0f,
+		    static_cast<int>(Resampler::Quality::BUILTIN_LINEAR));
+
+		/* Cache comes in at block 3 and goes away at block 6: live and cached
+		audio line up, so crossfades must not alter the signal. */
+
+		std::vector<float> res = play(2.0f, [&](int block) {
+			reader.cache      = block >= 3 && block < 6 ? cache.get() : nullptr;
+			reader.cachePitch = 2.0f;
+		});
+
+		REQUIRE(res.size() == FRAMES / 2);
+		for (size_t i = 0; i < res.size(); i++)
+			REQUIRE(res[i] == Approx(wave.getBuffer()[i * 2][0]).margin(0.0001));
+	}
+}